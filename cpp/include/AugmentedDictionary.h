@@ -0,0 +1,209 @@
+// AugmentedDictionary.h - доповнені словники TON (HashmapAugE)
+// Author: Андрій Будильников (Sparky)
+// Dictionaries whose fork nodes carry an aggregate of their subtree
+// Дополненные словари TON (HashmapAugE)
+
+#ifndef CTON_AUGMENTED_DICTIONARY_H
+#define CTON_AUGMENTED_DICTIONARY_H
+
+#include "Dictionary.h"
+#include "UInt256.h"
+#include <vector>
+#include <stdexcept>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+// Export definitions for Windows DLL
+#ifdef _WIN32
+    #ifdef CTON_SDK_CORE_EXPORTS
+        #define CTON_SDK_CORE_API __declspec(dllexport)
+    #else
+        #define CTON_SDK_CORE_API __declspec(dllimport)
+    #endif
+#else
+    #define CTON_SDK_CORE_API
+#endif
+
+namespace cton {
+
+    /**
+     * @brief Агрегат - сума Grams (Coins), напр. сума комісій
+     */
+    struct CoinsAugmentation {
+        typedef UInt256 Extra;
+
+        static Extra zero() { return UInt256(); }
+        static Extra combine(const Extra& left, const Extra& right) { return left + right; }
+        static void store(CellBuilder& builder, const Extra& extra) { builder.storeCoins(extra); }
+        static Extra load(CellSlice& slice) { return slice.loadCoins(); }
+    };
+
+    /**
+     * @brief Адаптер типізованого агрегату до AugmentationOps
+     *
+     * Aug має визначати тип Extra і статичні zero, combine, store, load
+     */
+    template <typename Aug>
+    class AugmentationAdapter : public AugmentationOps {
+    public:
+        /**
+         * @brief Отримати спільний екземпляр (адаптер не має стану)
+         */
+        static const AugmentationAdapter& instance() {
+            static const AugmentationAdapter adapter;
+            return adapter;
+        }
+
+        void storeEmpty(CellBuilder& builder) const override {
+            Aug::store(builder, Aug::zero());
+        }
+
+        void combine(CellSlice& left, CellSlice& right, CellBuilder& builder) const override {
+            typename Aug::Extra leftExtra = Aug::load(left);
+            typename Aug::Extra rightExtra = Aug::load(right);
+            Aug::store(builder, Aug::combine(leftExtra, rightExtra));
+        }
+
+        void skip(CellSlice& slice) const override {
+            Aug::load(slice);
+        }
+    };
+
+    /**
+     * @brief Доповнений словник HashmapAugE n X Y
+     *
+     * Кожне розгалуження зберігає агрегат (Y) своїх гілок, тож підсумок усього
+     * словника читається з кореня. Зміни перераховують агрегати лише на
+     * зміненому шляху
+     * @tparam Aug опис агрегату (див. CoinsAugmentation)
+     */
+    template <typename Aug>
+    class AugmentedDictionary {
+    public:
+        typedef typename Aug::Extra Extra;
+
+        /**
+         * @brief Створити порожній словник
+         * @param keyBits довжина ключа в бітах
+         */
+        explicit AugmentedDictionary(size_t keyBits)
+            : dict_(keyBits, CellRef(), &AugmentationAdapter<Aug>::instance()) {}
+
+        /**
+         * @brief Побудувати словник з відсортованих ключів за один прохід
+         * @param keyBits довжина ключа в бітах
+         * @param keys ключі, упаковані по keyBytes() байтів, строго за зростанням
+         * @param extras extra листів
+         * @param values значення
+         * @param count кількість ключів
+         * @return словник
+         */
+        static AugmentedDictionary build(size_t keyBits, const uint8_t* keys, const Extra* extras,
+                                         const CellRef* values, size_t count) {
+            std::vector<CellRef> leaves;
+            leaves.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                leaves.push_back(makeLeafValue(extras[i], values[i]));
+            }
+            return AugmentedDictionary(Dictionary::build(keyBits, keys, leaves.data(), count,
+                                                         &AugmentationAdapter<Aug>::instance()));
+        }
+
+        /**
+         * @brief Прочитати HashmapAugE зі зрізу
+         * @param slice зріз
+         * @param keyBits довжина ключа в бітах
+         * @return словник
+         */
+        static AugmentedDictionary load(CellSlice& slice, size_t keyBits) {
+            return AugmentedDictionary(Dictionary::load(slice, keyBits, &AugmentationAdapter<Aug>::instance()));
+        }
+
+        /**
+         * @brief Записати HashmapAugE в будівельник
+         * @param builder будівельник
+         */
+        void store(CellBuilder& builder) const {
+            dict_.store(builder);
+        }
+
+        /**
+         * @brief Знайти запис за ключем
+         * @param key ключ (keyBytes() байтів)
+         * @param value зріз значення (після extra)
+         * @param extra extra листа
+         * @return true якщо ключ знайдено
+         */
+        bool get(const uint8_t* key, CellSlice& value, Extra& extra) const {
+            if (!dict_.get(key, value)) {
+                return false;
+            }
+            extra = Aug::load(value);
+            return true;
+        }
+
+        /**
+         * @brief Записати значення за ключем
+         * @param key ключ (keyBytes() байтів)
+         * @param extra extra листа
+         * @param value значення
+         */
+        void set(const uint8_t* key, const Extra& extra, const CellRef& value) {
+            dict_.set(key, makeLeafValue(extra, value));
+        }
+
+        /**
+         * @brief Видалити ключ
+         * @param key ключ (keyBytes() байтів)
+         * @return true якщо ключ був у словнику
+         */
+        bool erase(const uint8_t* key) {
+            return dict_.erase(key);
+        }
+
+        /**
+         * @brief Агрегат усього словника (extra кореня)
+         * @return extra
+         */
+        Extra total() const {
+            if (dict_.empty()) {
+                return Aug::zero();
+            }
+            CellRef root = dict_.getRoot();
+            CellSlice slice(*root);
+            Dictionary::skipToExtra(slice, dict_.getKeyBits());
+            return Aug::load(slice);
+        }
+
+        /**
+         * @brief Базовий словник (значення листів починаються з extra)
+         * @return словник для ітерації і пошуку
+         */
+        const Dictionary& dictionary() const {
+            return dict_;
+        }
+
+        size_t getKeyBits() const { return dict_.getKeyBits(); }
+        size_t keyBytes() const { return dict_.keyBytes(); }
+        bool empty() const { return dict_.empty(); }
+
+    private:
+        Dictionary dict_;
+
+        explicit AugmentedDictionary(Dictionary dict) : dict_(std::move(dict)) {}
+
+        static CellRef makeLeafValue(const Extra& extra, const CellRef& value) {
+            if (!value) {
+                throw std::invalid_argument("Dictionary value cannot be null");
+            }
+            CellBuilder builder;
+            Aug::store(builder, extra);
+            builder.storeSlice(CellSlice(*value));
+            return builder.build();
+        }
+    };
+
+}
+
+#endif // CTON_AUGMENTED_DICTIONARY_H
@@ -0,0 +1,188 @@
+// BitString.h - низькорівневі операції з бітовими рядками
+// Author: Андрій Будильников (Sparky)
+// Word-level helpers for big-endian bit strings
+// Низкоуровневые операции с битовыми строками
+
+#ifndef CTON_BIT_STRING_H
+#define CTON_BIT_STRING_H
+
+#include <cstdint>
+#include <cstddef>
+
+// Export definitions for Windows DLL
+#ifdef _WIN32
+    #ifdef CTON_SDK_CORE_EXPORTS
+        #define CTON_SDK_CORE_API __declspec(dllexport)
+    #else
+        #define CTON_SDK_CORE_API __declspec(dllimport)
+    #endif
+#else
+    #define CTON_SDK_CORE_API
+#endif
+
+namespace cton {
+
+    class UInt256;
+
+    /**
+     * @brief Операції з бітовими рядками, де біти йдуть від старшого біта першого байта
+     */
+    class CTON_SDK_CORE_API BitString {
+    public:
+        /**
+         * @brief Прочитати 64-бітне слово big-endian
+         * @param data вказівник на 8 байтів (вирівнювання не потрібне)
+         * @return слово
+         */
+        static inline uint64_t loadWord(const uint8_t* data) {
+            // Компілятори зводять цей вираз до одного завантаження з bswap
+            return (static_cast<uint64_t>(data[0]) << 56) | (static_cast<uint64_t>(data[1]) << 48) |
+                   (static_cast<uint64_t>(data[2]) << 40) | (static_cast<uint64_t>(data[3]) << 32) |
+                   (static_cast<uint64_t>(data[4]) << 24) | (static_cast<uint64_t>(data[5]) << 16) |
+                   (static_cast<uint64_t>(data[6]) << 8) | static_cast<uint64_t>(data[7]);
+        }
+
+        /**
+         * @brief Записати 64-бітне слово big-endian
+         * @param data вказівник на 8 байтів (вирівнювання не потрібне)
+         * @param word слово
+         */
+        static inline void storeWord(uint8_t* data, uint64_t word) {
+            data[0] = static_cast<uint8_t>(word >> 56);
+            data[1] = static_cast<uint8_t>(word >> 48);
+            data[2] = static_cast<uint8_t>(word >> 40);
+            data[3] = static_cast<uint8_t>(word >> 32);
+            data[4] = static_cast<uint8_t>(word >> 24);
+            data[5] = static_cast<uint8_t>(word >> 16);
+            data[6] = static_cast<uint8_t>(word >> 8);
+            data[7] = static_cast<uint8_t>(word);
+        }
+
+        /**
+         * @brief Дописати до 64 бітів одним 64-бітним словом
+         *
+         * Біти буфера починаючи з bitOffset мають бути нульовими
+         * @param buffer буфер призначення
+         * @param bufferSize розмір буфера в байтах
+         * @param bitOffset позиція запису в бітах
+         * @param word біти, вирівняні по старшому розряду (решта - нулі)
+         * @param bits кількість бітів (від 1 до 64)
+         */
+        static void writeWord(uint8_t* buffer, size_t bufferSize, size_t bitOffset, uint64_t word, size_t bits);
+
+        /**
+         * @brief Дописати беззнакове ціле довільної ширини (ширші за 64 біти поля доповнюються нулями)
+         *
+         * Біти буфера починаючи з bitOffset мають бути нульовими
+         * @param buffer буфер призначення
+         * @param bufferSize розмір буфера в байтах
+         * @param bitOffset позиція запису в бітах
+         * @param bits кількість бітів (не менше 1)
+         * @param value значення
+         */
+        static void writeUInt(uint8_t* buffer, size_t bufferSize, size_t bitOffset, size_t bits, uint64_t value);
+
+        /**
+         * @brief Дописати знакове ціле довільної ширини (ширші за 64 біти поля розширюються знаком)
+         *
+         * Біти буфера починаючи з bitOffset мають бути нульовими
+         * @param buffer буфер призначення
+         * @param bufferSize розмір буфера в байтах
+         * @param bitOffset позиція запису в бітах
+         * @param bits кількість бітів (не менше 1)
+         * @param value значення
+         */
+        static void writeInt(uint8_t* buffer, size_t bufferSize, size_t bitOffset, size_t bits, int64_t value);
+
+        /**
+         * @brief Дописати 256-бітне беззнакове ціле словами по 64 біти
+         *
+         * Біти буфера починаючи з bitOffset мають бути нульовими, значення має вміщатися в bits
+         * @param buffer буфер призначення
+         * @param bufferSize розмір буфера в байтах
+         * @param bitOffset позиція запису в бітах
+         * @param bits кількість бітів (від 1 до 256)
+         * @param value значення
+         */
+        static void writeUInt256(uint8_t* buffer, size_t bufferSize, size_t bitOffset, size_t bits, const UInt256& value);
+
+        /**
+         * @brief Скопіювати бітовий рядок з довільного зсуву на довільний зсув
+         *
+         * Біти першого байта dst до dstOffset зберігаються, біти останнього
+         * байта після скопійованих обнуляються. Буфери не повинні перекриватися.
+         * Використовує SSE2/AVX2, якщо процесор їх підтримує
+         * @param dst буфер призначення
+         * @param dstOffset зсув у бітах у dst
+         * @param src буфер джерела
+         * @param srcOffset зсув у бітах у src
+         * @param bitCount кількість бітів
+         */
+        static void copyBits(uint8_t* dst, size_t dstOffset, const uint8_t* src, size_t srcOffset, size_t bitCount);
+
+        /**
+         * @brief Довжина спільного префікса двох бітових рядків з довільних зсувів
+         *
+         * При однаковому зсуві в байті байти порівнюються SSE2/AVX2, інакше -
+         * 64-бітними словами. Читаються лише байти, що містять біти відрізків
+         * @param a перший рядок
+         * @param aOffset зсув у бітах у a
+         * @param b другий рядок
+         * @param bOffset зсув у бітах у b
+         * @param bitCount найбільша довжина порівняння в бітах
+         * @return кількість однакових бітів від початку (не більше bitCount)
+         */
+        static size_t commonPrefix(const uint8_t* a, size_t aOffset, const uint8_t* b, size_t bOffset, size_t bitCount);
+
+        /**
+         * @brief Перевірити рівність двох відрізків однакової довжини
+         * @return true якщо всі bitCount бітів збігаються
+         */
+        static bool equal(const uint8_t* a, size_t aOffset, const uint8_t* b, size_t bOffset, size_t bitCount);
+
+        /**
+         * @brief Лексикографічно порівняти два бітові рядки (префікс менший за довший рядок)
+         * @param a перший рядок
+         * @param aOffset зсув у бітах у a
+         * @param aBits довжина a в бітах
+         * @param b другий рядок
+         * @param bOffset зсув у бітах у b
+         * @param bBits довжина b в бітах
+         * @return -1, 0 або 1
+         */
+        static int compare(const uint8_t* a, size_t aOffset, size_t aBits,
+                           const uint8_t* b, size_t bOffset, size_t bBits);
+
+        /**
+         * @brief Порахувати ведучі біти, рівні bit
+         * @param data рядок
+         * @param offset зсув у бітах
+         * @param bitCount довжина відрізка в бітах
+         * @param bit значення біта
+         * @return кількість бітів до першого іншого (не більше bitCount)
+         */
+        static size_t countLeading(const uint8_t* data, size_t offset, size_t bitCount, bool bit);
+
+    private:
+        /**
+         * @brief Побайтовий funnel shift: out[k] = (in[k] << shift) | (in[k + 1] >> (8 - shift))
+         * @param out буфер на count байтів
+         * @param in буфер на count + 1 байтів
+         * @param count кількість байтів результату
+         * @param shift зсув від 1 до 7
+         */
+        static void funnelShift(uint8_t* out, const uint8_t* in, size_t count, unsigned shift);
+
+        /**
+         * @brief Кількість однакових байтів від початку двох буферів
+         * @param a перший буфер на count байтів
+         * @param b другий буфер на count байтів
+         * @param count кількість байтів
+         * @return індекс першого різного байта або count
+         */
+        static size_t equalBytes(const uint8_t* a, const uint8_t* b, size_t count);
+    };
+
+}
+
+#endif // CTON_BIT_STRING_H
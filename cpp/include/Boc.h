@@ -6,10 +6,13 @@
 #define CTON_BOC_H
 
 #include "Cell.h"
+#include "CellArena.h"
+#include "CellInterner.h"
+#include "CellGraph.h"
 #include <vector>
 #include <memory>
 #include <cstdint>
-#include <unordered_set>
+#include <mutex>
 
 // Export definitions for Windows DLL
 #ifdef _WIN32
@@ -45,15 +48,16 @@ namespace cton {
          * @brief Конструктор з кореневої комірки
          * @param root коренева комірка
          */
-        Boc(std::shared_ptr<Cell> root);
+        Boc(CellRef root);
         
         /**
          * @brief Серіалізувати BOC в бінарне представлення
          * @param hasIdx чи включати індекс
          * @param hashCRC чи включати CRC хеш
+         * @param withHashes чи зберігати хеші і глибини комірок (перевіряються при читанні)
          * @return бінарне представлення BOC
          */
-        std::vector<uint8_t> serialize(bool hasIdx = true, bool hashCRC = true) const;
+        std::vector<uint8_t> serialize(bool hasIdx = true, bool hashCRC = true, bool withHashes = false) const;
         
         /**
          * @brief Десеріалізувати BOC з бінарного представлення
@@ -62,20 +66,36 @@ namespace cton {
          */
         static Boc deserialize(const std::vector<uint8_t>& data);
         
+        /**
+         * @brief Десеріалізувати BOC з розміщенням комірок в арені
+         * @param data бінарні дані BOC
+         * @param arena арена, яка має пережити отримані комірки
+         * @return об'єкт Boc
+         */
+        static Boc deserialize(const std::vector<uint8_t>& data, CellArena& arena);
+        
+        /**
+         * @brief Десеріалізувати BOC, повертаючи канонічні комірки з таблиці інтернування
+         * @param data бінарні дані BOC
+         * @param interner таблиця інтернування
+         * @return об'єкт Boc
+         */
+        static Boc deserialize(const std::vector<uint8_t>& data, CellInterner& interner);
+        
         /**
          * @brief Отримати кореневу комірку
          * @return коренева комірка
          */
-        std::shared_ptr<Cell> getRoot() const;
+        CellRef getRoot() const;
         
         /**
          * @brief Встановити кореневу комірку
          * @param root нова коренева комірка
          */
-        void setRoot(std::shared_ptr<Cell> root);
+        void setRoot(CellRef root);
         
     private:
-        std::shared_ptr<Cell> root_;
+        CellRef root_;
         
         /**
          * @brief Обчислити CRC32
@@ -83,16 +103,6 @@ namespace cton {
          * @return значення CRC32
          */
         static uint32_t calculateCRC32(const std::vector<uint8_t>& data);
-        
-        /**
-         * @brief Рекурсивно зібрати всі комірки в дереві
-         * @param cell поточна комірка
-         * @param cells вектор для збору комірок
-         * @param visited множина відвіданих комірок
-         */
-        void collectCells(std::shared_ptr<Cell> cell, 
-                         std::vector<std::shared_ptr<Cell>>& cells,
-                         std::unordered_set<std::shared_ptr<Cell>>& visited) const;
     };
     
     /**
@@ -112,10 +122,46 @@ namespace cton {
          */
         Boc parse();
         
+        /**
+         * @brief Спарсити BOC з розміщенням комірок в арені
+         * @param arena арена, яка має пережити отримані комірки
+         * @return об'єкт Boc
+         */
+        Boc parse(CellArena& arena);
+        
+        /**
+         * @brief Спарсити BOC через таблицю інтернування
+         * @param interner таблиця інтернування
+         * @return об'єкт Boc з канонічними комірками
+         */
+        Boc parse(CellInterner& interner);
+        
+        /**
+         * @brief Спарсити BOC у компактний граф комірок без створення об'єктів Cell
+         * 
+         * Збережені в BOC хеші перевіряються, для чого хеші графа обчислюються одразу
+         * @return граф; корені BOC - roots графа
+         */
+        CellGraph parseGraph();
+        
     private:
         std::vector<uint8_t> data_;
         size_t offset_;
         
+        /**
+         * @brief Спарсити BOC
+         * @param arena арена для комірок або nullptr для звичайної купи
+         * @param interner таблиця інтернування або nullptr
+         * @return об'єкт Boc
+         */
+        Boc parseCells(CellArena* arena, CellInterner* interner);
+        
+        /**
+         * @brief Прочитати число у форматі 7 бітів на байт
+         * @return значення
+         */
+        size_t readVarUInt();
+        
         /**
          * @brief Прочитати байт
          * @return прочитаний байт
@@ -136,6 +182,92 @@ namespace cton {
         std::vector<uint8_t> readBytes(size_t size);
     };
     
+    /**
+     * @brief Ледачий доступ до комірок серіалізованого BOC
+     * 
+     * Розбирає лише заголовок та індекс; комірки читаються за номером на вимогу,
+     * тому обхід окремих шляхів не матеріалізує решту дерева. Матеріалізовані
+     * піддерева кешуються і живуть, доки живе об'єкт
+     */
+    class CTON_SDK_CORE_API BocView {
+    public:
+        /**
+         * @brief Конструктор
+         * 
+         * Без індексу (hasIdx) зсуви комірок знаходяться одним проходом по дескрипторах
+         * @param data бінарні дані BOC (переміщення уникає копіювання)
+         */
+        explicit BocView(std::vector<uint8_t> data);
+        
+        /**
+         * @brief Отримати кількість комірок
+         * @return кількість комірок
+         */
+        size_t getCellCount() const;
+        
+        /**
+         * @brief Отримати кількість коренів
+         * @return кількість коренів
+         */
+        size_t getRootCount() const;
+        
+        /**
+         * @brief Отримати номер кореневої комірки
+         * @param root номер кореня
+         * @return номер комірки
+         */
+        size_t getRootIndex(size_t root = 0) const;
+        
+        /**
+         * @brief Отримати кількість посилань комірки
+         * @param index номер комірки
+         * @return кількість посилань
+         */
+        size_t getRefsCount(size_t index) const;
+        
+        /**
+         * @brief Отримати номер комірки, на яку посилається комірка
+         * @param index номер комірки
+         * @param ref номер посилання
+         * @return номер дочірньої комірки
+         */
+        size_t getRefIndex(size_t index, size_t ref) const;
+        
+        /**
+         * @brief Прочитати лише дані комірки (без посилань і без дочірніх комірок)
+         * @param index номер комірки
+         * @return звичайна комірка з тими самими бітами
+         */
+        Cell loadCellData(size_t index) const;
+        
+        /**
+         * @brief Матеріалізувати комірку разом з її піддеревом
+         * @param index номер комірки
+         * @return комірка (повторні виклики повертають ту саму комірку)
+         */
+        CellRef loadCell(size_t index) const;
+        
+        /**
+         * @brief Матеріалізувати кореневу комірку
+         * @param root номер кореня
+         * @return комірка
+         */
+        CellRef getRoot(size_t root = 0) const;
+        
+    private:
+        std::vector<uint8_t> data_;
+        std::vector<size_t> offsets_;      // Абсолютні зсуви комірок у data_
+        std::vector<size_t> rootIndices_;
+        mutable std::vector<CellRef> cache_;
+        mutable std::mutex mutex_;
+        
+        /**
+         * @brief Перевірити номер комірки
+         * @param index номер комірки
+         */
+        void checkIndex(size_t index) const;
+    };
+    
     /**
      * @brief Будівельник для серіалізації BOC
      */
@@ -145,18 +277,19 @@ namespace cton {
          * @brief Конструктор
          * @param root коренева комірка
          */
-        BocBuilder(std::shared_ptr<Cell> root);
+        BocBuilder(CellRef root);
         
         /**
          * @brief Побудувати BOC
          * @param hasIdx чи включати індекс
          * @param hashCRC чи включати CRC хеш
+         * @param withHashes чи зберігати хеші і глибини комірок
          * @return бінарне представлення BOC
          */
-        std::vector<uint8_t> build(bool hasIdx = true, bool hashCRC = true);
+        std::vector<uint8_t> build(bool hasIdx = true, bool hashCRC = true, bool withHashes = false);
         
     private:
-        std::shared_ptr<Cell> root_;
+        CellRef root_;
     };
 }
 
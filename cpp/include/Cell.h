@@ -8,6 +8,12 @@
 #include <vector>
 #include <memory>
 #include <cstdint>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <string>
+#include "UInt256.h"
 
 // Export definitions for Windows DLL
 #ifdef _WIN32
@@ -24,25 +30,144 @@ namespace cton {
     
     // Forward declaration
     class CTON_SDK_CORE_API CellBuilder;
+    class CTON_SDK_CORE_API CellArena;
+    class CTON_SDK_CORE_API CellInterner;
+    class CTON_SDK_CORE_API CellSlice;
+    class Cell;
+    
+    /**
+     * @brief Тип комірки (для спеціальних комірок - перший байт даних)
+     */
+    enum class CellType : uint8_t {
+        Ordinary = 0,       // Звичайна комірка
+        PrunedBranch = 1,   // Обрізана гілка (хеші і глибини замість піддерева)
+        Library = 2,        // Посилання на бібліотечну комірку за хешем
+        MerkleProof = 3,    // Доказ Меркла
+        MerkleUpdate = 4    // Оновлення Меркла
+    };
+    
+    /**
+     * @brief Режим лічильника посилань комірки
+     */
+    enum class RefCountMode : uint8_t {
+        Atomic,     // Атомарний лічильник - комірки можна ділити між потоками
+        NonAtomic   // Звичайний лічильник - лише для однопотокової обробки
+    };
+    
+    /**
+     * @brief Вказівник на комірку з вбудованим (intrusive) лічильником посилань
+     * 
+     * Лічильник зберігається в самій комірці, тому копіювання не торкається
+     * окремого блоку керування, а вказівник займає одне машинне слово
+     */
+    class CTON_SDK_CORE_API CellRef {
+    public:
+        /**
+         * @brief Конструктор порожнього вказівника
+         */
+        CellRef() noexcept : cell_(nullptr) {}
+        
+        /**
+         * @brief Конструктор порожнього вказівника з nullptr
+         */
+        CellRef(std::nullptr_t) noexcept : cell_(nullptr) {}
+        
+        /**
+         * @brief Конструктор з сирого вказівника (збільшує лічильник)
+         * @param cell комірка або nullptr
+         */
+        explicit CellRef(Cell* cell) noexcept;
+        
+        CellRef(const CellRef& other) noexcept;
+        CellRef(CellRef&& other) noexcept : cell_(other.cell_) { other.cell_ = nullptr; }
+        ~CellRef();
+        
+        CellRef& operator=(const CellRef& other) noexcept;
+        CellRef& operator=(CellRef&& other) noexcept;
+        
+        /**
+         * @brief Прийняти володіння вказівником, отриманим з detach(), без збільшення лічильника
+         * @param cell комірка
+         * @return вказівник, що володіє коміркою
+         */
+        static CellRef adopt(Cell* cell) noexcept;
+        
+        /**
+         * @brief Відв'язати комірку без зменшення лічильника (для передачі через C API)
+         * @return сирий вказівник, який потрібно повернути через adopt()
+         */
+        Cell* detach() noexcept;
+        
+        /**
+         * @brief Звільнити комірку
+         */
+        void reset() noexcept;
+        
+        Cell* get() const noexcept { return cell_; }
+        Cell& operator*() const noexcept { return *cell_; }
+        Cell* operator->() const noexcept { return cell_; }
+        explicit operator bool() const noexcept { return cell_ != nullptr; }
+        
+        /**
+         * @brief Отримати кількість вказівників на комірку
+         * @return значення лічильника (0 для порожнього вказівника)
+         */
+        size_t useCount() const noexcept;
+        
+    private:
+        Cell* cell_;
+    };
     
     /**
      * @brief Представляє комірку TON - основну одиницю даних
      * 
-     * Cell містить до 1023 бітів даних і до 4 посилань на інші комірки
+     * Cell містить до 1023 бітів даних і до 4 посилань на інші комірки.
+     * Дані і посилання зберігаються безпосередньо в об'єкті (без окремих
+     * виділень пам'яті), об'єкт вирівняний по кеш-лінії
      */
-    class CTON_SDK_CORE_API Cell {
+    class CTON_SDK_CORE_API alignas(64) Cell {
         friend class CellBuilder;
+        friend class CellInterner;
+        friend class CellArena;
+        friend class CellRef;
+        friend class CellTraversal;
         
     public:
         // Константи для обмежень комірки
         static const size_t MAX_BITS = 1023;  // Максимальна кількість бітів у комірці
         static const size_t MAX_REFS = 4;     // Максимальна кількість посилань
+        static const size_t MAX_BYTES = 128;  // Розмір вбудованого буфера даних у байтах
+        static const size_t HASH_SIZE = 32;   // Розмір хешу представлення в байтах
+        static const unsigned MAX_LEVEL = 3;  // Максимальний рівень комірки
+        
+        /**
+         * @brief Хеш представлення комірки (SHA-256)
+         */
+        typedef std::array<uint8_t, HASH_SIZE> Hash;
         
         /**
          * @brief Конструктор за замовчуванням
          */
         Cell();
         
+        /**
+         * @brief Конструктор копіювання (кешований хеш копіюється разом з даними)
+         * @param other комірка для копіювання
+         */
+        Cell(const Cell& other);
+        
+        /**
+         * @brief Деструктор (оновлює лічильники живих комірок)
+         */
+        ~Cell();
+        
+        /**
+         * @brief Оператор присвоєння
+         * @param other комірка для копіювання
+         * @return посилання на себе
+         */
+        Cell& operator=(const Cell& other);
+        
         /**
          * @brief Конструктор з даних
          * @param data бінарні дані
@@ -52,34 +177,86 @@ namespace cton {
          */
         Cell(const std::vector<uint8_t>& data, 
              size_t bitSize, 
-             const std::vector<std::shared_ptr<Cell>>& references,
+             const std::vector<CellRef>& references,
+             bool isSpecial = false);
+
+        /**
+         * @brief Конструктор з даних без проміжних векторів
+         * @param data бінарні дані ((bitSize + 7) / 8 байтів)
+         * @param bitSize розмір даних у бітах
+         * @param references масив посилань
+         * @param refCount кількість посилань
+         * @param isSpecial чи є комірка спеціальною
+         */
+        Cell(const uint8_t* data,
+             size_t bitSize,
+             const CellRef* references,
+             size_t refCount,
              bool isSpecial = false);
+
+        /**
+         * @brief Створити комірку в купі
+         * @param args аргументи конструктора
+         * @return вказівник на нову комірку
+         */
+        template <typename... Args>
+        static CellRef create(Args&&... args) {
+            return CellRef(new Cell(std::forward<Args>(args)...));
+        }
         
         /**
-         * @brief Зберегти беззнакове ціле
+         * @brief Дописати беззнакове ціле в кінець даних комірки
          * @param bitCount кількість бітів
          * @param value значення
          */
         void storeUInt(size_t bitCount, uint64_t value);
         
         /**
-         * @brief Зберегти знакове ціле
+         * @brief Дописати знакове ціле в кінець даних комірки
          * @param bitCount кількість бітів
          * @param value значення
          */
         void storeInt(size_t bitCount, int64_t value);
         
         /**
-         * @brief Зберегти байти
+         * @brief Дописати байти в кінець даних комірки
          * @param bytes вектор байтів
          */
         void storeBytes(const std::vector<uint8_t>& bytes);
         
+        /**
+         * @brief Дописати бітовий рядок в кінець даних комірки без проміжних копій
+         * @param data буфер джерела
+         * @param bitLength кількість бітів
+         * @param bitOffset зсув першого біта в буфері
+         */
+        void storeBits(const uint8_t* data, size_t bitLength, size_t bitOffset = 0);
+        
+        /**
+         * @brief Дописати 256-бітне беззнакове ціле
+         * @param bits кількість бітів (не більше 256)
+         * @param value значення (має вміщатися в bits)
+         */
+        void storeUInt256(size_t bits, const UInt256& value);
+        
+        /**
+         * @brief Дописати VarUInteger n: довжина в байтах (#< n), потім значення
+         * @param maxBytes n (від 1 до 33)
+         * @param value значення (не більше n - 1 байтів)
+         */
+        void storeVarUInt(size_t maxBytes, const UInt256& value);
+        
+        /**
+         * @brief Дописати суму монет (Coins = VarUInteger 16)
+         * @param amount сума в нанотонах
+         */
+        void storeCoins(const UInt256& amount);
+        
         /**
          * @brief Додати посилання на комірку
          * @param cell комірка для посилання
          */
-        void addReference(std::shared_ptr<Cell> cell);
+        void addReference(CellRef cell);
         
         /**
          * @brief Отримати дані комірки
@@ -87,6 +264,12 @@ namespace cton {
          */
         std::vector<uint8_t> getData() const;
         
+        /**
+         * @brief Отримати вказівник на вбудований буфер даних без копіювання
+         * @return вказівник на MAX_BYTES байтів; біти після getBitSize() нульові
+         */
+        const uint8_t* getRawData() const;
+        
         /**
          * @brief Отримати розмір даних у бітах
          * @return розмір у бітах
@@ -97,7 +280,14 @@ namespace cton {
          * @brief Отримати посилання
          * @return вектор посилань
          */
-        std::vector<std::weak_ptr<Cell>> getReferences() const;
+        std::vector<CellRef> getReferences() const;
+        
+        /**
+         * @brief Отримати посилання за індексом без копіювання
+         * @param index індекс посилання (менше getRefsCount())
+         * @return посилання на комірку
+         */
+        const CellRef& getReference(size_t index) const;
         
         /**
          * @brief Отримати кількість посилань
@@ -111,12 +301,256 @@ namespace cton {
          */
         bool isSpecial() const;
         
+        /**
+         * @brief Отримати тип комірки
+         * @return CellType::Ordinary для звичайних комірок, інакше тип спеціальної комірки
+         */
+        CellType getType() const;
+        
+        /**
+         * @brief Отримати маску рівнів комірки
+         * @return маска (біт i встановлений, якщо хеш рівня i + 1 відрізняється від нижчого)
+         */
+        uint8_t getLevelMask() const;
+        
+        /**
+         * @brief Отримати рівень комірки
+         * @return номер найстаршого біта маски рівнів (0 для комірок без обрізаних гілок)
+         */
+        unsigned getLevel() const;
+        
+        /**
+         * @brief Отримати хеш представлення комірки (TON representation hash)
+         * 
+         * Обчислюється один раз знизу вгору і кешується в комірці;
+         * хеші дочірніх комірок беруться з їхніх кешів, а ще не хешовані
+         * піддерева обходяться з явним стеком, без рекурсії.
+         * Комірку не слід змінювати після того, як на неї послалась інша комірка
+         * @return SHA-256 від представлення комірки
+         * @throws std::overflow_error якщо глибина піддерева більша за 65535
+         */
+        Hash hash() const;
+        
+        /**
+         * @brief Отримати хеш комірки на заданому рівні
+         * 
+         * hash(0) для комірки з обрізаними гілками дорівнює хешу повної комірки
+         * @param level рівень (значення понад MAX_LEVEL дають хеш представлення)
+         * @return хеш рівня
+         */
+        Hash hash(unsigned level) const;
+        
+        /**
+         * @brief Отримати глибину комірки (0 для комірки без посилань)
+         * @return глибина піддерева
+         * @throws std::overflow_error якщо глибина більша за 65535
+         */
+        uint16_t depth() const;
+        
+        /**
+         * @brief Отримати глибину комірки на заданому рівні
+         * @param level рівень
+         * @return глибина рівня
+         */
+        uint16_t depth(unsigned level) const;
+        
+        /**
+         * @brief Обчислити хеші всіх комірок дерева паралельно, шар за шаром
+         * 
+         * Ще не хешовані комірки групуються за висотою (шар 0 - комірки, дочірні
+         * комірки яких уже мають хеш). Комірки одного шару незалежні, тому кожен шар
+         * ділиться між потоками, а в межах потоку хешується пакетами векторним SHA-256;
+         * результати записуються в кеш хешу кожної комірки
+         * @param root корінь дерева
+         * @param threads кількість потоків (0 - за кількістю ядер)
+         * @throws std::overflow_error якщо глибина дерева більша за 65535
+         */
+        static void hashTree(const CellRef& root, unsigned threads = 0);
+        
+        /**
+         * @brief Створити обрізану гілку замість комірки
+         * @param cell комірка, яку замінює гілка
+         * @param level рівень нової гілки (більший за рівень комірки, не більший MAX_LEVEL)
+         * @return спеціальна комірка PrunedBranch
+         */
+        static CellRef createPrunedBranch(const Cell& cell, unsigned level = 1);
+        
+        /**
+         * @brief Створити доказ Меркла
+         * @param root корінь дерева, в якому непотрібні гілки замінено обрізаними
+         * @return спеціальна комірка MerkleProof
+         */
+        static CellRef createMerkleProof(const CellRef& root);
+        
+        /**
+         * @brief Створити оновлення Меркла
+         * @param from дерево до оновлення
+         * @param to дерево після оновлення
+         * @return спеціальна комірка MerkleUpdate
+         */
+        static CellRef createMerkleUpdate(const CellRef& from, const CellRef& to);
+        
+        /**
+         * @brief Створити бібліотечну комірку
+         * @param libraryHash хеш представлення бібліотечної комірки
+         * @return спеціальна комірка Library
+         */
+        static CellRef createLibrary(const Hash& libraryHash);
+        
+        /**
+         * @brief Пам'ять, яку займає комірка: об'єкт і хеші рівнів (без дочірніх комірок)
+         * @return розмір у байтах
+         */
+        size_t memoryFootprint() const;
+        
+        /**
+         * @brief Кількість живих комірок у процесі
+         * @return кількість комірок
+         */
+        static size_t liveCount();
+        
+        /**
+         * @brief Пам'ять живих комірок у процесі (див. memoryFootprint)
+         * @return розмір у байтах
+         */
+        static size_t liveBytes();
+        
     private:
-        std::vector<uint8_t> data_;
-        size_t bitSize_;
-        std::vector<std::shared_ptr<Cell>> references_;
+        /**
+         * @brief Хеші і глибини всіх значущих рівнів комірки
+         */
+        struct LevelHashes {
+            Hash hashes[MAX_LEVEL + 1];
+            uint16_t depths[MAX_LEVEL + 1];
+            uint8_t levelMask;
+            uint8_t hashCount;
+        };
+        
+
+        // Дані займають перші дві кеш-лінії, посилання - третю,
+        // кеш хешу і заголовок - четверту
+        uint8_t data_[MAX_BYTES];
+        CellRef references_[MAX_REFS];
+        
+        // Кеш хешу і глибини; стан: 0 - не обчислено, 1 - обчислюється, 2 - готово.
+        // Хеші нижчих рівнів є лише в комірках з обрізаними гілками і зберігаються окремо
+        mutable Hash hash_;
+        mutable uint16_t depth_;
+        mutable std::atomic<uint8_t> hashState_;
+        mutable uint8_t levelMask_;
+        
+        uint16_t bitSize_;
+        uint8_t refsCount_;
         bool isSpecial_;
         
+        mutable std::unique_ptr<LevelHashes> levelHashes_;
+        
+        // Вбудований лічильник посилань; неатомарні операції - relaxed load/store без lock-префікса.
+        // arena_ - арена, що володіє пам'яттю комірки (nullptr для комірок з купи)
+        mutable std::atomic<uint32_t> refCount_;
+        bool atomicRefCount_;
+        CellArena* arena_;
+        
+        /**
+         * @brief Збільшити лічильник посилань
+         */
+        void retain() const noexcept;
+        
+        /**
+         * @brief Зменшити лічильник посилань і знищити комірку, якщо він став нульовим
+         */
+        void release() const noexcept;
+        
+        /**
+         * @brief Зменшити лічильник посилань без знищення
+         * @return true якщо лічильник став нульовим
+         */
+        bool dropReference() const noexcept;
+        
+        /**
+         * @brief Знищити комірку (у купі - звільнити пам'ять, в арені - лише викликати деструктор)
+         * 
+         * Дочірні комірки, що залишились без посилань, знищуються в циклі, а не рекурсивно
+         */
+        void destroy() const noexcept;
+        
+        /**
+         * @brief Скопіювати дані та обнулити решту буфера
+         * @param data бінарні дані
+         * @param bitSize розмір даних у бітах
+         */
+        void assignData(const uint8_t* data, size_t bitSize);
+        
+        /**
+         * @brief Обчислити хеші і глибини та записати їх у кеш
+         */
+        void computeHash() const;
+        
+        /**
+         * @brief Обчислити хеші і глибини всіх рівнів комірки з заданим вмістом
+         * @param data бінарні дані
+         * @param bitSize розмір даних у бітах
+         * @param references масив посилань
+         * @param refCount кількість посилань
+         * @param isSpecial чи є комірка спеціальною
+         * @param result результат
+         */
+        static void computeLevelHashes(const uint8_t* data,
+                                       size_t bitSize,
+                                       const CellRef* references,
+                                       size_t refCount,
+                                       bool isSpecial,
+                                       LevelHashes& result);
+        
+        /**
+         * @brief Перевірити структуру спеціальної комірки
+         * @param data бінарні дані
+         * @param bitSize розмір даних у бітах
+         * @param references масив посилань
+         * @param refCount кількість посилань
+         */
+        static void validateSpecial(const uint8_t* data,
+                                    size_t bitSize,
+                                    const CellRef* references,
+                                    size_t refCount);
+        
+        /**
+         * @brief Записати обчислені хеші і глибини в кеш
+         * @param hashes хеші і глибини рівнів
+         */
+        void publishHash(const LevelHashes& hashes) const;
+        
+        /**
+         * @brief Замінити хеші рівнів (з обліком пам'яті)
+         * @param hashes нові хеші рівнів або nullptr
+         */
+        void assignLevelHashes(const LevelHashes* hashes) const;
+        
+        /**
+         * @brief Захешувати комірки, дочірні комірки яких уже мають хеш
+         * 
+         * Комірки без рівнів хешуються пакетами через Sha256::hashBatch
+         * @param cells комірки
+         * @param count кількість комірок
+         */
+        static void hashCells(const Cell* const* cells, size_t count);
+        
+        /**
+         * @brief Захешувати нехешовані комірки піддерева в одному потоці (зворотний обхід)
+         * @param root корінь піддерева
+         */
+        static void hashSubgraph(const Cell* root);
+        
+        /**
+         * @brief Переконатися, що кеш хешів заповнений
+         */
+        void ensureHash() const;
+        
+        /**
+         * @brief Скинути кеш після зміни комірки
+         */
+        void invalidateHash();
+        
         /**
          * @brief Перевірити чи можна зберегти біти
          * @param bitCount кількість бітів для збереження
@@ -124,6 +558,108 @@ namespace cton {
         void checkCapacity(size_t bitCount);
     };
     
+    inline void Cell::retain() const noexcept {
+#ifndef CTON_CELL_NONATOMIC_REFCOUNT
+        if (atomicRefCount_) {
+            refCount_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+#endif
+        refCount_.store(refCount_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    
+    inline bool Cell::dropReference() const noexcept {
+        uint32_t remaining;
+#ifndef CTON_CELL_NONATOMIC_REFCOUNT
+        if (atomicRefCount_) {
+            remaining = refCount_.fetch_sub(1, std::memory_order_acq_rel) - 1;
+        } else
+#endif
+        {
+            remaining = refCount_.load(std::memory_order_relaxed) - 1;
+            refCount_.store(remaining, std::memory_order_relaxed);
+        }
+        return remaining == 0;
+    }
+    
+    inline void Cell::release() const noexcept {
+        if (dropReference()) {
+            destroy();
+        }
+    }
+    
+    inline CellRef::CellRef(Cell* cell) noexcept : cell_(cell) {
+        if (cell_) {
+            cell_->retain();
+        }
+    }
+    
+    inline CellRef::CellRef(const CellRef& other) noexcept : cell_(other.cell_) {
+        if (cell_) {
+            cell_->retain();
+        }
+    }
+    
+    inline CellRef::~CellRef() {
+        if (cell_) {
+            cell_->release();
+        }
+    }
+    
+    inline CellRef& CellRef::operator=(const CellRef& other) noexcept {
+        if (other.cell_) {
+            other.cell_->retain();
+        }
+        Cell* old = cell_;
+        cell_ = other.cell_;
+        if (old) {
+            old->release();
+        }
+        return *this;
+    }
+    
+    inline CellRef& CellRef::operator=(CellRef&& other) noexcept {
+        if (this != &other) {
+            Cell* old = cell_;
+            cell_ = other.cell_;
+            other.cell_ = nullptr;
+            if (old) {
+                old->release();
+            }
+        }
+        return *this;
+    }
+    
+    inline CellRef CellRef::adopt(Cell* cell) noexcept {
+        CellRef result;
+        result.cell_ = cell;
+        return result;
+    }
+    
+    inline Cell* CellRef::detach() noexcept {
+        Cell* cell = cell_;
+        cell_ = nullptr;
+        return cell;
+    }
+    
+    inline void CellRef::reset() noexcept {
+        if (cell_) {
+            cell_->release();
+            cell_ = nullptr;
+        }
+    }
+    
+    inline size_t CellRef::useCount() const noexcept {
+        return cell_ ? cell_->refCount_.load(std::memory_order_relaxed) : 0;
+    }
+    
+    inline bool operator==(const CellRef& a, const CellRef& b) noexcept { return a.get() == b.get(); }
+    inline bool operator!=(const CellRef& a, const CellRef& b) noexcept { return a.get() != b.get(); }
+    inline bool operator==(const CellRef& a, std::nullptr_t) noexcept { return !a; }
+    inline bool operator!=(const CellRef& a, std::nullptr_t) noexcept { return static_cast<bool>(a); }
+    inline bool operator==(std::nullptr_t, const CellRef& a) noexcept { return !a; }
+    inline bool operator!=(std::nullptr_t, const CellRef& a) noexcept { return static_cast<bool>(a); }
+    
     /**
      * @brief Будівельник для створення комірок
      */
@@ -157,25 +693,163 @@ namespace cton {
          */
         CellBuilder& storeBytes(const std::vector<uint8_t>& bytes);
         
+        /**
+         * @brief Зберегти бітовий рядок з довільного бітового зсуву
+         * @param data буфер джерела
+         * @param bitLength кількість бітів
+         * @param bitOffset зсув першого біта в буфері
+         * @return посилання на себе для ланцюжкових викликів
+         */
+        CellBuilder& storeBits(const uint8_t* data, size_t bitLength, size_t bitOffset = 0);
+        
+        /**
+         * @brief Зберегти 256-бітне беззнакове ціле
+         * @param bits кількість бітів (не більше 256)
+         * @param value значення (має вміщатися в bits)
+         * @return посилання на себе для ланцюжкових викликів
+         */
+        CellBuilder& storeUInt256(size_t bits, const UInt256& value);
+        
+        /**
+         * @brief Зберегти VarUInteger n: довжина в байтах (#< n), потім значення
+         * @param maxBytes n (від 1 до 33)
+         * @param value значення (не більше n - 1 байтів)
+         * @return посилання на себе для ланцюжкових викликів
+         */
+        CellBuilder& storeVarUInt(size_t maxBytes, const UInt256& value);
+        
+        /**
+         * @brief Зберегти суму монет (Coins = VarUInteger 16)
+         * @param amount сума в нанотонах
+         * @return посилання на себе для ланцюжкових викликів
+         */
+        CellBuilder& storeCoins(const UInt256& amount);
+        
+        /**
+         * @brief Зберегти непрочитані біти і посилання зрізу
+         * @param slice зріз комірки
+         * @return посилання на себе для ланцюжкових викликів
+         */
+        CellBuilder& storeSlice(const CellSlice& slice);
+        
+        /**
+         * @brief Зберегти байти у форматі snake
+         * 
+         * Байти заповнюють вільне місце поточної комірки, решта - ланцюжок комірок
+         * по 127 байтів, кожна з посиланням на наступну. Ланцюжок будується одним
+         * проходом з кінця і стає першим посиланням комірки: саме за ним читають
+         * CellSlice::loadSnakeBytes і cell_load_snake_bytes
+         * @param data буфер байтів
+         * @param size кількість байтів
+         * @return посилання на себе для ланцюжкових викликів
+         * @throws std::invalid_argument якщо потрібен хвіст, а комірка вже має посилання
+         */
+        CellBuilder& storeSnakeBytes(const uint8_t* data, size_t size);
+        
+        /**
+         * @brief Зберегти байти у форматі snake
+         * @param bytes вектор байтів
+         * @return посилання на себе для ланцюжкових викликів
+         */
+        CellBuilder& storeSnakeBytes(const std::vector<uint8_t>& bytes);
+        
+        /**
+         * @brief Зберегти рядок (байти UTF-8) у форматі snake
+         * @param text рядок
+         * @return посилання на себе для ланцюжкових викликів
+         */
+        CellBuilder& storeSnakeString(const std::string& text);
+        
         /**
          * @brief Зберегти посилання на комірку
          * @param cell комірка для посилання
          * @return посилання на себе для ланцюжкових викликів
          */
-        CellBuilder& storeRef(std::shared_ptr<Cell> cell);
+        CellBuilder& storeRef(CellRef cell);
         
         /**
          * @brief Побудувати комірку
          * @return створена комірка
          */
-        std::shared_ptr<Cell> build();
+        CellRef build();
+        
+        /**
+         * @brief Позначити комірку, що будується, як спеціальну
+         * 
+         * Тип спеціальної комірки задається першим байтом даних
+         * @param special чи є комірка спеціальною
+         * @return посилання на себе для ланцюгових викликів
+         */
+        CellBuilder& setSpecial(bool special = true);
+        
+        /**
+         * @brief Побудувати комірку в арені
+         * @param arena арена, яка має пережити створену комірку
+         * @return створена комірка
+         */
+        CellRef build(CellArena& arena);
+        
+        /**
+         * @brief Побудувати комірку через таблицю інтернування
+         * @param interner таблиця інтернування
+         * @return канонічна комірка з таким самим вмістом
+         */
+        CellRef build(CellInterner& interner);
         
     private:
-        std::vector<uint8_t> buffer_;
+        uint8_t buffer_[Cell::MAX_BYTES];
         size_t bitOffset_;
-        std::vector<std::shared_ptr<Cell>> references_;
+        CellRef references_[Cell::MAX_REFS];
+        size_t refsCount_;
+        bool isSpecial_;
+    };
+    
+    /**
+     * @brief Порівняти комірки за хешем представлення
+     * @param a перша комірка
+     * @param b друга комірка
+     * @return true якщо комірки структурно однакові
+     */
+    CTON_SDK_CORE_API bool operator==(const Cell& a, const Cell& b);
+    
+    /**
+     * @brief Порівняти комірки за хешем представлення
+     * @param a перша комірка
+     * @param b друга комірка
+     * @return true якщо комірки структурно різні
+     */
+    CTON_SDK_CORE_API bool operator!=(const Cell& a, const Cell& b);
+    
+    /**
+     * @brief Функтор хешування комірок для unordered-контейнерів
+     * 
+     * Використовує кешований хеш представлення, тому працює за O(1)
+     */
+    struct CTON_SDK_CORE_API CellHash {
+        size_t operator()(const Cell& cell) const;
+        size_t operator()(const CellRef& cell) const;
+    };
+    
+    /**
+     * @brief Функтор структурного порівняння комірок для unordered-контейнерів
+     */
+    struct CTON_SDK_CORE_API CellEqual {
+        bool operator()(const Cell& a, const Cell& b) const;
+        bool operator()(const CellRef& a, const CellRef& b) const;
     };
     
 }
 
+namespace std {
+    /**
+     * @brief Хешування CellRef за адресою комірки
+     */
+    template <>
+    struct hash<cton::CellRef> {
+        size_t operator()(const cton::CellRef& ref) const noexcept {
+            return std::hash<const cton::Cell*>()(ref.get());
+        }
+    };
+}
+
 #endif // CTON_CELL_H
\ No newline at end of file
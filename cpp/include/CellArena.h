@@ -0,0 +1,145 @@
+// CellArena.h - арена для розміщення графів комірок
+// Author: Андрій Будильников (Sparky)
+// Bump allocator for cell graphs
+// Арена для размещения графов ячеек
+
+#ifndef CTON_CELL_ARENA_H
+#define CTON_CELL_ARENA_H
+
+#include "Cell.h"
+#include <vector>
+#include <memory>
+#include <memory_resource>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+// Export definitions for Windows DLL
+#ifdef _WIN32
+    #ifdef CTON_SDK_CORE_EXPORTS
+        #define CTON_SDK_CORE_API __declspec(dllexport)
+    #else
+        #define CTON_SDK_CORE_API __declspec(dllimport)
+    #endif
+#else
+    #define CTON_SDK_CORE_API
+#endif
+
+namespace cton {
+
+    /**
+     * @brief Арена (bump allocator) для комірок та їхніх даних
+     *
+     * Комірки, створені в арені, розміщуються послідовно у великих блоках
+     * пам'яті, і вся пам'ять повертається системі одним викликом при знищенні
+     * арени. Окрема комірка все одно звільняється як звичайна: зменшення
+     * лічильника посилань і виклик ~Cell (Cell::destroy) для кожної комірки,
+     * економиться лише operator delete.
+     * Посилання між комірками арени залишаються власницькими, тому граф
+     * звільняється покомірково, а не одним проходом.
+     * Контракт: усі комірки арени мають бути знищені до знищення самої арени.
+     * Арена рахує живі комірки, і в налагоджувальній збірці деструктор
+     * перевіряє це через assert.
+     * Арена не є потокобезпечною. Для однопотокової обробки арена може
+     * створювати комірки з неатомарним лічильником посилань.
+     */
+    class CTON_SDK_CORE_API CellArena : public std::pmr::memory_resource {
+    public:
+        static const size_t DEFAULT_CHUNK_SIZE = 64 * 1024;  // Розмір блоку за замовчуванням
+
+        /**
+         * @brief Конструктор
+         * @param chunkSize розмір одного блоку пам'яті в байтах
+         * @param refCountMode режим лічильника посилань для комірок арени
+         */
+        explicit CellArena(size_t chunkSize = DEFAULT_CHUNK_SIZE,
+                           RefCountMode refCountMode = RefCountMode::Atomic);
+
+        /**
+         * @brief Деструктор - звільняє всі блоки одразу
+         *
+         * Жодна комірка арени не повинна бути живою (перевіряється assert)
+         */
+        ~CellArena() override;
+
+        CellArena(const CellArena&) = delete;
+        CellArena& operator=(const CellArena&) = delete;
+
+        /**
+         * @brief Створити комірку в арені
+         * @param data дані комірки
+         * @param bitSize розмір даних у бітах
+         * @param references масив посилань
+         * @param refCount кількість посилань
+         * @param isSpecial чи є комірка спеціальною
+         * @return створена комірка
+         */
+        CellRef createCell(const uint8_t* data,
+                                         size_t bitSize,
+                                         const CellRef* references,
+                                         size_t refCount,
+                                         bool isSpecial = false);
+
+        /**
+         * @brief Отримати кількість виділених байтів
+         * @return байти, видані з арени
+         */
+        size_t getAllocatedBytes() const;
+
+        /**
+         * @brief Отримати кількість зарезервованих байтів
+         * @return сумарний розмір усіх блоків
+         */
+        size_t getReservedBytes() const;
+
+        /**
+         * @brief Отримати режим лічильника посилань
+         * @return режим для комірок цієї арени
+         */
+        RefCountMode getRefCountMode() const;
+
+        /**
+         * @brief Отримати кількість блоків
+         * @return кількість блоків пам'яті
+         */
+        size_t getChunkCount() const;
+
+        /**
+         * @brief Отримати кількість живих комірок арени
+         * @return комірки, створені в арені і ще не знищені
+         */
+        size_t getLiveCellCount() const;
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    private:
+        friend class Cell;
+
+        size_t chunkSize_;
+        RefCountMode refCountMode_;
+        std::vector<std::unique_ptr<uint8_t[]>> chunks_;
+        uint8_t* current_;
+        size_t remaining_;
+        size_t allocatedBytes_;
+        size_t reservedBytes_;
+        // Атомарний: комірки в режимі Atomic можуть звільнятися з інших потоків
+        std::atomic<size_t> liveCells_;
+
+        /**
+         * @brief Зареєструвати знищення комірки арени (викликає Cell::destroy)
+         */
+        void releaseCell() noexcept;
+
+        /**
+         * @brief Додати новий блок пам'яті
+         * @param minSize мінімальний розмір блоку
+         */
+        void addChunk(size_t minSize);
+    };
+
+}
+
+#endif // CTON_CELL_ARENA_H
@@ -0,0 +1,132 @@
+// CellEditor.h - редагування дерева комірок з копіюванням шляху
+// Author: Андрій Будильников (Sparky)
+// Copy-on-write editor that rewrites a path in a cell tree
+// Редактирование дерева ячеек с копированием пути
+
+#ifndef CTON_CELL_EDITOR_H
+#define CTON_CELL_EDITOR_H
+
+#include "Cell.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Export definitions for Windows DLL
+#ifdef _WIN32
+    #ifdef CTON_SDK_CORE_EXPORTS
+        #define CTON_SDK_CORE_API __declspec(dllexport)
+    #else
+        #define CTON_SDK_CORE_API __declspec(dllimport)
+    #endif
+#else
+    #define CTON_SDK_CORE_API
+#endif
+
+namespace cton {
+
+    /**
+     * @brief Редактор дерева комірок з копіюванням лише шляху до зміненої комірки
+     *
+     * Редактор тримає шлях від кореня до поточної комірки. Зміни замінюють
+     * поточну комірку новою, а предки перебудовуються при підйомі (up, root):
+     * нова комірка-предок копіює дані і посилання старої, змінюючи одне посилання.
+     * Незмінені піддерева спільні зі старим деревом разом з кешованими хешами,
+     * тому хеш нового кореня перераховує лише комірки на шляху.
+     * Старе дерево не змінюється
+     */
+    class CTON_SDK_CORE_API CellEditor {
+    public:
+        /**
+         * @brief Почати редагування дерева
+         * @param root коренева комірка
+         */
+        explicit CellEditor(CellRef root);
+
+        /**
+         * @brief Перейти до дочірньої комірки
+         * @param refIndex індекс посилання поточної комірки
+         * @return посилання на себе
+         */
+        CellEditor& down(size_t refIndex);
+
+        /**
+         * @brief Повернутися до батьківської комірки (з перебудовою, якщо дочірня змінилась)
+         * @return посилання на себе
+         */
+        CellEditor& up();
+
+        /**
+         * @brief Повернутися до кореня
+         * @return посилання на себе
+         */
+        CellEditor& toRoot();
+
+        /**
+         * @brief Отримати глибину поточної комірки (0 - корінь)
+         */
+        size_t depth() const;
+
+        /**
+         * @brief Отримати поточну комірку (з урахуванням змін)
+         * @return комірка
+         */
+        const CellRef& current() const;
+
+        /**
+         * @brief Замінити поточну комірку разом з піддеревом
+         * @param cell нова комірка
+         */
+        void replace(CellRef cell);
+
+        /**
+         * @brief Замінити дані поточної комірки, зберігши посилання
+         * @param data бінарні дані ((bitSize + 7) / 8 байтів)
+         * @param bitSize розмір даних у бітах
+         */
+        void setData(const uint8_t* data, size_t bitSize);
+
+        /**
+         * @brief Замінити посилання поточної комірки
+         * @param refIndex індекс посилання
+         * @param cell нова дочірня комірка
+         */
+        void setReference(size_t refIndex, CellRef cell);
+
+        /**
+         * @brief Отримати корінь зміненого дерева
+         *
+         * Перебудовує предків змінених комірок; поточна позиція зберігається,
+         * тож редагування можна продовжувати
+         * @return новий корінь (старий, якщо змін не було)
+         */
+        CellRef root();
+
+        /**
+         * @brief Замінити піддерево за шляхом з індексів посилань
+         * @param root коренева комірка
+         * @param path індекси посилань від кореня
+         * @param replacement нова комірка
+         * @return новий корінь
+         */
+        static CellRef replaceAt(const CellRef& root, const std::vector<size_t>& path, CellRef replacement);
+
+    private:
+        // Комірка на шляху; refIndex - її індекс у батьківській комірці
+        struct Frame {
+            CellRef cell;
+            size_t refIndex;
+            bool modified;
+        };
+
+        std::vector<Frame> path_;
+
+        /**
+         * @brief Перенести змінену дочірню комірку шляху в батьківську
+         * @param childPos позиція дочірньої комірки в path_
+         */
+        void propagate(size_t childPos);
+    };
+
+}
+
+#endif // CTON_CELL_EDITOR_H
@@ -0,0 +1,184 @@
+// CellGraph.h - компактне представлення графа комірок
+// Author: Андрій Будильников (Sparky)
+// Compact structure-of-arrays cell graph with 32-bit indices
+// Компактное представление графа ячеек
+
+#ifndef CTON_CELL_GRAPH_H
+#define CTON_CELL_GRAPH_H
+
+#include "Cell.h"
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+// Export definitions for Windows DLL
+#ifdef _WIN32
+    #ifdef CTON_SDK_CORE_EXPORTS
+        #define CTON_SDK_CORE_API __declspec(dllexport)
+    #else
+        #define CTON_SDK_CORE_API __declspec(dllimport)
+    #endif
+#else
+    #define CTON_SDK_CORE_API
+#endif
+
+namespace cton {
+
+    class CTON_SDK_CORE_API BocParser;
+
+    /**
+     * @brief Граф комірок у вигляді кількох суцільних масивів
+     *
+     * Замість окремого об'єкта на комірку з 64-бітними вказівниками граф зберігає
+     * один пул даних, масив 12-байтних дескрипторів і масив 32-бітних індексів
+     * посилань. Комірки впорядковані топологічно: посилання завжди вказують на
+     * більший індекс, тож корінь з fromCell має індекс 0. Граф незмінний після побудови; для
+     * редагування його перетворюють на дерево Cell
+     */
+    class CTON_SDK_CORE_API CellGraph {
+    public:
+        typedef uint32_t Index;
+
+        /**
+         * @brief Конструктор порожнього графа
+         */
+        CellGraph();
+
+        /**
+         * @brief Побудувати граф з дерева комірок (спільні комірки - один раз)
+         * @param root коренева комірка
+         * @return граф
+         * @throws std::overflow_error якщо комірок або даних більше, ніж вміщують 32 біти
+         */
+        static CellGraph fromCell(const CellRef& root);
+
+        /**
+         * @brief Матеріалізувати піддерево в комірки Cell
+         * @param index індекс кореня піддерева
+         * @return коренева комірка
+         * @throws std::out_of_range якщо індекс поза межами
+         * @throws std::invalid_argument якщо спеціальна комірка некоректна
+         */
+        CellRef toCell(Index index = 0) const;
+
+        /**
+         * @brief Отримати кількість комірок
+         */
+        size_t cellCount() const;
+
+        /**
+         * @brief Отримати кількість коренів
+         */
+        size_t rootCount() const;
+
+        /**
+         * @brief Отримати індекс кореня
+         * @param i номер кореня
+         * @throws std::out_of_range якщо номер поза межами
+         */
+        Index root(size_t i = 0) const;
+
+        /**
+         * @brief Отримати розмір даних комірки в бітах
+         */
+        size_t bitSize(Index index) const;
+
+        /**
+         * @brief Отримати дані комірки
+         * @return вказівник на (bitSize + 7) / 8 байтів; біти після bitSize нульові
+         */
+        const uint8_t* data(Index index) const;
+
+        /**
+         * @brief Отримати кількість посилань комірки
+         */
+        size_t refCount(Index index) const;
+
+        /**
+         * @brief Отримати індекс дочірньої комірки
+         * @param index індекс комірки
+         * @param i номер посилання
+         * @throws std::out_of_range якщо номер посилання поза межами
+         */
+        Index ref(Index index, size_t i) const;
+
+        /**
+         * @brief Перевірити чи комірка спеціальна
+         */
+        bool isSpecial(Index index) const;
+
+        /**
+         * @brief Отримати маску рівнів комірки
+         */
+        uint8_t levelMask(Index index) const;
+
+        /**
+         * @brief Обчислити хеші і глибини всіх комірок
+         *
+         * Звичайні комірки без рівнів хешуються пакетами векторним SHA-256 прямо
+         * з масивів графа; спеціальні комірки і комірки з рівнями матеріалізуються
+         * @throws std::overflow_error якщо глибина комірки перевищує 65535
+         */
+        void computeHashes();
+
+        /**
+         * @brief Перевірити чи хеші обчислені
+         */
+        bool hasHashes() const;
+
+        /**
+         * @brief Отримати хеш представлення комірки (як Cell::hash())
+         * @throws std::logic_error якщо хеші не обчислені
+         */
+        Cell::Hash hash(Index index) const;
+
+        /**
+         * @brief Отримати глибину комірки (як Cell::depth())
+         * @throws std::logic_error якщо хеші не обчислені
+         */
+        uint16_t depth(Index index) const;
+
+        /**
+         * @brief Отримати пам'ять, зайняту масивами графа
+         * @return розмір у байтах
+         */
+        size_t memoryUsage() const;
+
+    private:
+        friend class BocParser;
+
+        // Дескриптор комірки; flags: біти 0-2 - маска рівнів, біт 3 - спеціальна
+        struct Descriptor {
+            uint32_t dataOffset;
+            uint32_t firstRef;
+            uint16_t bitSize;
+            uint8_t refCount;
+            uint8_t flags;
+        };
+
+        static const uint8_t SPECIAL_FLAG = 0x08;
+
+        std::vector<uint8_t> data_;
+        std::vector<Descriptor> cells_;
+        std::vector<Index> refs_;
+        std::vector<Index> roots_;
+        std::vector<Cell::Hash> hashes_;
+        std::vector<uint16_t> depths_;
+
+        /**
+         * @brief Додати комірку; посилання додаються окремо в refs_
+         */
+        void appendCell(const uint8_t* data, size_t bitSize, size_t refCount, bool special, uint8_t levelMask);
+
+        /**
+         * @brief Матеріалізувати комірку, використовуючи вже створені в cache
+         */
+        CellRef materialize(Index index, std::unordered_map<Index, CellRef>& cache) const;
+
+        void checkIndex(Index index) const;
+    };
+
+}
+
+#endif // CTON_CELL_GRAPH_H
@@ -0,0 +1,119 @@
+// CellGraphStats.h - облік пам'яті графа комірок
+// Author: Андрій Будильников (Sparky)
+// Memory footprint accounting for cell graphs
+// Учет памяти графа ячеек
+
+#ifndef CTON_CELL_GRAPH_STATS_H
+#define CTON_CELL_GRAPH_STATS_H
+
+#include "Cell.h"
+#include <cstdint>
+#include <cstddef>
+
+// Export definitions for Windows DLL
+#ifdef _WIN32
+    #ifdef CTON_SDK_CORE_EXPORTS
+        #define CTON_SDK_CORE_API __declspec(dllexport)
+    #else
+        #define CTON_SDK_CORE_API __declspec(dllimport)
+    #endif
+#else
+    #define CTON_SDK_CORE_API
+#endif
+
+namespace cton {
+
+    /**
+     * @brief Статистика пам'яті графа комірок
+     *
+     * Кожна спільна комірка враховується один раз. Корисні дані - байти бітів
+     * комірок; накладні витрати - решта пам'яті об'єктів комірок (вбудований
+     * буфер, посилання, кеш хешу, заголовок) і окремо виділені хеші рівнів.
+     * Лічильники всього процесу - Cell::liveCount() і Cell::liveBytes()
+     */
+    struct CTON_SDK_CORE_API CellGraphStats {
+        uint64_t cellCount;      // Кількість різних комірок
+        uint64_t treeCellCount;  // Кількість комірок, якби спільні піддерева були копіями (насичується на UINT64_MAX)
+        uint64_t totalBits;      // Сума бітів даних
+        uint64_t totalRefs;      // Сума посилань
+        uint64_t specialCells;   // Кількість спеціальних комірок
+        uint64_t payloadBytes;   // Байти даних ((біти + 7) / 8 на комірку)
+        uint64_t overheadBytes;  // Решта пам'яті комірок
+        uint32_t maxDepth;       // Глибина кореня (без обрізання до 16 бітів, як у Cell::depth())
+
+        CellGraphStats();
+
+        /**
+         * @brief Пам'ять графа: корисні дані і накладні витрати
+         * @return розмір у байтах
+         */
+        uint64_t totalBytes() const;
+
+        /**
+         * @brief Частка комірок, заощаджена спільними піддеревами
+         * @return 1 - cellCount / treeCellCount (0 для дерева без спільних комірок)
+         */
+        double sharedRatio() const;
+
+        /**
+         * @brief Обчислити статистику графа
+         * @param root коренева комірка (nullptr - порожня статистика)
+         * @return статистика
+         */
+        static CellGraphStats compute(const CellRef& root);
+    };
+
+    /**
+     * @brief Обмеження розміру повідомлення (кількість різних комірок, бітів і глибина)
+     */
+    struct CTON_SDK_CORE_API StorageLimits {
+        uint64_t maxCells;  // Найбільша кількість різних комірок
+        uint64_t maxBits;   // Найбільша сума бітів різних комірок
+        uint32_t maxDepth;  // Найбільша глибина (корінь без посилань - 0; UINT32_MAX - без обмеження)
+
+        /**
+         * @brief Конструктор без обмежень
+         */
+        StorageLimits();
+
+        /**
+         * @brief Конструктор
+         * @param maxCells найбільша кількість комірок
+         * @param maxBits найбільша кількість бітів
+         * @param maxDepth найбільша глибина
+         */
+        StorageLimits(uint64_t maxCells, uint64_t maxBits, uint32_t maxDepth);
+    };
+
+    /**
+     * @brief Розмір графа комірок для перевірки обмежень і оцінки комісії
+     *
+     * Якщо обмеження перевищено, підрахунок зупиняється і значення - нижні межі
+     */
+    struct CTON_SDK_CORE_API StorageStats {
+        uint64_t cells;      // Кількість різних комірок (за хешем представлення)
+        uint64_t bits;       // Сума бітів різних комірок
+        uint32_t maxDepth;   // Глибина кореня
+        bool limitExceeded;  // Перевищено одне з обмежень
+
+        StorageStats();
+    };
+
+    /**
+     * @brief Порахувати різні комірки, біти і глибину з раннім виходом
+     *
+     * Один обхід без серіалізації; комірки розрізняються за хешем представлення,
+     * як при серіалізації в BOC, тож однакові піддерева з різних об'єктів
+     * рахуються один раз. Кожна відвідана комірка хешується (кешований хеш).
+     * Обхід зупиняється, щойно кількість комірок чи бітів перевищує обмеження
+     * або знайдено шлях, довший за maxDepth
+     * @param root коренева комірка (nullptr - нульова статистика)
+     * @param limits обмеження
+     * @return статистика
+     */
+    CTON_SDK_CORE_API StorageStats computeStorageStats(const CellRef& root,
+                                                       const StorageLimits& limits = StorageLimits());
+
+}
+
+#endif // CTON_CELL_GRAPH_STATS_H
@@ -0,0 +1,119 @@
+// CellInterner.h - інтернування (hash-consing) комірок
+// Author: Андрій Будильников (Sparky)
+// Concurrent hash-consing table for cells
+// Потокобезопасная таблица интернирования ячеек
+
+#ifndef CTON_CELL_INTERNER_H
+#define CTON_CELL_INTERNER_H
+
+#include "Cell.h"
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+// Export definitions for Windows DLL
+#ifdef _WIN32
+    #ifdef CTON_SDK_CORE_EXPORTS
+        #define CTON_SDK_CORE_API __declspec(dllexport)
+    #else
+        #define CTON_SDK_CORE_API __declspec(dllimport)
+    #endif
+#else
+    #define CTON_SDK_CORE_API
+#endif
+
+namespace cton {
+
+    /**
+     * @brief Потокобезпечна таблиця інтернування комірок за хешем представлення
+     *
+     * Для кожного унікального вмісту зберігається одна канонічна комірка.
+     * Якщо всі комірки графа створюються через одну таблицю (знизу вгору),
+     * рівність вказівників еквівалентна структурній рівності.
+     * Таблиця розділена на сегменти з окремими м'ютексами (lock striping).
+     * Таблиця тримає канонічні комірки живими до clear() або purgeUnused()
+     */
+    class CTON_SDK_CORE_API CellInterner {
+    public:
+        static const size_t DEFAULT_STRIPES = 64;  // Кількість сегментів за замовчуванням
+
+        /**
+         * @brief Конструктор
+         * @param stripeCount кількість сегментів (округлюється до степеня двійки)
+         */
+        explicit CellInterner(size_t stripeCount = DEFAULT_STRIPES);
+
+        CellInterner(const CellInterner&) = delete;
+        CellInterner& operator=(const CellInterner&) = delete;
+
+        /**
+         * @brief Отримати канонічну комірку для наявної комірки
+         * @param cell комірка
+         * @return канонічна комірка (cell, якщо такого вмісту ще не було)
+         */
+        CellRef intern(const CellRef& cell);
+
+        /**
+         * @brief Отримати канонічну комірку для заданого вмісту
+         *
+         * Нова комірка створюється лише якщо такого вмісту ще немає в таблиці
+         * @param data бінарні дані
+         * @param bitSize розмір даних у бітах
+         * @param references масив посилань
+         * @param refCount кількість посилань
+         * @param isSpecial чи є комірка спеціальною
+         * @return канонічна комірка
+         */
+        CellRef intern(const uint8_t* data,
+                                     size_t bitSize,
+                                     const CellRef* references,
+                                     size_t refCount,
+                                     bool isSpecial = false);
+
+        /**
+         * @brief Отримати кількість канонічних комірок
+         * @return кількість комірок у таблиці
+         */
+        size_t size() const;
+
+        /**
+         * @brief Видалити комірки, на які ніхто, крім таблиці, не посилається
+         * @return кількість видалених комірок
+         */
+        size_t purgeUnused();
+
+        /**
+         * @brief Очистити таблицю
+         */
+        void clear();
+
+    private:
+        /**
+         * @brief Хешування ключа всередині сегмента
+         */
+        struct KeyHash {
+            size_t operator()(const Cell::Hash& hash) const;
+        };
+
+        struct Stripe {
+            mutable std::mutex mutex;
+            std::unordered_map<Cell::Hash, CellRef, KeyHash> cells;
+        };
+
+        std::vector<std::unique_ptr<Stripe>> stripes_;
+        size_t stripeMask_;
+
+        /**
+         * @brief Вибрати сегмент для хешу
+         * @param hash хеш представлення
+         * @return сегмент
+         */
+        Stripe& stripeFor(const Cell::Hash& hash);
+    };
+
+}
+
+#endif // CTON_CELL_INTERNER_H
@@ -0,0 +1,260 @@
+// CellSlice.h - читання комірки без копіювання
+// Author: Андрій Будильников (Sparky)
+// Zero-copy reader over cell bits and references
+// Чтение ячейки без копирования
+
+#ifndef CTON_CELL_SLICE_H
+#define CTON_CELL_SLICE_H
+
+#include "Cell.h"
+#include <vector>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// Export definitions for Windows DLL
+#ifdef _WIN32
+    #ifdef CTON_SDK_CORE_EXPORTS
+        #define CTON_SDK_CORE_API __declspec(dllexport)
+    #else
+        #define CTON_SDK_CORE_API __declspec(dllimport)
+    #endif
+#else
+    #define CTON_SDK_CORE_API
+#endif
+
+namespace cton {
+
+    /**
+     * @brief Зріз комірки для послідовного читання бітів і посилань
+     *
+     * Зріз читає дані безпосередньо з вбудованого буфера комірки (без копіювання)
+     * 64-бітними словами. Комірка має жити довше за зріз
+     */
+    class CTON_SDK_CORE_API CellSlice {
+    public:
+        /**
+         * @brief Конструктор за замовчуванням (порожній зріз)
+         */
+        CellSlice();
+
+        /**
+         * @brief Конструктор з комірки
+         * @param cell комірка для читання
+         */
+        explicit CellSlice(const Cell& cell);
+
+        /**
+         * @brief Прочитати беззнакове ціле
+         * @param bitCount кількість бітів (не більше 64)
+         * @return значення
+         */
+        uint64_t loadUInt(size_t bitCount);
+
+        /**
+         * @brief Прочитати знакове ціле (доповнення до двох)
+         * @param bitCount кількість бітів (не більше 64)
+         * @return значення
+         */
+        int64_t loadInt(size_t bitCount);
+
+        /**
+         * @brief Прочитати беззнакове ціле без зсуву позиції
+         * @param bitCount кількість бітів (не більше 64)
+         * @return значення
+         */
+        uint64_t preloadUInt(size_t bitCount) const;
+
+        /**
+         * @brief Прочитати знакове ціле без зсуву позиції
+         * @param bitCount кількість бітів (не більше 64)
+         * @return значення
+         */
+        int64_t preloadInt(size_t bitCount) const;
+
+        /**
+         * @brief Прочитати 256-бітне беззнакове ціле
+         * @param bitCount кількість бітів (не більше 256)
+         * @return значення
+         */
+        UInt256 loadUInt256(size_t bitCount);
+
+        /**
+         * @brief Прочитати VarUInteger n
+         * @param maxBytes n (від 1 до 33)
+         * @return значення
+         */
+        UInt256 loadVarUInt(size_t maxBytes);
+
+        /**
+         * @brief Прочитати суму монет (Coins = VarUInteger 16)
+         * @return сума в нанотонах
+         */
+        UInt256 loadCoins();
+
+        /**
+         * @brief Прочитати один біт
+         * @return значення біта
+         */
+        bool loadBit();
+
+        /**
+         * @brief Прочитати біти у зовнішній буфер
+         * @param out буфер щонайменше на (bitCount + 7) / 8 байтів; біти записуються
+         *            зі старшого, невикористані молодші біти останнього байта обнуляються
+         * @param bitCount кількість бітів
+         */
+        void loadBits(uint8_t* out, size_t bitCount);
+
+        /**
+         * @brief Прочитати байти
+         * @param byteCount кількість байтів
+         * @return вектор байтів
+         */
+        std::vector<uint8_t> loadBytes(size_t byteCount);
+
+        /**
+         * @brief Отримати довжину даних snake без читання
+         *
+         * Дані snake - непрочитані біти зрізу і ланцюжок комірок за першим
+         * непрочитаним посиланням (у кожній комірці - дані і посилання на наступну)
+         * @return кількість байтів
+         * @throws std::invalid_argument якщо дані не кратні байту або в ланцюжку є спеціальна комірка
+         */
+        size_t snakeLength() const;
+
+        /**
+         * @brief Прочитати дані snake у зовнішній буфер (біти і перше посилання зрізу вважаються прочитаними)
+         * @param out буфер щонайменше на snakeLength() байтів
+         * @return кількість прочитаних байтів
+         */
+        size_t loadSnakeBytes(uint8_t* out);
+
+        /**
+         * @brief Прочитати дані snake
+         * @return байти, зібрані в один буфер
+         */
+        std::vector<uint8_t> loadSnakeBytes();
+
+        /**
+         * @brief Прочитати рядок snake (байти UTF-8)
+         * @return рядок
+         */
+        std::string loadSnakeString();
+
+        /**
+         * @brief Прочитати наступне посилання
+         * @return посилання на комірку
+         */
+        const CellRef& loadRef();
+
+        /**
+         * @brief Отримати посилання без зсуву позиції
+         * @param index індекс серед залишених посилань
+         * @return посилання на комірку
+         */
+        const CellRef& preloadRef(size_t index = 0) const;
+
+        /**
+         * @brief Пропустити біти
+         * @param bitCount кількість бітів
+         */
+        void skip(size_t bitCount);
+
+        /**
+         * @brief Пропустити посилання
+         * @param refCount кількість посилань
+         */
+        void skipRefs(size_t refCount);
+
+        /**
+         * @brief Отримати кількість непрочитаних бітів
+         * @return кількість бітів
+         */
+        size_t remainingBits() const;
+
+        /**
+         * @brief Отримати кількість непрочитаних посилань
+         * @return кількість посилань
+         */
+        size_t remainingRefs() const;
+
+        /**
+         * @brief Перевірити чи прочитано все
+         * @return true якщо не залишилось ні бітів, ні посилань
+         */
+        bool empty() const;
+
+        /**
+         * @brief Отримати буфер даних комірки
+         * @return вказівник на вбудований буфер (позиція читання - getBitOffset())
+         */
+        const uint8_t* getData() const;
+
+        /**
+         * @brief Отримати поточну позицію читання в бітах
+         * @return зсув від початку даних комірки
+         */
+        size_t getBitOffset() const;
+
+        /**
+         * @brief Довжина спільного префікса непрочитаних бітів двох зрізів
+         * @param other інший зріз
+         * @return кількість однакових бітів від поточних позицій
+         */
+        size_t commonPrefix(const CellSlice& other) const;
+
+        /**
+         * @brief Довжина спільного префікса непрочитаних бітів і зовнішнього бітового рядка
+         * @param bits бітовий рядок
+         * @param bitOffset зсув у бітах у bits
+         * @param bitCount довжина рядка в бітах
+         * @return кількість однакових бітів від поточної позиції
+         */
+        size_t commonPrefix(const uint8_t* bits, size_t bitOffset, size_t bitCount) const;
+
+        /**
+         * @brief Перевірити чи непрочитані біти починаються з бітів іншого зрізу
+         * @param prefix зріз-префікс (його непрочитані біти)
+         */
+        bool startsWith(const CellSlice& prefix) const;
+
+        /**
+         * @brief Перевірити рівність непрочитаних бітів двох зрізів (посилання не порівнюються)
+         * @param other інший зріз
+         */
+        bool bitsEqual(const CellSlice& other) const;
+
+        /**
+         * @brief Лексикографічно порівняти непрочитані біти двох зрізів
+         * @param other інший зріз
+         * @return -1, 0 або 1 (префікс менший за довший рядок)
+         */
+        int compareBits(const CellSlice& other) const;
+
+        /**
+         * @brief Порахувати ведучі непрочитані біти, рівні bit
+         * @param bit значення біта
+         * @return кількість бітів до першого іншого або до кінця зрізу
+         */
+        size_t countLeading(bool bit) const;
+
+    private:
+        const Cell* cell_;
+        const uint8_t* data_;
+        size_t bitPos_;
+        size_t bitEnd_;
+        size_t refPos_;
+        size_t refEnd_;
+
+        /**
+         * @brief Перевірити чи вистачає бітів
+         * @param bitCount кількість бітів
+         */
+        void checkBits(size_t bitCount) const;
+    };
+
+}
+
+#endif // CTON_CELL_SLICE_H
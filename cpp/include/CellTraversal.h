@@ -0,0 +1,186 @@
+// CellTraversal.h - ітеративний обхід графа комірок
+// Author: Андрій Будильников (Sparky)
+// Iterative, stack-safe traversal of cell DAGs
+// Итеративный обход графа ячеек
+
+#ifndef CTON_CELL_TRAVERSAL_H
+#define CTON_CELL_TRAVERSAL_H
+
+#include "Cell.h"
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+// Export definitions for Windows DLL
+#ifdef _WIN32
+    #ifdef CTON_SDK_CORE_EXPORTS
+        #define CTON_SDK_CORE_API __declspec(dllexport)
+    #else
+        #define CTON_SDK_CORE_API __declspec(dllimport)
+    #endif
+#else
+    #define CTON_SDK_CORE_API
+#endif
+
+namespace cton {
+
+    /**
+     * @brief Множина відвіданих комірок з відкритою адресацією
+     *
+     * Один масив вказівників без виділення пам'яті на кожен запис;
+     * ключ - адреса комірки, тому хешування не торкається самої комірки
+     */
+    class CTON_SDK_CORE_API CellVisitedSet {
+    public:
+        /**
+         * @brief Конструктор
+         * @param expectedSize очікувана кількість комірок (для початкового розміру)
+         */
+        explicit CellVisitedSet(size_t expectedSize = 0);
+
+        /**
+         * @brief Додати комірку
+         * @param cell комірка
+         * @return true якщо комірки ще не було
+         */
+        bool insert(const Cell* cell);
+
+        /**
+         * @brief Перевірити чи комірка вже є в множині
+         * @param cell комірка
+         */
+        bool contains(const Cell* cell) const;
+
+        /**
+         * @brief Отримати кількість комірок
+         */
+        size_t size() const;
+
+        /**
+         * @brief Очистити множину (місткість зберігається)
+         */
+        void clear();
+
+    private:
+        std::vector<const Cell*> slots_;
+        size_t size_;
+
+        size_t probe(const Cell* cell) const;
+        void grow();
+    };
+
+    /**
+     * @brief Порядок видачі комірок при обході
+     */
+    enum class TraversalOrder : uint8_t {
+        PreOrder,   // Комірка перед дочірніми
+        PostOrder   // Комірка після дочірніх
+    };
+
+    /**
+     * @brief Ітеративний обхід графа комірок у глибину
+     *
+     * Використовує явний стек замість рекурсії, тому довгі ланцюжки посилань
+     * не переповнюють стек викликів. Посилання обходяться по порядку, тож
+     * послідовність комірок збігається з рекурсивним обходом. При вході в комірку
+     * дочірні комірки завантажуються в кеш наперед (software prefetch).
+     * Граф має жити, доки триває обхід: комірки не утримуються
+     */
+    class CTON_SDK_CORE_API CellTraversal {
+    public:
+        static const size_t UNLIMITED_DEPTH = ~static_cast<size_t>(0);
+
+        /**
+         * @brief Фільтр комірок: false - комірку і її піддерево пропустити
+         */
+        typedef bool (*Filter)(const Cell* cell);
+
+        /**
+         * @brief Почати обхід і перейти до першої комірки
+         * @param root коренева комірка (nullptr - порожній обхід)
+         * @param order порядок видачі комірок
+         * @param unique видавати кожну спільну комірку лише один раз
+         * @param maxDepth найбільша глибина (корінь - 0); глибші комірки не відвідуються.
+         *        З unique спільна комірка, пізніше досягнута на меншій глибині, обходиться
+         *        і видається знову, щоб не втратити відрізану раніше частину піддерева
+         * @param filter фільтр комірок (nullptr - усі комірки)
+         */
+        explicit CellTraversal(const Cell* root,
+                               TraversalOrder order = TraversalOrder::PostOrder,
+                               bool unique = true,
+                               size_t maxDepth = UNLIMITED_DEPTH,
+                               Filter filter = nullptr);
+
+        /**
+         * @brief Перевірити чи обхід вказує на комірку
+         */
+        bool valid() const;
+
+        /**
+         * @brief Перейти до наступної комірки
+         */
+        void next();
+
+        /**
+         * @brief Отримати поточну комірку
+         */
+        const Cell* cell() const;
+
+        /**
+         * @brief Отримати глибину поточної комірки (корінь - 0)
+         */
+        size_t depth() const;
+
+        /**
+         * @brief Не обходити дочірні комірки поточної (лише для PreOrder)
+         */
+        void skipChildren();
+
+        /**
+         * @brief Перевірити чи обхід зупинявся на maxDepth, маючи ще посилання
+         */
+        bool depthLimitReached() const;
+
+        /**
+         * @brief Отримати кількість різних відвіданих комірок (для unique, без повторних входів)
+         */
+        size_t visitedCount() const;
+
+        /**
+         * @brief Зібрати всі комірки графа в заданому порядку
+         * @param root коренева комірка
+         * @param order порядок
+         * @return комірки (кожна спільна - один раз)
+         */
+        static std::vector<const Cell*> collect(const Cell* root, TraversalOrder order = TraversalOrder::PostOrder);
+
+    private:
+        // Комірка на стеку; next - індекс наступного посилання для обходу
+        struct Frame {
+            const Cell* cell;
+            uint8_t next;
+        };
+
+        std::vector<Frame> stack_;
+        // Відвідані комірки (лише для unique без maxDepth)
+        CellVisitedSet visited_;
+        // Найменша глибина входу в комірку (лише для unique з maxDepth, замість visited_)
+        std::unordered_map<const Cell*, size_t> entryDepths_;
+        TraversalOrder order_;
+        bool unique_;
+        size_t maxDepth_;
+        Filter filter_;
+        const Cell* current_;
+        size_t currentDepth_;
+        bool depthLimitReached_;
+
+        /**
+         * @brief Покласти комірку на стек; true якщо її треба відвідати
+         */
+        bool enter(const Cell* cell);
+    };
+
+}
+
+#endif // CTON_CELL_TRAVERSAL_H
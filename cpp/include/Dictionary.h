@@ -0,0 +1,368 @@
+// Dictionary.h - словники TON (HashmapE)
+// Author: Андрій Будильников (Sparky)
+// Patricia-trie dictionaries stored in cells
+// Словари TON (HashmapE)
+
+#ifndef CTON_DICTIONARY_H
+#define CTON_DICTIONARY_H
+
+#include "Cell.h"
+#include "CellSlice.h"
+#include "Boc.h"
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+// Export definitions for Windows DLL
+#ifdef _WIN32
+    #ifdef CTON_SDK_CORE_EXPORTS
+        #define CTON_SDK_CORE_API __declspec(dllexport)
+    #else
+        #define CTON_SDK_CORE_API __declspec(dllimport)
+    #endif
+#else
+    #define CTON_SDK_CORE_API
+#endif
+
+namespace cton {
+
+    class Dictionary;
+
+    /**
+     * @brief Операції над додатковими даними (extra) вузлів HashmapAug
+     *
+     * Extra лежить одразу після мітки: у листі перед значенням, у розгалуженні
+     * це все, що є в бітах вузла. Посилання extra в розгалуженні йдуть після
+     * двох посилань на гілки. Реалізації не мають стану
+     */
+    class CTON_SDK_CORE_API AugmentationOps {
+    public:
+        virtual ~AugmentationOps() {}
+
+        /**
+         * @brief Записати extra порожнього словника
+         * @param builder будівельник
+         */
+        virtual void storeEmpty(CellBuilder& builder) const = 0;
+
+        /**
+         * @brief Записати extra розгалуження за extra лівої і правої гілок
+         * @param left зріз, позиціонований на extra лівої гілки
+         * @param right зріз, позиціонований на extra правої гілки
+         * @param builder будівельник
+         */
+        virtual void combine(CellSlice& left, CellSlice& right, CellBuilder& builder) const = 0;
+
+        /**
+         * @brief Пропустити extra
+         * @param slice зріз, позиціонований на extra
+         */
+        virtual void skip(CellSlice& slice) const = 0;
+    };
+
+    /**
+     * @brief Ітератор по записах словника в порядку зростання або спадання ключів
+     *
+     * Тримає стек непройдених піддерев, тому обходить лише ті вузли, які
+     * потрібні для наступного запису. Зріз значення дійсний, доки живе словник
+     */
+    class CTON_SDK_CORE_API DictionaryIterator {
+    public:
+        /**
+         * @brief Конструктор за замовчуванням (вичерпаний ітератор)
+         */
+        DictionaryIterator();
+
+        /**
+         * @brief Перевірити чи ітератор вказує на запис
+         */
+        bool valid() const;
+
+        /**
+         * @brief Перейти до наступного запису
+         */
+        void next();
+
+        /**
+         * @brief Отримати ключ поточного запису
+         * @return keyBytes() байтів ключа
+         */
+        const uint8_t* key() const;
+
+        /**
+         * @brief Отримати ключ поточного запису як ціле (для ключів до 64 бітів)
+         * @return значення ключа
+         */
+        uint64_t keyUInt() const;
+
+        /**
+         * @brief Отримати значення поточного запису
+         * @return зріз значення в листовій комірці
+         */
+        const CellSlice& value() const;
+
+    private:
+        friend class Dictionary;
+
+        // Піддерево, яке ще треба обійти: мітка вузла починається з біта pos,
+        // а біт pos - 1 ключа дорівнює bit (-1 для кореня)
+        struct Frame {
+            const Cell* cell;
+            size_t index;
+            size_t pos;
+            int bit;
+        };
+
+        CellRef root_;
+        std::shared_ptr<const BocView> boc_;
+        size_t keyBits_;
+        bool reverse_;
+        std::vector<Frame> stack_;
+        std::vector<uint8_t> key_;
+        CellSlice value_;
+        bool valid_;
+        Cell scratch_;
+
+        void advance();
+        void seek(const uint8_t* key);
+    };
+
+    /**
+     * @brief Словник з ключами фіксованої довжини (HashmapE n X)
+     *
+     * Ключі - бітові рядки довжини keyBits, записані від старшого біта першого байта
+     * (keyBytes() байтів на ключ). Значення - вміст комірки (біти і посилання),
+     * який вбудовується в листову комірку після мітки
+     */
+    class CTON_SDK_CORE_API Dictionary {
+    public:
+        /**
+         * @brief Створити порожній словник
+         * @param keyBits довжина ключа в бітах (від 1 до Cell::MAX_BITS)
+         */
+        explicit Dictionary(size_t keyBits);
+
+        /**
+         * @brief Створити словник з кореня Hashmap
+         * @param keyBits довжина ключа в бітах
+         * @param root коренева комірка (nullptr - порожній словник)
+         */
+        Dictionary(size_t keyBits, CellRef root);
+
+        /**
+         * @brief Створити доповнений словник (HashmapAugE) з кореня
+         *
+         * Листові значення починаються з extra; розгалуження, створені
+         * build/set/erase, отримують extra з augmentation->combine
+         * @param keyBits довжина ключа в бітах
+         * @param root коренева комірка (nullptr - порожній словник)
+         * @param augmentation операції над extra (nullptr - звичайний HashmapE)
+         */
+        Dictionary(size_t keyBits, CellRef root, const AugmentationOps* augmentation);
+
+        /**
+         * @brief Створити словник над індексованим BOC без його матеріалізації
+         *
+         * Пошук і ітерація читають лише комірки на пройдених шляхах
+         * @param boc серіалізований BOC
+         * @param rootIndex номер кореневої комірки Hashmap у BOC
+         * @param keyBits довжина ключа в бітах
+         * @return словник
+         */
+        static Dictionary fromBoc(std::shared_ptr<const BocView> boc, size_t rootIndex, size_t keyBits);
+
+        /**
+         * @brief Побудувати словник з відсортованих ключів за один прохід
+         * @param keyBits довжина ключа в бітах
+         * @param keys ключі, упаковані по keyBytes() байтів, строго за зростанням
+         * @param values значення (по одному на ключ)
+         * @param count кількість ключів
+         * @param augmentation операції над extra для HashmapAugE (значення починаються з extra)
+         * @return словник
+         */
+        static Dictionary build(size_t keyBits, const uint8_t* keys, const CellRef* values, size_t count,
+                                const AugmentationOps* augmentation = nullptr);
+
+        /**
+         * @brief Побудувати словник з ключами до 64 бітів
+         * @param keyBits довжина ключа в бітах (не більше 64)
+         * @param entries пари ключ-значення, строго за зростанням ключів
+         * @return словник
+         */
+        static Dictionary build(size_t keyBits, const std::vector<std::pair<uint64_t, CellRef>>& entries);
+
+        /**
+         * @brief Прочитати HashmapE зі зрізу (біт наявності і посилання на корінь)
+         * @param slice зріз
+         * @param keyBits довжина ключа в бітах
+         * @param augmentation операції над extra для HashmapAugE (extra кореня пропускається)
+         * @return словник
+         */
+        static Dictionary load(CellSlice& slice, size_t keyBits, const AugmentationOps* augmentation = nullptr);
+
+        /**
+         * @brief Записати HashmapE (або HashmapAugE з extra кореня) в будівельник
+         * @param builder будівельник
+         */
+        void store(CellBuilder& builder) const;
+
+        /**
+         * @brief Знайти значення за ключем
+         * @param key ключ (keyBytes() байтів)
+         * @param value зріз значення в листовій комірці
+         * @return true якщо ключ знайдено
+         */
+        bool get(const uint8_t* key, CellSlice& value) const;
+
+        /**
+         * @brief Знайти значення за ключем до 64 бітів
+         * @param key ключ
+         * @param value зріз значення в листовій комірці
+         * @return true якщо ключ знайдено
+         */
+        bool get(uint64_t key, CellSlice& value) const;
+
+        /**
+         * @brief Записати значення за ключем
+         *
+         * Нові комірки створюються лише на шляху від кореня до листа, решта
+         * піддерев спільні зі старим коренем; раніше зроблені копії словника не змінюються
+         * @param key ключ (keyBytes() байтів)
+         * @param value значення (вбудовується в листову комірку; для HashmapAugE починається з extra)
+         */
+        void set(const uint8_t* key, const CellRef& value);
+
+        /**
+         * @brief Записати значення за ключем до 64 бітів
+         * @param key ключ
+         * @param value значення
+         */
+        void set(uint64_t key, const CellRef& value);
+
+        /**
+         * @brief Видалити ключ (з копіюванням лише шляху до нього)
+         * @param key ключ (keyBytes() байтів)
+         * @return true якщо ключ був у словнику
+         */
+        bool erase(const uint8_t* key);
+
+        /**
+         * @brief Видалити ключ до 64 бітів
+         * @param key ключ
+         * @return true якщо ключ був у словнику
+         */
+        bool erase(uint64_t key);
+
+        /**
+         * @brief Знайти найменший ключ, не менший за заданий
+         * @param key ключ (keyBytes() байтів)
+         * @param foundKey буфер на keyBytes() байтів для знайденого ключа
+         * @param value зріз значення в листовій комірці
+         * @return true якщо такий ключ є
+         */
+        bool lowerBound(const uint8_t* key, uint8_t* foundKey, CellSlice& value) const;
+
+        /**
+         * @brief Ітератор з найменшого (або найбільшого) ключа
+         * @param reverse обхід у порядку спадання
+         * @return ітератор
+         */
+        DictionaryIterator begin(bool reverse = false) const;
+
+        /**
+         * @brief Ітератор з першого ключа не меншого (для reverse - не більшого) за заданий
+         * @param key ключ (keyBytes() байтів)
+         * @param reverse обхід у порядку спадання
+         * @return ітератор
+         */
+        DictionaryIterator seek(const uint8_t* key, bool reverse = false) const;
+
+        /**
+         * @brief Отримати кореневу комірку Hashmap
+         *
+         * Для словника над BOC матеріалізує все дерево
+         * @return корінь (nullptr для порожнього словника)
+         */
+        CellRef getRoot() const;
+
+        /**
+         * @brief Отримати довжину ключа
+         * @return довжина в бітах
+         */
+        size_t getKeyBits() const;
+
+        /**
+         * @brief Кількість байтів упакованого ключа
+         * @return (keyBits + 7) / 8
+         */
+        size_t keyBytes() const;
+
+        /**
+         * @brief Перевірити чи словник порожній
+         */
+        bool empty() const;
+
+        /**
+         * @brief Упакувати ключ до 64 бітів у формат ключа словника
+         * @param keyBits довжина ключа в бітах (не більше 64)
+         * @param key значення ключа
+         * @param out буфер на 8 байтів
+         */
+        static void packKey(size_t keyBits, uint64_t key, uint8_t* out);
+
+        /**
+         * @brief Записати мітку ребра найкоротшим з кодувань hml_short/hml_long/hml_same
+         * @param builder будівельник
+         * @param bits біти мітки
+         * @param bitOffset зсув мітки в bits
+         * @param length довжина мітки
+         * @param maxLength довжина залишку ключа в цьому вузлі
+         */
+        static void storeLabel(CellBuilder& builder, const uint8_t* bits, size_t bitOffset,
+                               size_t length, size_t maxLength);
+
+        /**
+         * @brief Прочитати мітку ребра
+         * @param slice зріз, позиціонований на мітці
+         * @param maxLength довжина залишку ключа в цьому вузлі
+         * @param out буфер щонайменше на (maxLength + 7) / 8 байтів; біти мітки
+         *            записуються з бітового зсуву outOffset
+         * @param outOffset зсув запису в out
+         * @return довжина мітки
+         */
+        static size_t loadLabel(CellSlice& slice, size_t maxLength, uint8_t* out, size_t outOffset);
+
+        /**
+         * @brief Позиціонувати зріз вузла HashmapAug на extra
+         *
+         * Пропускає мітку, а в розгалуженні ще й посилання на дві гілки
+         * @param slice зріз, позиціонований на мітці
+         * @param maxLength довжина залишку ключа в цьому вузлі
+         */
+        static void skipToExtra(CellSlice& slice, size_t maxLength);
+
+    private:
+        size_t keyBits_;
+        CellRef root_;
+        std::shared_ptr<const BocView> boc_;
+        size_t rootIndex_;
+        const AugmentationOps* augmentation_;
+
+        static void checkKeyBits(size_t keyBits);
+
+        /**
+         * @brief Матеріалізувати словник над BOC перед зміною
+         */
+        void detachBoc();
+
+        /**
+         * @brief Створити ітератор, що починається з кореня
+         */
+        DictionaryIterator makeIterator(bool reverse) const;
+    };
+
+}
+
+#endif // CTON_DICTIONARY_H
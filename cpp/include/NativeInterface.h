@@ -29,11 +29,16 @@ extern "C" {
     CTON_SDK_CORE_API bool cell_store_uint(void* cell, int bits, uint64_t value);
     CTON_SDK_CORE_API bool cell_store_int(void* cell, int bits, int64_t value);
     CTON_SDK_CORE_API bool cell_store_bytes(void* cell, const uint8_t* data, int length);
+    CTON_SDK_CORE_API bool cell_store_coins(void* cell, const uint8_t* amount, int length);  // big-endian amount
     CTON_SDK_CORE_API bool cell_store_ref(void* cell, void* refCell);
     CTON_SDK_CORE_API int cell_get_data(void* cell, uint8_t* buffer, int bufferSize);
     CTON_SDK_CORE_API int cell_get_bit_size(void* cell);
     CTON_SDK_CORE_API int cell_get_refs_count(void* cell);
     CTON_SDK_CORE_API void* cell_get_ref(void* cell, int index);
+    // Snake: data fills the cell, the rest is chained through the first reference (fails if the cell already has references)
+    CTON_SDK_CORE_API bool cell_store_snake_bytes(void* cell, const uint8_t* data, int length);
+    // Returns the snake length; copies only if bufferSize is large enough (buffer may be null to query)
+    CTON_SDK_CORE_API int cell_load_snake_bytes(void* cell, uint8_t* buffer, int bufferSize);
 
     // Address functions
     CTON_SDK_CORE_API void* address_create();
@@ -0,0 +1,114 @@
+// Sha256.h - SHA-256 для хешування комірок
+// Author: Андрій Будильников (Sparky)
+// SHA-256 used for cell representation hashes
+// SHA-256 для хеширования ячеек
+
+#ifndef CTON_SHA256_H
+#define CTON_SHA256_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Export definitions for Windows DLL
+#ifdef _WIN32
+    #ifdef CTON_SDK_CORE_EXPORTS
+        #define CTON_SDK_CORE_API __declspec(dllexport)
+    #else
+        #define CTON_SDK_CORE_API __declspec(dllimport)
+    #endif
+#else
+    #define CTON_SDK_CORE_API
+#endif
+
+namespace cton {
+
+    /**
+     * @brief Потокова реалізація SHA-256 (FIPS 180-4)
+     *
+     * Не залежить від OpenSSL, тому хеші комірок доступні в будь-якій збірці
+     */
+    class CTON_SDK_CORE_API Sha256 {
+    public:
+        static const size_t DIGEST_SIZE = 32;  // Розмір хешу в байтах
+        static const size_t BLOCK_SIZE = 64;   // Розмір блоку в байтах
+
+        /**
+         * @brief Конструктор за замовчуванням
+         */
+        Sha256();
+
+        /**
+         * @brief Додати дані до хешу
+         * @param data вказівник на дані
+         * @param size розмір даних у байтах
+         */
+        void update(const uint8_t* data, size_t size);
+
+        /**
+         * @brief Завершити обчислення
+         * @param digest буфер для результату (DIGEST_SIZE байтів)
+         */
+        void finalize(uint8_t* digest);
+
+        /**
+         * @brief Обчислити хеш одним викликом
+         * @param data вказівник на дані
+         * @param size розмір даних у байтах
+         * @param digest буфер для результату (DIGEST_SIZE байтів)
+         */
+        static void hash(const uint8_t* data, size_t size, uint8_t* digest);
+
+        /**
+         * @brief Обчислити хеш вектора байтів
+         * @param data дані
+         * @return хеш (32 байти)
+         */
+        static std::vector<uint8_t> hash(const std::vector<uint8_t>& data);
+
+        /**
+         * @brief Обчислити хеші кількох незалежних повідомлень
+         *
+         * Повідомлення групуються за кількістю блоків і стискаються по кілька
+         * одночасно векторним ядром (AVX2 - 8, SSE2 - 4), вибраним при завантаженні бібліотеки.
+         * Групування - у межах вікон по 64 повідомлення, без виділення пам'яті
+         * @param messages вказівники на повідомлення
+         * @param sizes розміри повідомлень у байтах
+         * @param digests буфери для результатів (по DIGEST_SIZE байтів)
+         * @param count кількість повідомлень
+         */
+        static void hashBatch(const uint8_t* const* messages, const size_t* sizes,
+                              uint8_t* const* digests, size_t count);
+
+        /**
+         * @brief Кількість повідомлень, які hashBatch стискає одночасно
+         * @return 8, 4 або 1 (без векторного ядра)
+         */
+        static size_t batchLanes();
+
+        /**
+         * @brief Перевірити чи одиночні хеші обчислюються інструкціями SHA-NI
+         *
+         * Ядро вибирається за cpuid один раз при завантаженні бібліотеки
+         * @return true якщо процесор підтримує розширення SHA
+         */
+        static bool hardwareAccelerated();
+
+    private:
+        uint32_t state_[8];
+        uint8_t buffer_[BLOCK_SIZE];
+        size_t bufferSize_;
+        uint64_t totalSize_;
+
+        /**
+         * @brief Обробити послідовність повних блоків
+         * @param state стан хешу
+         * @param blocks дані блоків
+         * @param blockCount кількість блоків
+         */
+        static void compress(uint32_t* state, const uint8_t* blocks, size_t blockCount);
+    };
+
+}
+
+#endif // CTON_SHA256_H
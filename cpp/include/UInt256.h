@@ -0,0 +1,148 @@
+// UInt256.h - 256-бітне беззнакове ціле
+// Author: Андрій Будильников (Sparky)
+// Fixed-width 256-bit unsigned integer for coins, hashes and wide cell fields
+// 256-битное беззнаковое целое
+
+#ifndef CTON_UINT256_H
+#define CTON_UINT256_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// Export definitions for Windows DLL
+#ifdef _WIN32
+    #ifdef CTON_SDK_CORE_EXPORTS
+        #define CTON_SDK_CORE_API __declspec(dllexport)
+    #else
+        #define CTON_SDK_CORE_API __declspec(dllimport)
+    #endif
+#else
+    #define CTON_SDK_CORE_API
+#endif
+
+namespace cton {
+
+    /**
+     * @brief 256-бітне беззнакове ціле з чотирьох 64-бітних слів
+     *
+     * Слово 0 - старше, що відповідає порядку бітів у комірці
+     */
+    class CTON_SDK_CORE_API UInt256 {
+    public:
+        static const size_t WORDS = 4;   // Кількість 64-бітних слів
+        static const size_t BYTES = 32;  // Розмір у байтах
+        static const size_t BITS = 256;  // Розмір у бітах
+
+        /**
+         * @brief Конструктор за замовчуванням (нуль)
+         */
+        UInt256();
+
+        /**
+         * @brief Конструктор з 64-бітного значення
+         * @param value значення
+         */
+        UInt256(uint64_t value);
+
+        /**
+         * @brief Конструктор зі слів, від старшого до молодшого
+         */
+        UInt256(uint64_t word0, uint64_t word1, uint64_t word2, uint64_t word3);
+
+        /**
+         * @brief Створити з байтів big-endian
+         * @param data байти
+         * @param size кількість байтів (не більше 32)
+         * @return значення
+         */
+        static UInt256 fromBytes(const uint8_t* data, size_t size);
+
+        /**
+         * @brief Створити з десяткового рядка
+         * @param decimal рядок з цифр
+         * @return значення
+         */
+        static UInt256 fromString(const std::string& decimal);
+
+        /**
+         * @brief Записати молодші байти big-endian
+         * @param out буфер на size байтів
+         * @param size кількість байтів (значення має вміщатися)
+         */
+        void toBytes(uint8_t* out, size_t size = BYTES) const;
+
+        /**
+         * @brief Отримати десятковий запис
+         * @return рядок з цифр
+         */
+        std::string toString() const;
+
+        /**
+         * @brief Отримати слово
+         * @param index номер слова (0 - старше)
+         * @return слово
+         */
+        uint64_t word(size_t index) const { return words_[index]; }
+
+        /**
+         * @brief Отримати значення як 64-бітне ціле
+         * @return значення (кидає overflow_error, якщо не вміщається)
+         */
+        uint64_t toUInt64() const;
+
+        /**
+         * @brief Кількість значущих бітів
+         * @return 0 для нуля
+         */
+        size_t bitLength() const;
+
+        /**
+         * @brief Кількість значущих байтів
+         * @return 0 для нуля
+         */
+        size_t byteLength() const { return (bitLength() + 7) / 8; }
+
+        /**
+         * @brief Перевірити чи значення нульове
+         */
+        bool isZero() const;
+
+        /**
+         * @brief Кількість бітів поля довжини VarUInteger n (#< n)
+         * @param maxBytes n (від 1 до 33)
+         * @return ceil(log2(n))
+         */
+        static unsigned varUIntLengthBits(size_t maxBytes);
+
+        UInt256& operator+=(const UInt256& other);
+        UInt256& operator-=(const UInt256& other);
+
+        friend CTON_SDK_CORE_API bool operator==(const UInt256& a, const UInt256& b);
+        friend CTON_SDK_CORE_API bool operator<(const UInt256& a, const UInt256& b);
+
+    private:
+        uint64_t words_[WORDS];
+    };
+
+    /**
+     * @brief Сума (кидає overflow_error при переповненні)
+     */
+    CTON_SDK_CORE_API UInt256 operator+(UInt256 a, const UInt256& b);
+
+    /**
+     * @brief Різниця (кидає overflow_error, якщо b > a)
+     */
+    CTON_SDK_CORE_API UInt256 operator-(UInt256 a, const UInt256& b);
+
+    CTON_SDK_CORE_API bool operator==(const UInt256& a, const UInt256& b);
+    CTON_SDK_CORE_API bool operator<(const UInt256& a, const UInt256& b);
+
+    inline bool operator!=(const UInt256& a, const UInt256& b) { return !(a == b); }
+    inline bool operator>(const UInt256& a, const UInt256& b) { return b < a; }
+    inline bool operator<=(const UInt256& a, const UInt256& b) { return !(b < a); }
+    inline bool operator>=(const UInt256& a, const UInt256& b) { return !(a < b); }
+
+}
+
+#endif // CTON_UINT256_H
@@ -0,0 +1,431 @@
+// BitString.cpp - реалізація операцій з бітовими рядками
+// Author: Андрій Будильников (Sparky)
+// Word-level and SIMD helpers for big-endian bit strings
+// Низкоуровневые операции с битовыми строками
+
+#include "../include/BitString.h"
+#include "../include/UInt256.h"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define CTON_BITSTRING_X86 1
+    #include <emmintrin.h>
+    #if defined(__GNUC__) || defined(__clang__)
+        #define CTON_BITSTRING_AVX2 1
+        #include <immintrin.h>
+    #endif
+#endif
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+namespace cton {
+
+    namespace {
+        typedef size_t (*FunnelKernel)(uint8_t* out, const uint8_t* in, size_t count, unsigned shift);
+        typedef size_t (*EqualBytesKernel)(const uint8_t* a, const uint8_t* b, size_t count);
+
+        /**
+         * @brief Кількість ведучих нулів ненульового слова
+         */
+        inline unsigned leadingZeros64(uint64_t value) {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanReverse64(&index, value);
+            return 63 - static_cast<unsigned>(index);
+#else
+            return static_cast<unsigned>(__builtin_clzll(value));
+#endif
+        }
+
+        inline unsigned trailingZeros32(uint32_t value) {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward(&index, value);
+            return static_cast<unsigned>(index);
+#else
+            return static_cast<unsigned>(__builtin_ctz(value));
+#endif
+        }
+
+        /**
+         * @brief Прочитати 64 біти з довільної позиції, вирівняні по старшому розряду
+         *
+         * Читаються лише байти до endByte; відсутні байти вважаються нульовими
+         */
+        inline uint64_t loadBitsAt(const uint8_t* data, size_t bitPos, size_t endByte) {
+            size_t byteIndex = bitPos / 8;
+            unsigned shift = static_cast<unsigned>(bitPos % 8);
+            const uint8_t* bytes = data + byteIndex;
+            uint8_t padded[9];
+            if (byteIndex + 9 > endByte) {
+                size_t available = endByte - byteIndex;
+                std::memset(padded, 0, sizeof(padded));
+                std::memcpy(padded, bytes, available < sizeof(padded) ? available : sizeof(padded));
+                bytes = padded;
+            }
+            uint64_t word = BitString::loadWord(bytes) << shift;
+            if (shift != 0) {
+                word |= static_cast<uint64_t>(bytes[8]) >> (8 - shift);
+            }
+            return word;
+        }
+
+        /**
+         * @brief Скалярне ядро: 8 байтів за крок
+         * @return індекс першого різного 8-байтного блоку (або кінця цілих блоків)
+         */
+        size_t equalBytesScalar(const uint8_t* a, const uint8_t* b, size_t count) {
+            size_t k = 0;
+            for (; k + 8 <= count; k += 8) {
+                if (BitString::loadWord(a + k) != BitString::loadWord(b + k)) {
+                    break;
+                }
+            }
+            return k;
+        }
+
+        /**
+         * @brief Скалярне ядро: 8 байтів за крок через 64-бітне слово
+         * @return кількість оброблених байтів
+         */
+        size_t funnelShiftScalar(uint8_t* out, const uint8_t* in, size_t count, unsigned shift) {
+            size_t k = 0;
+            // Читаються байти in[k..k+8]
+            for (; k + 8 <= count; k += 8) {
+                uint64_t word = BitString::loadWord(in + k);
+                BitString::storeWord(out + k, (word << shift) | (in[k + 8] >> (8 - shift)));
+            }
+            return k;
+        }
+
+#ifdef CTON_BITSTRING_X86
+        /**
+         * @brief SSE2: 16 байтів за крок; 16-бітні зсуви з масками відсікають біти сусідніх байтів
+         */
+        size_t funnelShiftSse2(uint8_t* out, const uint8_t* in, size_t count, unsigned shift) {
+            const __m128i leftCount = _mm_cvtsi32_si128(static_cast<int>(shift));
+            const __m128i rightCount = _mm_cvtsi32_si128(static_cast<int>(8 - shift));
+            const __m128i highMask = _mm_set1_epi8(static_cast<char>(0xFF << shift));
+            const __m128i lowMask = _mm_set1_epi8(static_cast<char>(0xFF >> (8 - shift)));
+
+            size_t k = 0;
+            for (; k + 16 <= count; k += 16) {
+                __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + k));
+                __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + k + 1));
+                __m128i high = _mm_and_si128(_mm_sll_epi16(current, leftCount), highMask);
+                __m128i low = _mm_and_si128(_mm_srl_epi16(next, rightCount), lowMask);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + k), _mm_or_si128(high, low));
+            }
+            return k;
+        }
+#endif
+
+#ifdef CTON_BITSTRING_AVX2
+        /**
+         * @brief AVX2: 32 байти за крок
+         */
+        __attribute__((target("avx2")))
+        size_t funnelShiftAvx2(uint8_t* out, const uint8_t* in, size_t count, unsigned shift) {
+            const __m128i leftCount = _mm_cvtsi32_si128(static_cast<int>(shift));
+            const __m128i rightCount = _mm_cvtsi32_si128(static_cast<int>(8 - shift));
+            const __m256i highMask = _mm256_set1_epi8(static_cast<char>(0xFF << shift));
+            const __m256i lowMask = _mm256_set1_epi8(static_cast<char>(0xFF >> (8 - shift)));
+
+            size_t k = 0;
+            for (; k + 32 <= count; k += 32) {
+                __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + k));
+                __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + k + 1));
+                __m256i high = _mm256_and_si256(_mm256_sll_epi16(current, leftCount), highMask);
+                __m256i low = _mm256_and_si256(_mm256_srl_epi16(next, rightCount), lowMask);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + k), _mm256_or_si256(high, low));
+            }
+            return k;
+        }
+#endif
+
+#ifdef CTON_BITSTRING_X86
+        /**
+         * @brief SSE2: 16 байтів за крок, перший різний байт - з маски порівняння
+         */
+        size_t equalBytesSse2(const uint8_t* a, const uint8_t* b, size_t count) {
+            size_t k = 0;
+            for (; k + 16 <= count; k += 16) {
+                __m128i left = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + k));
+                __m128i right = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + k));
+                uint32_t equalMask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(left, right)));
+                if (equalMask != 0xFFFF) {
+                    return k + trailingZeros32(~equalMask);
+                }
+            }
+            return k;
+        }
+#endif
+
+#ifdef CTON_BITSTRING_AVX2
+        /**
+         * @brief AVX2: 32 байти за крок
+         */
+        __attribute__((target("avx2")))
+        size_t equalBytesAvx2(const uint8_t* a, const uint8_t* b, size_t count) {
+            size_t k = 0;
+            for (; k + 32 <= count; k += 32) {
+                __m256i left = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + k));
+                __m256i right = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + k));
+                uint32_t equalMask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(left, right)));
+                if (equalMask != 0xFFFFFFFFu) {
+                    return k + trailingZeros32(~equalMask);
+                }
+            }
+            return k;
+        }
+#endif
+
+        /**
+         * @brief Вибрати найширше ядро порівняння байтів
+         */
+        EqualBytesKernel selectEqualBytesKernel() {
+#ifdef CTON_BITSTRING_AVX2
+            if (__builtin_cpu_supports("avx2")) {
+                return equalBytesAvx2;
+            }
+#endif
+#ifdef CTON_BITSTRING_X86
+            return equalBytesSse2;
+#else
+            return equalBytesScalar;
+#endif
+        }
+
+        /**
+         * @brief Вибрати найширше ядро, яке підтримує процесор (один раз)
+         */
+        FunnelKernel selectKernel() {
+#ifdef CTON_BITSTRING_AVX2
+            if (__builtin_cpu_supports("avx2")) {
+                return funnelShiftAvx2;
+            }
+#endif
+#ifdef CTON_BITSTRING_X86
+            return funnelShiftSse2;
+#else
+            return funnelShiftScalar;
+#endif
+        }
+    }
+
+    void BitString::writeWord(uint8_t* buffer, size_t bufferSize, size_t bitOffset, uint64_t word, size_t bits) {
+        // Одне читання-запис 64-бітного слова big-endian замість побайтового циклу
+        size_t byteIndex = bitOffset / 8;
+        size_t shift = bitOffset % 8;
+        uint64_t head = word >> shift;
+
+        if (byteIndex + 8 <= bufferSize) {
+            storeWord(buffer + byteIndex, loadWord(buffer + byteIndex) | head);
+        } else {
+            // Хвіст буфера: записуються лише наявні байти (біти за межею завжди нульові)
+            for (size_t i = 0; byteIndex + i < bufferSize; ++i) {
+                buffer[byteIndex + i] |= static_cast<uint8_t>(head >> (56 - 8 * i));
+            }
+        }
+
+        if (shift + bits > 64) {
+            // Молодші shift бітів слова переходять у дев'ятий байт
+            buffer[byteIndex + 8] = static_cast<uint8_t>(word << (8 - shift));
+        }
+    }
+
+    void BitString::writeUInt(uint8_t* buffer, size_t bufferSize, size_t bitOffset, size_t bits, uint64_t value) {
+        // Ведучі нулі вже є в буфері
+        if (bits > 64) {
+            bitOffset += bits - 64;
+            bits = 64;
+        }
+        writeWord(buffer, bufferSize, bitOffset, value << (64 - bits), bits);
+    }
+
+    void BitString::writeInt(uint8_t* buffer, size_t bufferSize, size_t bitOffset, size_t bits, int64_t value) {
+        if (bits > 64 && value < 0) {
+            // Розширення знака: ведучі біти - одиниці
+            size_t padding = bits - 64;
+            while (padding > 0) {
+                size_t chunk = padding < 64 ? padding : 64;
+                writeWord(buffer, bufferSize, bitOffset, ~0ULL << (64 - chunk), chunk);
+                bitOffset += chunk;
+                padding -= chunk;
+            }
+            bits = 64;
+        }
+        // Для від'ємних чисел використовуємо two's complement
+        writeUInt(buffer, bufferSize, bitOffset, bits, static_cast<uint64_t>(value));
+    }
+
+    void BitString::writeUInt256(uint8_t* buffer, size_t bufferSize, size_t bitOffset, size_t bits, const UInt256& value) {
+        // Неповне старше слово, далі - повні слова без проміжних буферів
+        size_t wordCount = (bits + 63) / 64;
+        size_t firstBits = bits - 64 * (wordCount - 1);
+        size_t index = UInt256::WORDS - wordCount;
+        writeUInt(buffer, bufferSize, bitOffset, firstBits, value.word(index));
+        bitOffset += firstBits;
+        for (++index; index < UInt256::WORDS; ++index) {
+            writeWord(buffer, bufferSize, bitOffset, value.word(index), 64);
+            bitOffset += 64;
+        }
+    }
+
+    void BitString::funnelShift(uint8_t* out, const uint8_t* in, size_t count, unsigned shift) {
+        static const FunnelKernel kernel = selectKernel();
+
+        size_t k = 0;
+        if (count >= 16) {
+            k = kernel(out, in, count, shift);
+        }
+        k += funnelShiftScalar(out + k, in + k, count - k, shift);
+        for (; k < count; ++k) {
+            out[k] = static_cast<uint8_t>((in[k] << shift) | (in[k + 1] >> (8 - shift)));
+        }
+    }
+
+    void BitString::copyBits(uint8_t* dst, size_t dstOffset, const uint8_t* src, size_t srcOffset, size_t bitCount) {
+        if (bitCount == 0) {
+            return;
+        }
+
+        dst += dstOffset / 8;
+        src += srcOffset / 8;
+        unsigned dstShift = static_cast<unsigned>(dstOffset % 8);
+        unsigned srcShift = static_cast<unsigned>(srcOffset % 8);
+        size_t srcBytes = (srcShift + bitCount + 7) / 8;
+        size_t dstBytes = (dstShift + bitCount + 7) / 8;
+        uint8_t firstByte = dst[0];
+
+        if (srcShift == dstShift) {
+            std::memcpy(dst, src, dstBytes);
+        } else if (srcShift > dstShift) {
+            // Зсув вліво: dst[k] = src[k] << r | src[k + 1] >> (8 - r)
+            unsigned shift = srcShift - dstShift;
+            size_t safe = dstBytes < srcBytes ? dstBytes : srcBytes - 1;
+            funnelShift(dst, src, safe, shift);
+            if (safe < dstBytes) {
+                dst[safe] = static_cast<uint8_t>(src[safe] << shift);
+            }
+        } else {
+            // Зсув вправо: перед джерелом уявний нульовий байт
+            unsigned shift = 8 - (dstShift - srcShift);
+            dst[0] = static_cast<uint8_t>(src[0] >> (8 - shift));
+            size_t rest = dstBytes - 1;
+            size_t safe = rest < srcBytes - 1 ? rest : srcBytes - 1;
+            funnelShift(dst + 1, src, safe, shift);
+            if (safe < rest) {
+                dst[1 + safe] = static_cast<uint8_t>(src[safe] << shift);
+            }
+        }
+
+        // Біти першого байта до dstOffset - від старого значення
+        uint8_t keepMask = static_cast<uint8_t>(0xFF << (8 - dstShift));
+        dst[0] = static_cast<uint8_t>((firstByte & keepMask) | (dst[0] & ~keepMask));
+
+        // Біти після скопійованих обнуляються
+        size_t tailBits = (dstShift + bitCount) % 8;
+        if (tailBits != 0) {
+            dst[dstBytes - 1] &= static_cast<uint8_t>(0xFF << (8 - tailBits));
+        }
+    }
+
+    size_t BitString::equalBytes(const uint8_t* a, const uint8_t* b, size_t count) {
+        static const EqualBytesKernel kernel = selectEqualBytesKernel();
+
+        size_t k = 0;
+        if (count >= 16) {
+            k = kernel(a, b, count);
+        }
+        k += equalBytesScalar(a + k, b + k, count - k);
+        while (k < count && a[k] == b[k]) {
+            ++k;
+        }
+        return k;
+    }
+
+    size_t BitString::commonPrefix(const uint8_t* a, size_t aOffset, const uint8_t* b, size_t bOffset, size_t bitCount) {
+        if (bitCount == 0) {
+            return 0;
+        }
+
+        unsigned shift = static_cast<unsigned>(aOffset % 8);
+        if (shift == bOffset % 8) {
+            // Однаковий зсув: неповний перший байт, далі цілі байти векторним ядром
+            a += aOffset / 8;
+            b += bOffset / 8;
+            size_t pos = 0;
+            if (shift != 0) {
+                uint8_t diff = static_cast<uint8_t>((a[0] ^ b[0]) & (0xFF >> shift));
+                if (diff != 0) {
+                    size_t mismatch = leadingZeros64(diff) - 56 - shift;
+                    return mismatch < bitCount ? mismatch : bitCount;
+                }
+                pos = 8 - shift;
+                ++a;
+                ++b;
+            }
+            if (pos >= bitCount) {
+                return bitCount;
+            }
+
+            size_t fullBytes = (bitCount - pos) / 8;
+            size_t same = equalBytes(a, b, fullBytes);
+            pos += same * 8;
+            if (pos < bitCount) {
+                // Перший різний байт або неповний останній байт
+                uint8_t diff = static_cast<uint8_t>(a[same] ^ b[same]);
+                if (diff != 0) {
+                    size_t mismatch = pos + leadingZeros64(diff) - 56;
+                    return mismatch < bitCount ? mismatch : bitCount;
+                }
+            }
+            return bitCount;
+        }
+
+        // Різні зсуви: 64-бітні вікна з обох рядків
+        size_t aEnd = (aOffset + bitCount + 7) / 8;
+        size_t bEnd = (bOffset + bitCount + 7) / 8;
+        for (size_t pos = 0; pos < bitCount; pos += 64) {
+            uint64_t diff = loadBitsAt(a, aOffset + pos, aEnd) ^ loadBitsAt(b, bOffset + pos, bEnd);
+            if (diff != 0) {
+                size_t mismatch = pos + leadingZeros64(diff);
+                return mismatch < bitCount ? mismatch : bitCount;
+            }
+        }
+        return bitCount;
+    }
+
+    bool BitString::equal(const uint8_t* a, size_t aOffset, const uint8_t* b, size_t bOffset, size_t bitCount) {
+        return commonPrefix(a, aOffset, b, bOffset, bitCount) == bitCount;
+    }
+
+    int BitString::compare(const uint8_t* a, size_t aOffset, size_t aBits,
+                           const uint8_t* b, size_t bOffset, size_t bBits) {
+        size_t length = aBits < bBits ? aBits : bBits;
+        size_t prefix = commonPrefix(a, aOffset, b, bOffset, length);
+        if (prefix == length) {
+            return aBits == bBits ? 0 : (aBits < bBits ? -1 : 1);
+        }
+        size_t pos = aOffset + prefix;
+        bool aBit = ((a[pos / 8] >> (7 - pos % 8)) & 1) != 0;
+        return aBit ? 1 : -1;
+    }
+
+    size_t BitString::countLeading(const uint8_t* data, size_t offset, size_t bitCount, bool bit) {
+        // Одиниці інвертуються, тож шукається перший ненульовий біт слова
+        uint64_t flip = bit ? ~0ULL : 0;
+        size_t end = (offset + bitCount + 7) / 8;
+        for (size_t pos = 0; pos < bitCount; pos += 64) {
+            uint64_t word = loadBitsAt(data, offset + pos, end) ^ flip;
+            if (word != 0) {
+                size_t count = pos + leadingZeros64(word);
+                return count < bitCount ? count : bitCount;
+            }
+        }
+        return bitCount;
+    }
+}
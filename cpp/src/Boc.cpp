@@ -5,14 +5,15 @@
 // Реализация Bag of Cells - основного формата сериализации данных в TON
 
 #include "../include/Boc.h"
+#include "../include/CellTraversal.h"
 #include <stdexcept>
 #include <algorithm>
 #include <cstring>
 #include <set>
 #include <queue>
 #include <map>
-#include <unordered_set>
 #include <unordered_map>
+#include <limits>
 
 // Додаткова функція для підрахунку провідних нулів
 // Additional function for counting leading zeros
@@ -33,11 +34,242 @@ static inline int countLeadingZeros(unsigned long long x) {
 
 namespace cton {
     
+    namespace {
+        // Розмітка BOC: заголовок, корені і зсуви комірок
+        // BOC layout: header, roots and cell offsets
+        // Разметка BOC: заголовок, корни и смещения ячеек
+        struct BocLayout {
+            bool hasIdx;
+            size_t cellCount;
+            std::vector<size_t> rootIndices;
+            std::vector<size_t> offsets;  // Зсуви комірок від dataStart (якщо hasIdx)
+            size_t dataStart;
+        };
+        
+        // Положення і структура однієї комірки в даних BOC
+        // Position and structure of one cell inside BOC data
+        // Положение и структура одной ячейки в данных BOC
+        struct CellRecord {
+            size_t dataOffset;
+            size_t bitSize;
+            size_t refIndices[Cell::MAX_REFS];
+            size_t hashesOffset;
+            uint8_t refCount;
+            uint8_t levelMask;
+            bool isSpecial;
+            bool hasHashes;
+        };
+        
+        uint8_t readByteAt(const std::vector<uint8_t>& data, size_t& offset) {
+            if (offset >= data.size()) {
+                throw std::out_of_range("Not enough data to read byte");
+            }
+            return data[offset++];
+        }
+        
+        size_t readVarUIntAt(const std::vector<uint8_t>& data, size_t& offset) {
+            size_t value = 0;
+            uint8_t byte;
+            do {
+                if (value > (std::numeric_limits<size_t>::max() >> 7)) {
+                    throw std::invalid_argument("BOC varint is too large");
+                }
+                byte = readByteAt(data, offset);
+                value = (value << 7) | (byte & 0x7F);
+            } while ((byte & 0x80) != 0);
+            return value;
+        }
+        
+        // Прочитати заголовок BOC до початку даних комірок
+        // Read the BOC header up to the start of cell data
+        // Прочитать заголовок BOC до начала данных ячеек
+        void readLayout(const std::vector<uint8_t>& data, size_t& offset, BocLayout& layout) {
+            if (data.size() < 10) {
+                throw std::invalid_argument("Invalid BOC data");
+            }
+            
+            // Перевіряємо магічні байти
+            // Check magic bytes
+            // Проверяем магические байты
+            if (readByteAt(data, offset) != 0xB5 || readByteAt(data, offset) != 0xEE || 
+                readByteAt(data, offset) != 0x90 || readByteAt(data, offset) != 0x20) {
+                throw std::invalid_argument("Invalid BOC magic");
+            }
+            
+            // Читаємо флаги
+            // Read flags
+            // Читаем флаги
+            uint8_t flags = readByteAt(data, offset);
+            layout.hasIdx = (flags & 0x80) != 0;
+            
+            // Читаємо кількість комірок
+            // Read number of cells
+            // Читаем количество ячеек
+            layout.cellCount = readVarUIntAt(data, offset);
+            
+            // Пропускаємо розміри полів (усі поля кодуються по 7 бітів на байт)
+            // Skip field sizes (all fields use 7 bits per byte encoding)
+            // Пропускаем размеры полей (все поля кодируются по 7 бит на байт)
+            for (int i = 0; i < 4; ++i) {
+                readByteAt(data, offset);
+            }
+            
+            // Читаємо кількість коренів і відсутніх комірок
+            // Read number of roots and absent cells
+            // Читаем количество корней и отсутствующих ячеек
+            size_t rootCount = readByteAt(data, offset);
+            size_t absentCount = readByteAt(data, offset);
+            
+            // Читаємо індекси коренів
+            // Read root indices
+            // Читаем индексы корней
+            layout.rootIndices.resize(rootCount);
+            for (size_t i = 0; i < rootCount; ++i) {
+                layout.rootIndices[i] = readVarUIntAt(data, offset);
+            }
+            
+            // Пропускаємо індекси відсутніх комірок
+            // Skip absent cell indices
+            // Пропускаем индексы отсутствующих ячеек
+            for (size_t i = 0; i < absentCount; ++i) {
+                readVarUIntAt(data, offset);
+            }
+            
+            // Кожна комірка займає щонайменше байт дескриптора (і байт зсуву з індексом),
+            // тож кількість комірок з заголовка не може спричинити завеликого виділення пам'яті
+            // Every cell takes at least a descriptor byte (plus an offset byte with the index),
+            // so the header cell count cannot trigger an oversized allocation
+            // Каждая ячейка занимает минимум байт дескриптора (и байт смещения с индексом),
+            // поэтому количество ячеек из заголовка не может вызвать слишком большое выделение памяти
+            size_t minCellBytes = layout.hasIdx ? 2 : 1;
+            if (layout.cellCount > (data.size() - offset) / minCellBytes) {
+                throw std::invalid_argument("BOC cell count exceeds data size");
+            }
+            
+            // Читаємо зсуви, якщо потрібно
+            // Read offsets if needed
+            // Читаем смещения, если нужно
+            layout.offsets.clear();
+            if (layout.hasIdx) {
+                layout.offsets.resize(layout.cellCount);
+                for (size_t i = 0; i < layout.cellCount; ++i) {
+                    layout.offsets[i] = readVarUIntAt(data, offset);
+                }
+            }
+            layout.dataStart = offset;
+        }
+        
+        // Прочитати дескриптор, дані і посилання комірки index
+        // Read the descriptor, data and references of cell index
+        // Прочитать дескриптор, данные и ссылки ячейки index
+        void readCellRecord(const std::vector<uint8_t>& data, size_t& offset,
+                            size_t index, size_t cellCount, CellRecord& record) {
+            uint8_t descriptor = readByteAt(data, offset);
+            bool hasBits = (descriptor & 0x80) != 0;
+            size_t refCount = (descriptor >> 3) & 0x07;
+            record.isSpecial = (descriptor & 0x04) != 0;
+            record.hasHashes = (descriptor & 0x01) != 0;
+            
+            if (refCount > Cell::MAX_REFS) {
+                throw std::invalid_argument("Invalid BOC cell reference count");
+            }
+            record.refCount = static_cast<uint8_t>(refCount);
+            
+            // Маска рівнів і збережені хеші (перевіряються після створення комірки)
+            // Level mask and stored hashes (verified once the cell is created)
+            // Маска уровней и сохраненные хеши (проверяются после создания ячейки)
+            record.levelMask = (descriptor & 0x02) ? readByteAt(data, offset) : 0;
+            if (record.levelMask > 7) {
+                throw std::invalid_argument("Invalid BOC cell level mask");
+            }
+            record.hashesOffset = offset;
+            if (record.hasHashes) {
+                size_t hashCount = 1;
+                for (uint8_t mask = record.levelMask; mask != 0; mask &= mask - 1) {
+                    ++hashCount;
+                }
+                size_t hashesSize = hashCount * (Cell::HASH_SIZE + 2);
+                if (offset + hashesSize > data.size()) {
+                    throw std::out_of_range("Not enough data to read bytes");
+                }
+                offset += hashesSize;
+            }
+            
+            // Читаємо d2 і визначаємо розмір даних у бітах за completion tag
+            // Read d2 and determine data bit size from the completion tag
+            // Читаем d2 и определяем размер данных в битах по completion tag
+            record.bitSize = 0;
+            record.dataOffset = offset;
+            if (hasBits) {
+                size_t d2 = readByteAt(data, offset);
+                size_t dataSizeInBytes = (d2 + 1) / 2;
+                if (offset + dataSizeInBytes > data.size()) {
+                    throw std::out_of_range("Not enough data to read bytes");
+                }
+                record.dataOffset = offset;
+                record.bitSize = (d2 / 2) * 8;
+                if (d2 % 2 != 0) {
+                    uint8_t lastByte = data[offset + dataSizeInBytes - 1];
+                    if (lastByte == 0) {
+                        throw std::invalid_argument("Invalid BOC cell completion tag");
+                    }
+                    int trailingZeros = 0;
+                    while ((lastByte & (1 << trailingZeros)) == 0) {
+                        ++trailingZeros;
+                    }
+                    record.bitSize += 7 - trailingZeros;
+                }
+                if (record.bitSize > Cell::MAX_BITS) {
+                    throw std::invalid_argument("Invalid BOC cell data length");
+                }
+                offset += dataSizeInBytes;
+            }
+            
+            // Читаємо індекси референсів
+            // Read reference indices
+            // Читаем индексы ссылок
+            for (size_t j = 0; j < refCount; ++j) {
+                record.refIndices[j] = readVarUIntAt(data, offset);
+                if (record.refIndices[j] <= index || record.refIndices[j] >= cellCount) {
+                    throw std::invalid_argument("Invalid BOC reference index");
+                }
+            }
+        }
+        
+        // Перевірити хеші і глибини, збережені в BOC, проти обчислених
+        // Verify hashes and depths stored in the BOC against computed ones
+        // Проверить хеши и глубины, сохраненные в BOC, против вычисленных
+        void verifyCellHashes(const Cell& cell, const uint8_t* stored) {
+            uint8_t levelMask = cell.getLevelMask();
+            size_t hashCount = 0;
+            for (unsigned level = 0; level <= Cell::MAX_LEVEL; ++level) {
+                if (level == 0 || (levelMask & (1u << (level - 1)))) {
+                    ++hashCount;
+                }
+            }
+            
+            const uint8_t* depths = stored + hashCount * Cell::HASH_SIZE;
+            size_t index = 0;
+            for (unsigned level = 0; level <= Cell::MAX_LEVEL; ++level) {
+                if (level != 0 && !(levelMask & (1u << (level - 1)))) {
+                    continue;
+                }
+                Cell::Hash h = cell.hash(level);
+                uint16_t depth = static_cast<uint16_t>((depths[index * 2] << 8) | depths[index * 2 + 1]);
+                if (std::memcmp(stored + index * Cell::HASH_SIZE, h.data(), Cell::HASH_SIZE) != 0 ||
+                    depth != cell.depth(level)) {
+                    throw std::invalid_argument("BOC cell hash mismatch");
+                }
+                ++index;
+            }
+        }
+    }
+    
     Boc::Boc() : root_(nullptr) {}
     
-    Boc::Boc(std::shared_ptr<Cell> root) : root_(root) {}
+    Boc::Boc(CellRef root) : root_(root) {}
     
-    std::vector<uint8_t> Boc::serialize(bool hasIdx, bool hashCRC) const {
+    std::vector<uint8_t> Boc::serialize(bool hasIdx, bool hashCRC, bool withHashes) const {
         // Реалізація серіалізації BOC в бінарне представлення
         // Implementation of BOC serialization to binary representation
         // Реализация сериализации BOC в бинарное представление
@@ -46,17 +278,31 @@ namespace cton {
             return std::vector<uint8_t>();
         }
         
-        // Оптимізована колекція комірок з використанням unordered_set для швидшого пошуку
-        // Optimized cell collection using unordered_set for faster lookup
-        // Оптимизированная коллекция ячеек с использованием unordered_set для быстрого поиска
-        std::vector<std::shared_ptr<Cell>> cells;
-        std::unordered_set<std::shared_ptr<Cell>> visited;
-        collectCells(root_, cells, visited);
+        // Ітеративний обхід без рекурсії: довгі ланцюжки не переповнюють стек
+        // Iterative walk without recursion: long chains cannot overflow the stack
+        // Итеративный обход без рекурсии: длинные цепочки не переполняют стек
+        // Обхід працює з сирими вказівниками: граф тримає root_, тому лічильники посилань не змінюються
+        // The walk uses raw pointers: root_ keeps the graph alive, so reference counts are untouched
+        // Обход работает с сырыми указателями: граф удерживает root_, поэтому счетчики ссылок не меняются
+        std::vector<const Cell*> cells = CellTraversal::collect(root_.get(), TraversalOrder::PostOrder);
+        
+        // Обернений post-order - топологічний порядок: корінь має індекс 0,
+        // а кожна комірка посилається лише на комірки з більшими індексами
+        // Reversed post-order is a topological order: the root gets index 0
+        // and every cell references only cells with larger indices
+        // Обратный post-order - топологический порядок: корень имеет индекс 0,
+        // а каждая ячейка ссылается только на ячейки с большими индексами
+        std::reverse(cells.begin(), cells.end());
+        
+        // Маски рівнів і хеші нижче читаються з кешу: хешуємо граф заздалегідь обходом з явним стеком
+        // Level masks and hashes below come from the cache: hash the graph up front with an explicit-stack walk
+        // Маски уровней и хеши ниже читаются из кеша: хешируем граф заранее обходом с явным стеком
+        Cell::hashTree(root_, 1);
         
         // Створюємо відображення комірок в індекси з використанням unordered_map
         // Create cell to index mapping using unordered_map
         // Создаем отображение ячеек в индексы с использованием unordered_map
-        std::unordered_map<std::shared_ptr<Cell>, size_t> cellIndices;
+        std::unordered_map<const Cell*, size_t> cellIndices;
         cellIndices.reserve(cells.size());
         for (size_t i = 0; i < cells.size(); ++i) {
             cellIndices[cells[i]] = i;
@@ -100,10 +346,10 @@ namespace cton {
             tempCount >>= 7;
         } while (tempCount > 0);
         
-        // Встановлюємо старший біт для всіх байтів, окрім останнього
-        // Set high bit for all bytes except the last one
-        // Устанавливаем старший бит для всех байтов, кроме последнего
-        for (size_t i = 0; i < cellCountBytes.size() - 1; ++i) {
+        // Встановлюємо старший біт для всіх байтів, окрім молодшого (він записується останнім)
+        // Set high bit for all bytes except the least significant one (it is written last)
+        // Устанавливаем старший бит для всех байтов, кроме младшего (он записывается последним)
+        for (size_t i = 1; i < cellCountBytes.size(); ++i) {
             cellCountBytes[i] |= 0x80;
         }
         
@@ -198,7 +444,7 @@ namespace cton {
             // Добавляем информацию о ячейке
             uint8_t descriptor = 0;
             descriptor |= (cell->getBitSize() > 0) ? 0x80 : 0; // Записуємо біти / Write bits / Записываем биты
-            descriptor |= (cell->getReferences().size() & 0x07) << 3; // Кількість референсів / Ref count / Количество ссылок
+            descriptor |= (cell->getRefsCount() & 0x07) << 3; // Кількість референсів / Ref count / Количество ссылок
             
             // Перевіряємо чи комірка спеціальна
             // Check if cell is special
@@ -207,59 +453,84 @@ namespace cton {
                 descriptor |= 0x04; // Встановлюємо біт спеціальної комірки / Set special cell bit
             }
             
-            data.push_back(descriptor);
+            // Маска рівнів записується окремим байтом, якщо вона ненульова
+            // The level mask is written as a separate byte when it is nonzero
+            // Маска уровней записывается отдельным байтом, если она ненулевая
+            uint8_t levelMask = cell->getLevelMask();
+            if (levelMask != 0) {
+                descriptor |= 0x02;
+            }
+            if (withHashes) {
+                descriptor |= 0x01;
+            }
             
-            // Додаємо дані комірки
-            // Add cell data
-            // Добавляем данные ячейки
-            auto cellBytes = cell->getData();
+            data.push_back(descriptor);
+            if (levelMask != 0) {
+                data.push_back(levelMask);
+            }
             
-            // Додаємо розмір даних у бітах, якщо потрібно
-            // Add data size in bits if needed
-            // Добавляем размер данных в битах, если нужно
-            if (cell->getBitSize() > 0) {
-                size_t dataSizeInBytes = (cell->getBitSize() + 7) / 8;
-                if (dataSizeInBytes < cellBytes.size()) {
-                    // Додаємо додатковий байт з кількістю бітів у останньому байті
-                    // Add additional byte with number of bits in last byte
-                    // Добавляем дополнительный байт с количеством битов в последнем байте
-                    data.push_back(static_cast<uint8_t>(cell->getBitSize() % 8));
+            // Хеші і глибини всіх значущих рівнів, від нижчого до вищого
+            // Hashes and depths of all significant levels, lowest first
+            // Хеши и глубины всех значимых уровней, от низшего к высшему
+            if (withHashes) {
+                for (unsigned level = 0; level <= Cell::MAX_LEVEL; ++level) {
+                    if (level == 0 || (levelMask & (1u << (level - 1)))) {
+                        Cell::Hash h = cell->hash(level);
+                        data.insert(data.end(), h.begin(), h.end());
+                    }
+                }
+                for (unsigned level = 0; level <= Cell::MAX_LEVEL; ++level) {
+                    if (level == 0 || (levelMask & (1u << (level - 1)))) {
+                        uint16_t depth = cell->depth(level);
+                        data.push_back(static_cast<uint8_t>(depth >> 8));
+                        data.push_back(static_cast<uint8_t>(depth));
+                    }
                 }
             }
             
-            data.insert(data.end(), cellBytes.begin(), cellBytes.end());
+            // Додаємо довжину даних d2 = floor(b/8) + ceil(b/8) і дані з completion tag
+            // Add data length d2 = floor(b/8) + ceil(b/8) and data with completion tag
+            // Добавляем длину данных d2 = floor(b/8) + ceil(b/8) и данные с completion tag
+            size_t bitSize = cell->getBitSize();
+            if (bitSize > 0) {
+                size_t dataSizeInBytes = (bitSize + 7) / 8;
+                data.push_back(static_cast<uint8_t>(bitSize / 8 + dataSizeInBytes));
+                
+                auto cellBytes = cell->getData();
+                data.insert(data.end(), cellBytes.begin(), cellBytes.begin() + dataSizeInBytes);
+                if (bitSize % 8 != 0) {
+                    data.back() |= static_cast<uint8_t>(0x80 >> (bitSize % 8));
+                }
+            }
             
             // Додаємо індекси референсів
             // Add reference indices
             // Добавляем индексы ссылок
-            auto references = cell->getReferences();
-            for (const auto& ref : references) {
-                if (auto refCell = ref.lock()) {
-                    auto it = cellIndices.find(refCell);
-                    if (it != cellIndices.end()) {
-                        // Кодуємо індекс референсу
-                        // Encode reference index
-                        // Кодируем индекс ссылки
-                        size_t refIndex = it->second;
-                        std::vector<uint8_t> indexBytes;
-                        indexBytes.reserve(8); // Резервуємо пам'ять / Reserve memory / Резервируем память
-                        size_t tempIndex = refIndex;
-                        do {
-                            indexBytes.push_back(tempIndex & 0x7F);
-                            tempIndex >>= 7;
-                        } while (tempIndex > 0);
-                        
-                        // Встановлюємо старший біт для всіх байтів, окрім останнього
-                        // Set high bit for all bytes except the last one
-                        for (size_t j = 0; j < indexBytes.size() - 1; ++j) {
-                            indexBytes[j] |= 0x80;
-                        }
-                        
-                        // Додаємо в зворотньому порядку
-                        // Add in reverse order
-                        for (auto it2 = indexBytes.rbegin(); it2 != indexBytes.rend(); ++it2) {
-                            data.push_back(*it2);
-                        }
+            for (size_t r = 0; r < cell->getRefsCount(); ++r) {
+                auto it = cellIndices.find(cell->getReference(r).get());
+                if (it != cellIndices.end()) {
+                    // Кодуємо індекс референсу
+                    // Encode reference index
+                    // Кодируем индекс ссылки
+                    size_t refIndex = it->second;
+                    std::vector<uint8_t> indexBytes;
+                    indexBytes.reserve(8); // Резервуємо пам'ять / Reserve memory / Резервируем память
+                    size_t tempIndex = refIndex;
+                    do {
+                        indexBytes.push_back(tempIndex & 0x7F);
+                        tempIndex >>= 7;
+                    } while (tempIndex > 0);
+                    
+                    // Встановлюємо старший біт для всіх байтів, окрім молодшого
+                    // Set high bit for all bytes except the least significant one
+                    for (size_t j = 1; j < indexBytes.size(); ++j) {
+                        indexBytes[j] |= 0x80;
+                    }
+                    
+                    // Додаємо в зворотньому порядку
+                    // Add in reverse order
+                    for (auto it2 = indexBytes.rbegin(); it2 != indexBytes.rend(); ++it2) {
+                        data.push_back(*it2);
                     }
                 }
             }
@@ -284,9 +555,9 @@ namespace cton {
                     tempOffset >>= 7;
                 } while (tempOffset > 0);
                 
-                // Встановлюємо старший біт для всіх байтів, окрім останнього
-                // Set high bit for all bytes except the last one
-                for (size_t j = 0; j < offsetBytes.size() - 1; ++j) {
+                // Встановлюємо старший біт для всіх байтів, окрім молодшого
+                // Set high bit for all bytes except the least significant one
+                for (size_t j = 1; j < offsetBytes.size(); ++j) {
                     offsetBytes[j] |= 0x80;
                 }
                 
@@ -331,328 +602,199 @@ namespace cton {
         return parser.parse();
     }
     
-    std::shared_ptr<Cell> Boc::getRoot() const {
-        return root_;
+    Boc Boc::deserialize(const std::vector<uint8_t>& data, CellArena& arena) {
+        BocParser parser(data);
+        return parser.parse(arena);
     }
     
-    void Boc::setRoot(std::shared_ptr<Cell> root) {
-        root_ = root;
+    Boc Boc::deserialize(const std::vector<uint8_t>& data, CellInterner& interner) {
+        BocParser parser(data);
+        return parser.parse(interner);
     }
     
-    void Boc::collectCells(std::shared_ptr<Cell> cell, 
-                         std::vector<std::shared_ptr<Cell>>& cells,
-                         std::unordered_set<std::shared_ptr<Cell>>& visited) const {
-        // Перевірка чи комірка вже відвідана
-        // Check if cell is already visited
-        // Проверка, посещена ли ячейка уже
-        if (visited.find(cell) != visited.end()) {
-            return; // Комірка вже відвідана / Cell already visited / Ячейка уже посещена
-        }
-        
-        // Додати комірку до відвіданих
-        // Add cell to visited
-        // Добавить ячейку в посещенные
-        visited.insert(cell);
-        
-        // Додати комірку до колекції
-        // Add cell to collection
-        // Добавить ячейку в коллекцию
-        cells.push_back(cell);
-        
-        // Рекурсивно обробити референси
-        // Recursively process references
-        // Рекурсивно обработать ссылки
-        auto references = cell->getReferences();
-        for (const auto& ref : references) {
-            if (auto refCell = ref.lock()) {
-                collectCells(refCell, cells, visited);
-            }
-        }
+    CellRef Boc::getRoot() const {
+        return root_;
+    }
+    
+    void Boc::setRoot(CellRef root) {
+        root_ = root;
     }
     
     BocParser::BocParser(const std::vector<uint8_t>& data) : data_(data), offset_(0) {}
     
     Boc BocParser::parse() {
+        return parseCells(nullptr, nullptr);
+    }
+    
+    Boc BocParser::parse(CellArena& arena) {
+        return parseCells(&arena, nullptr);
+    }
+    
+    Boc BocParser::parse(CellInterner& interner) {
+        return parseCells(nullptr, &interner);
+    }
+    
+    Boc BocParser::parseCells(CellArena* arena, CellInterner* interner) {
         // Реалізація парсингу BOC
         // Implementation of BOC parsing
         // Реализация парсинга BOC
-        
-        if (data_.size() < 10) {
-            throw std::invalid_argument("Invalid BOC data");
-        }
-        
-        // Перевіряємо магічні байти
-        // Check magic bytes
-        // Проверяем магические байты
-        if (readByte() != 0xB5 || readByte() != 0xEE || 
-            readByte() != 0x90 || readByte() != 0x20) {
-            throw std::invalid_argument("Invalid BOC magic");
-        }
-        
-        // Читаємо флаги
-        // Read flags
-        // Читаем флаги
-        uint8_t flags = readByte();
-        bool hasIdx = (flags & 0x80) != 0;
-        bool hashCRC = (flags & 0x08) != 0;
-        bool hasCacheBits = (flags & 0x04) != 0;
-        
-        // Читаємо кількість комірок
-        // Read number of cells
-        // Читаем количество ячеек
-        size_t cellCount = 0;
-        uint8_t byte;
-        do {
-            byte = readByte();
-            cellCount = (cellCount << 7) | (byte & 0x7F);
-        } while ((byte & 0x80) != 0);
-        
-        // Читаємо розміри полів
-        // Read field sizes
-        // Читаем размеры полей
-        size_t offsetBitSize = readByte();
-        size_t cellsBitSize = readByte();
-        size_t rootsBitSize = readByte();
-        size_t absentBitSize = readByte();
-        
-        // Читаємо кількість коренів
-        // Read number of roots
-        // Читаем количество корней
-        size_t rootCount = readByte();
-        
-        // Читаємо кількість відсутніх комірок
-        // Read number of absent cells
-        // Читаем количество отсутствующих ячеек
-        size_t absentCount = readByte();
-        
-        // Читаємо індекси коренів
-        // Read root indices
-        // Читаем индексы корней
-        std::vector<size_t> rootIndices(rootCount);
-        for (size_t i = 0; i < rootCount; ++i) {
-            size_t index = 0;
-            uint8_t byte2;
-            do {
-                byte2 = readByte();
-                index = (index << 7) | (byte2 & 0x7F);
-            } while ((byte2 & 0x80) != 0);
-            rootIndices[i] = index;
-        }
-        
-        // Читаємо індекси відсутніх комірок
-        // Read absent cell indices
-        // Читаем индексы отсутствующих ячеек
-        std::vector<size_t> absentIndices(absentCount);
-        for (size_t i = 0; i < absentCount; ++i) {
-            size_t index = 0;
-            uint8_t byte2;
-            do {
-                byte2 = readByte();
-                index = (index << 7) | (byte2 & 0x7F);
-            } while ((byte2 & 0x80) != 0);
-            absentIndices[i] = index;
-        }
-        
-        // Читаємо зсуви, якщо потрібно
-        // Read offsets if needed
-        // Читаем смещения, если нужно
-        std::vector<size_t> offsets;
-        if (hasIdx) {
-            offsets.resize(cellCount);
-            for (size_t i = 0; i < cellCount; ++i) {
-                size_t offset = 0;
-                uint8_t byte2;
-                do {
-                    byte2 = readByte();
-                    offset = (offset << 7) | (byte2 & 0x7F);
-                } while ((byte2 & 0x80) != 0);
-                offsets[i] = offset;
-            }
-        }
-        
-        // Створюємо вектор комірок
-        // Create vector of cells
-        // Создаем вектор ячеек
-        std::vector<std::shared_ptr<Cell>> cells(cellCount);
-        
-        // Парсимо комірки
-        // Parse cells
-        // Парсим ячейки
-        size_t dataStartOffset = offset_;
+        BocLayout layout;
+        readLayout(data_, offset_, layout);
+        size_t cellCount = layout.cellCount;
+        const std::vector<size_t>& rootIndices = layout.rootIndices;
+        
+        // Перший прохід: читаємо дескриптори, положення даних і індекси референсів
+        // First pass: read descriptors, data positions and reference indices
+        // Первый проход: читаем дескрипторы, положение данных и индексы ссылок
+        std::vector<CellRecord> records(cellCount);
         for (size_t i = 0; i < cellCount; ++i) {
             // Якщо є індекси, встановлюємо правильне положення
             // If there are indices, set correct position
             // Если есть индексы, устанавливаем правильную позицию
-            if (hasIdx && i < offsets.size()) {
-                offset_ = dataStartOffset + offsets[i];
+            if (layout.hasIdx) {
+                offset_ = layout.dataStart + layout.offsets[i];
             }
-            
-            // Читаємо дескриптор комірки
-            // Read cell descriptor
-            // Читаем дескриптор ячейки
-            uint8_t descriptor = readByte();
-            bool hasBits = (descriptor & 0x80) != 0;
-            size_t refCount = (descriptor >> 3) & 0x07;
-            bool isSpecial = (descriptor & 0x04) != 0;
-            bool hasLevel = (descriptor & 0x02) != 0;
-            bool hasHashes = (descriptor & 0x01) != 0;
-            
-            // Читаємо розмір даних у бітах
-            // Read data size in bits
-            // Читаем размер данных в битах
-            size_t bitSize = 0;
-            if (hasBits) {
-                bitSize = readByte();
-                if (bitSize == 0) {
-                    // Якщо розмір 0, це означає 256 бітів
-                    // If size is 0, it means 256 bits
-                    // Если размер 0, это означает 256 битов
-                    bitSize = 256;
-                }
+            readCellRecord(data_, offset_, i, cellCount, records[i]);
+        }
+        
+        // Другий прохід: створюємо комірки з кінця, щоб кожна комірка створювалась
+        // один раз з уже готовими дочірніми комірками
+        // Second pass: create cells from the end so every cell is created once
+        // with its children already built
+        // Второй проход: создаем ячейки с конца, чтобы каждая ячейка создавалась
+        // один раз с уже готовыми дочерними ячейками
+        std::vector<CellRef> cells(cellCount);
+        for (size_t i = cellCount; i-- > 0;) {
+            const CellRecord& record = records[i];
+            CellRef refs[Cell::MAX_REFS];
+            for (size_t j = 0; j < record.refCount; ++j) {
+                refs[j] = cells[record.refIndices[j]];
             }
             
-            // Читаємо додатковий байт, якщо потрібно
-            // Read additional byte if needed
-            // Читаем дополнительный байт, если нужно
-            size_t dataSizeInBytes = (bitSize + 7) / 8;
-            if (dataSizeInBytes < (bitSize + 7) / 8) {
-                uint8_t extraByte = readByte();
-                // Використовуємо extraByte для визначення точного розміру
-                // Use extraByte to determine exact size
+            const uint8_t* cellData = data_.data() + record.dataOffset;
+            const CellRef* cellRefs = refs;
+            if (interner) {
+                cells[i] = interner->intern(cellData, record.bitSize, cellRefs, record.refCount, record.isSpecial);
+            } else if (arena) {
+                cells[i] = arena->createCell(cellData, record.bitSize, cellRefs, record.refCount, record.isSpecial);
+            } else {
+                cells[i] = Cell::create(cellData, record.bitSize, cellRefs,
+                                        static_cast<size_t>(record.refCount), record.isSpecial);
             }
             
-            // Читаємо дані комірки
-            // Read cell data
-            // Читаем данные ячейки
-            std::vector<uint8_t> cellData;
-            if (dataSizeInBytes > 0) {
-                cellData = readBytes(dataSizeInBytes);
+            if (cells[i]->getLevelMask() != record.levelMask) {
+                throw std::invalid_argument("BOC cell level mask mismatch");
             }
-            
-            // Читаємо індекси референсів
-            // Read reference indices
-            // Читаем индексы ссылок
-            std::vector<size_t> refIndices(refCount);
-            for (size_t j = 0; j < refCount; ++j) {
-                size_t refIndex = 0;
-                uint8_t byte2;
-                do {
-                    byte2 = readByte();
-                    refIndex = (refIndex << 7) | (byte2 & 0x7F);
-                } while ((byte2 & 0x80) != 0);
-                refIndices[j] = refIndex;
-            }
-            
-            // Створюємо комірку
-            // Create cell
-            // Создаем ячейку
-            std::shared_ptr<Cell> cell = std::make_shared<Cell>(cellData, bitSize, std::vector<std::shared_ptr<Cell>>(), isSpecial);
-            cells[i] = cell;
-            
-            // Встановлюємо референси (будуть встановлені пізніше)
-            // Set references (will be set later)
-            // Устанавливаем ссылки (будут установлены позже)
-        }
-        
-        // Встановлюємо референси для комірок
-        // Set references for cells
-        // Устанавливаем ссылки для ячеек
-        // Це можна зробити в окремому проході після створення всіх комірок
-        // This can be done in a separate pass after creating all cells
-        // Это можно сделать в отдельном проходе после создания всех ячеек
-        
-        // Спочатку створюємо вектор для зберігання референсів кожної комірки
-        // First create a vector to store references for each cell
-        // Сначала создаем вектор для хранения ссылок каждой ячейки
-        std::vector<std::vector<size_t>> cellReferences(cellCount);
-        
-        // Повертаємося до початку для читання референсів
-        // Go back to the beginning to read references
-        // Возвращаемся к началу для чтения ссылок
-        size_t tempOffset = offset_;
-        offset_ = dataStartOffset;
-        
-        // Читаємо референси для кожної комірки
-        // Read references for each cell
-        // Читаем ссылки для каждой ячейки
-        for (size_t i = 0; i < cellCount; ++i) {
-            // Якщо є індекси, встановлюємо правильне положення
-            // If there are indices, set correct position
-            // Если есть индексы, устанавливаем правильную позицию
-            if (hasIdx && i < offsets.size()) {
-                offset_ = dataStartOffset + offsets[i];
-            }
-            
-            // Пропускаємо дескриптор і дані
-            // Skip descriptor and data
-            // Пропускаем дескриптор и данные
-            uint8_t descriptor = readByte();
-            bool hasBits = (descriptor & 0x80) != 0;
-            size_t refCount = (descriptor >> 3) & 0x07;
-            
-            // Пропускаємо біти даних
-            // Skip data bits
-            // Пропускаем биты данных
-            if (hasBits) {
-                size_t bitSize = readByte();
-                if (bitSize == 0) {
-                    bitSize = 256;
-                }
-                size_t dataSizeInBytes = (bitSize + 7) / 8;
-                offset_ += dataSizeInBytes;
-            }
-            
-            // Читаємо індекси референсів
-            // Read reference indices
-            // Читаем индексы ссылок
-            for (size_t j = 0; j < refCount; ++j) {
-                size_t refIndex = 0;
-                uint8_t byte2;
-                do {
-                    byte2 = readByte();
-                    refIndex = (refIndex << 7) | (byte2 & 0x7F);
-                } while ((byte2 & 0x80) != 0);
-                cellReferences[i].push_back(refIndex);
-            }
-        }
-        
-        // Встановлюємо референси для кожної комірки
-        // Set references for each cell
-        // Устанавливаем ссылки для каждой ячейки
-        for (size_t i = 0; i < cellCount; ++i) {
-            for (size_t refIndex : cellReferences[i]) {
-                if (refIndex < cells.size() && cells[refIndex]) {
-                    // Створюємо нову комірку з референсом
-                    // Create new cell with reference
-                    // Создаем новую ячейку с ссылкой
-                    std::vector<std::shared_ptr<Cell>> refs = {cells[refIndex]};
-                    // We can't modify the existing cell directly, so we create a new one
-                    // Ми не можемо змінити існуючу комірку напряму, тому створюємо нову
-                    cells[i] = std::make_shared<Cell>(cells[i]->getData(), cells[i]->getBitSize(), refs, cells[i]->isSpecial());
-                }
+            if (record.hasHashes) {
+                verifyCellHashes(*cells[i], data_.data() + record.hashesOffset);
             }
         }
         
         // Встановлюємо кореневу комірку
         // Set the root cell
         // Устанавливаем корневую ячейку
-        std::shared_ptr<Cell> root;
+        CellRef root;
         if (!rootIndices.empty() && rootIndices[0] < cells.size()) {
             root = cells[rootIndices[0]];
         } else if (!cells.empty()) {
             root = cells[0];
         } else {
             // Create one empty cell as root
-            root = std::make_shared<Cell>();
+            root = Cell::create();
         }
         return Boc(root);
     }
     
-    uint8_t BocParser::readByte() {
-        if (offset_ >= data_.size()) {
-            throw std::out_of_range("Not enough data to read byte");
+    CellGraph BocParser::parseGraph() {
+        BocLayout layout;
+        readLayout(data_, offset_, layout);
+        size_t cellCount = layout.cellCount;
+        if (cellCount > std::numeric_limits<CellGraph::Index>::max()) {
+            throw std::overflow_error("Cell graph is too large");
+        }
+        
+        // Дані комірок копіюються одразу в пул графа, посилання - в масив індексів
+        // Cell data goes straight into the graph pool, references into the index array
+        // Данные ячеек копируются сразу в пул графа, ссылки - в массив индексов
+        CellGraph graph;
+        graph.cells_.reserve(cellCount);
+        std::vector<size_t> hashesOffsets;
+        for (size_t i = 0; i < cellCount; ++i) {
+            if (layout.hasIdx) {
+                offset_ = layout.dataStart + layout.offsets[i];
+            }
+            CellRecord record;
+            readCellRecord(data_, offset_, i, cellCount, record);
+            graph.appendCell(data_.data() + record.dataOffset, record.bitSize, record.refCount,
+                             record.isSpecial, record.levelMask);
+            for (size_t j = 0; j < record.refCount; ++j) {
+                graph.refs_.push_back(static_cast<CellGraph::Index>(record.refIndices[j]));
+            }
+            if (record.hasHashes) {
+                hashesOffsets.resize(cellCount, 0);
+                hashesOffsets[i] = record.hashesOffset + 1;
+            }
+        }
+        
+        // Маска звичайної комірки - об'єднання масок дочірніх; спеціальні комірки
+        // перевіряються при матеріалізації
+        // The mask of an ordinary cell is the union of its children's masks; special
+        // cells are checked when materialized
+        // Маска обычной ячейки - объединение масок дочерних; специальные ячейки
+        // проверяются при материализации
+        for (size_t i = 0; i < cellCount; ++i) {
+            CellGraph::Index index = static_cast<CellGraph::Index>(i);
+            if (graph.isSpecial(index)) {
+                continue;
+            }
+            uint8_t levelMask = 0;
+            for (size_t j = 0; j < graph.refCount(index); ++j) {
+                levelMask |= graph.levelMask(graph.ref(index, j));
+            }
+            if (levelMask != graph.levelMask(index)) {
+                throw std::invalid_argument("BOC cell level mask mismatch");
+            }
+        }
+        
+        // Порівнюємо хеш представлення і глибину (останні збережені значення)
+        // Compare the representation hash and depth (the last stored values)
+        // Сравниваем хеш представления и глубину (последние сохраненные значения)
+        if (!hashesOffsets.empty()) {
+            graph.computeHashes();
+            for (size_t i = 0; i < cellCount; ++i) {
+                if (hashesOffsets[i] == 0) {
+                    continue;
+                }
+                CellGraph::Index index = static_cast<CellGraph::Index>(i);
+                size_t hashCount = 1;
+                for (uint8_t mask = graph.levelMask(index); mask != 0; mask &= mask - 1) {
+                    ++hashCount;
+                }
+                const uint8_t* stored = data_.data() + hashesOffsets[i] - 1;
+                const uint8_t* depth = stored + hashCount * Cell::HASH_SIZE + (hashCount - 1) * 2;
+                Cell::Hash hash = graph.hash(index);
+                if (std::memcmp(stored + (hashCount - 1) * Cell::HASH_SIZE, hash.data(), Cell::HASH_SIZE) != 0 ||
+                    static_cast<uint16_t>((depth[0] << 8) | depth[1]) != graph.depth(index)) {
+                    throw std::invalid_argument("BOC cell hash mismatch");
+                }
+            }
         }
-        return data_[offset_++];
+        
+        for (size_t rootIndex : layout.rootIndices) {
+            if (rootIndex >= cellCount) {
+                throw std::invalid_argument("Invalid BOC root index");
+            }
+            graph.roots_.push_back(static_cast<CellGraph::Index>(rootIndex));
+        }
+        return graph;
+    }
+    
+    size_t BocParser::readVarUInt() {
+        return readVarUIntAt(data_, offset_);
+    }
+    
+    uint8_t BocParser::readByte() {
+        return readByteAt(data_, offset_);
     }
     
     uint32_t BocParser::readUint32() {
@@ -709,9 +851,151 @@ namespace cton {
         return crc ^ 0xFFFFFFFF;
     }
     
-    BocBuilder::BocBuilder(std::shared_ptr<Cell> root) : root_(root) {}
+    BocView::BocView(std::vector<uint8_t> data) : data_(std::move(data)) {
+        BocLayout layout;
+        size_t offset = 0;
+        readLayout(data_, offset, layout);
+        rootIndices_ = layout.rootIndices;
+        for (size_t root : rootIndices_) {
+            if (root >= layout.cellCount) {
+                throw std::invalid_argument("Invalid BOC root index");
+            }
+        }
+        
+        // З індексом зсуви беруться готовими, інакше - один прохід по записах без створення комірок
+        // With an index the offsets are taken as is, otherwise one pass over records without creating cells
+        // С индексом смещения берутся готовыми, иначе - один проход по записям без создания ячеек
+        offsets_.resize(layout.cellCount);
+        CellRecord record;
+        for (size_t i = 0; i < layout.cellCount; ++i) {
+            if (layout.hasIdx) {
+                offsets_[i] = layout.dataStart + layout.offsets[i];
+                if (offsets_[i] >= data_.size()) {
+                    throw std::out_of_range("Invalid BOC cell offset");
+                }
+            } else {
+                offsets_[i] = offset;
+                readCellRecord(data_, offset, i, layout.cellCount, record);
+            }
+        }
+        cache_.resize(layout.cellCount);
+    }
+    
+    size_t BocView::getCellCount() const {
+        return offsets_.size();
+    }
+    
+    size_t BocView::getRootCount() const {
+        return rootIndices_.size();
+    }
+    
+    size_t BocView::getRootIndex(size_t root) const {
+        if (root >= rootIndices_.size()) {
+            throw std::out_of_range("BOC root index out of range");
+        }
+        return rootIndices_[root];
+    }
+    
+    size_t BocView::getRefsCount(size_t index) const {
+        checkIndex(index);
+        size_t offset = offsets_[index];
+        CellRecord record;
+        readCellRecord(data_, offset, index, offsets_.size(), record);
+        return record.refCount;
+    }
+    
+    size_t BocView::getRefIndex(size_t index, size_t ref) const {
+        checkIndex(index);
+        size_t offset = offsets_[index];
+        CellRecord record;
+        readCellRecord(data_, offset, index, offsets_.size(), record);
+        if (ref >= record.refCount) {
+            throw std::out_of_range("Reference index out of range");
+        }
+        return record.refIndices[ref];
+    }
+    
+    Cell BocView::loadCellData(size_t index) const {
+        checkIndex(index);
+        size_t offset = offsets_[index];
+        CellRecord record;
+        readCellRecord(data_, offset, index, offsets_.size(), record);
+        return Cell(data_.data() + record.dataOffset, record.bitSize, nullptr, 0, false);
+    }
+    
+    CellRef BocView::loadCell(size_t index) const {
+        checkIndex(index);
+        
+        // Явний стек замість рекурсії: довгий ланцюжок посилань не переповнює стек викликів.
+        // Комірка створюється, коли всі дочірні вже в кеші (посилання завжди на більші номери)
+        // Explicit stack instead of recursion: a long reference chain cannot overflow the call stack.
+        // A cell is created once all its children are cached (references always point to larger indices)
+        // Явный стек вместо рекурсии: длинная цепочка ссылок не переполняет стек вызовов.
+        // Ячейка создается, когда все дочерние уже в кеше (ссылки всегда на большие номера)
+        std::vector<size_t> stack(1, index);
+        while (!stack.empty()) {
+            size_t current = stack.back();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (cache_[current]) {
+                    stack.pop_back();
+                    continue;
+                }
+            }
+            
+            size_t offset = offsets_[current];
+            CellRecord record;
+            readCellRecord(data_, offset, current, offsets_.size(), record);
+            CellRef refs[Cell::MAX_REFS];
+            bool ready = true;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                for (size_t j = 0; j < record.refCount; ++j) {
+                    refs[j] = cache_[record.refIndices[j]];
+                    if (!refs[j]) {
+                        stack.push_back(record.refIndices[j]);
+                        ready = false;
+                    }
+                }
+            }
+            if (!ready) {
+                continue;
+            }
+            
+            CellRef cell = Cell::create(data_.data() + record.dataOffset, record.bitSize,
+                                        static_cast<const CellRef*>(refs),
+                                        static_cast<size_t>(record.refCount), record.isSpecial);
+            if (cell->getLevelMask() != record.levelMask) {
+                throw std::invalid_argument("BOC cell level mask mismatch");
+            }
+            if (record.hasHashes) {
+                verifyCellHashes(*cell, data_.data() + record.hashesOffset);
+            }
+            
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!cache_[current]) {
+                cache_[current] = cell;
+            }
+            stack.pop_back();
+        }
+        
+        std::lock_guard<std::mutex> lock(mutex_);
+        return cache_[index];
+    }
+    
+    CellRef BocView::getRoot(size_t root) const {
+        return loadCell(getRootIndex(root));
+    }
+    
+    void BocView::checkIndex(size_t index) const {
+        if (index >= offsets_.size()) {
+            throw std::out_of_range("BOC cell index out of range");
+        }
+    }
+    
+    BocBuilder::BocBuilder(CellRef root) : root_(root) {}
     
-    std::vector<uint8_t> BocBuilder::build(bool hasIdx, bool hashCRC) {
+    std::vector<uint8_t> BocBuilder::build(bool hasIdx, bool hashCRC, bool withHashes) {
         // Реалізація побудови BOC
         // Implementation of BOC building
         // Реализация постройки BOC
@@ -721,6 +1005,6 @@ namespace cton {
         }
         
         Boc boc(root_);
-        return boc.serialize(hasIdx, hashCRC);
+        return boc.serialize(hasIdx, hashCRC, withHashes);
     }
 }
\ No newline at end of file
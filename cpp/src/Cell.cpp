@@ -2,19 +2,328 @@
 // Author: Андрій Будильников (Sparky)
 
 #include "../include/Cell.h"
+#include "../include/CellArena.h"
+#include "../include/CellInterner.h"
+#include "../include/CellSlice.h"
+#include "../include/CellTraversal.h"
+#include "../include/Sha256.h"
+#include "../include/BitString.h"
 #include <stdexcept>
 #include <cstring>
 #include <sstream>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <system_error>
+#include <memory>
+#include <limits>
 
 namespace cton {
     
-    Cell::Cell() : bitSize_(0), isSpecial_(false) {}
+    namespace {
+        // Стани кешу хешу
+        const uint8_t HASH_STATE_EMPTY = 0;
+        const uint8_t HASH_STATE_BUSY = 1;
+        const uint8_t HASH_STATE_READY = 2;
+        
+        // Лічильники живих комірок процесу (relaxed: лише статистика)
+        std::atomic<size_t> liveCellCount(0);
+        std::atomic<size_t> liveCellBytes(0);
+        
+        inline void trackCell(size_t bytes) {
+            liveCellCount.fetch_add(1, std::memory_order_relaxed);
+            liveCellBytes.fetch_add(bytes, std::memory_order_relaxed);
+        }
+        
+        // Менші дерева hashTree хешує в одному потоці
+        const size_t PARALLEL_HASH_MIN_CELLS = 4096;
+        // Кількість комірок, яку потік забирає з шару за раз
+        const size_t PARALLEL_HASH_CHUNK = 64;
+        
+        /**
+         * @brief Бар'єр для повторного використання між шарами
+         */
+        class LayerBarrier {
+        public:
+            explicit LayerBarrier(size_t count) : count_(count), arrived_(0), generation_(0) {}
+            
+            void wait() {
+                std::unique_lock<std::mutex> lock(mutex_);
+                size_t generation = generation_;
+                if (++arrived_ == count_) {
+                    release();
+                } else {
+                    condition_.wait(lock, [this, generation] { return generation_ != generation; });
+                }
+            }
+            
+            /**
+             * @brief Зменшити кількість учасників (потоки, які не вдалося запустити)
+             */
+            void resize(size_t count) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                count_ = count;
+                if (arrived_ >= count_) {
+                    release();
+                }
+            }
+            
+        private:
+            void release() {
+                arrived_ = 0;
+                ++generation_;
+                condition_.notify_all();
+            }
+            
+            std::mutex mutex_;
+            std::condition_variable condition_;
+            size_t count_;
+            size_t arrived_;
+            size_t generation_;
+        };
+        
+        // Найбільший розмір представлення комірки: d1 d2, дані, глибини і хеші посилань
+        const size_t MAX_REPR_SIZE = 2 + Cell::MAX_BYTES + Cell::MAX_REFS * (2 + Cell::HASH_SIZE);
+        
+        /**
+         * @brief Записати представлення рівня комірки
+         * 
+         * d1 d2, дані з completion tag (або хеш попереднього рівня), глибини і хеші
+         * дочірніх комірок рівня childLevel з їхніх кешів
+         * @param previousHash хеш попереднього рівня (nullptr - дані комірки)
+         * @param maxChildDepth найбільша глибина дочірніх комірок
+         * @return довжина представлення
+         */
+        size_t writeRepresentation(uint8_t* repr, uint8_t d1, const uint8_t* data, size_t bitSize,
+                                   const uint8_t* previousHash, const CellRef* references, size_t refCount,
+                                   unsigned childLevel, uint16_t& maxChildDepth) {
+            size_t fullBytes = bitSize / 8;
+            size_t dataBytes = (bitSize + 7) / 8;
+            size_t pos = 0;
+            repr[pos++] = d1;
+            repr[pos++] = static_cast<uint8_t>(fullBytes + dataBytes);
+            
+            if (previousHash == nullptr) {
+                if (dataBytes > 0) {
+                    std::memcpy(repr + pos, data, dataBytes);
+                    size_t tailBits = bitSize % 8;
+                    if (tailBits != 0) {
+                        // Completion tag: одиничний біт після даних, решта - нулі
+                        uint8_t tag = static_cast<uint8_t>(0x80 >> tailBits);
+                        repr[pos + dataBytes - 1] = static_cast<uint8_t>((repr[pos + dataBytes - 1] & ~(tag - 1) & ~tag) | tag);
+                    }
+                    pos += dataBytes;
+                }
+            } else {
+                std::memcpy(repr + pos, previousHash, Cell::HASH_SIZE);
+                pos += Cell::HASH_SIZE;
+            }
+            
+            maxChildDepth = 0;
+            for (size_t i = 0; i < refCount; ++i) {
+                uint16_t childDepth = references[i]->depth(childLevel);
+                maxChildDepth = std::max(maxChildDepth, childDepth);
+                repr[pos++] = static_cast<uint8_t>(childDepth >> 8);
+                repr[pos++] = static_cast<uint8_t>(childDepth);
+            }
+            for (size_t i = 0; i < refCount; ++i) {
+                Cell::Hash childHash = references[i]->hash(childLevel);
+                std::memcpy(repr + pos, childHash.data(), Cell::HASH_SIZE);
+                pos += Cell::HASH_SIZE;
+            }
+            return pos;
+        }
+        
+        /**
+         * @brief Глибина комірки за найбільшою глибиною дочірніх
+         * @throws std::overflow_error якщо глибина не вміщується в 16 бітів представлення
+         */
+        inline uint16_t nextDepth(uint16_t maxChildDepth) {
+            if (maxChildDepth == std::numeric_limits<uint16_t>::max()) {
+                throw std::overflow_error("Cell depth exceeds 65535");
+            }
+            return static_cast<uint16_t>(maxChildDepth + 1);
+        }
+        
+        /**
+         * @brief Таблиця висот комірок з відкритою адресацією
+         * 
+         * Для мільйонів комірок помітно швидша за unordered_map: один масив без
+         * виділення пам'яті на кожен запис
+         */
+        class HeightTable {
+        public:
+            HeightTable() : keys_(1024, nullptr), values_(1024, 0), size_(0) {}
+            
+            /**
+             * @brief Знайти або додати комірку
+             * @param inserted true, якщо комірки ще не було (висота 0)
+             * @return номер запису (дійсний до наступного додавання)
+             */
+            size_t findOrInsert(const Cell* cell, bool& inserted) {
+                if ((size_ + 1) * 2 > keys_.size()) {
+                    grow();
+                }
+                size_t slot = probe(cell);
+                inserted = keys_[slot] == nullptr;
+                if (inserted) {
+                    keys_[slot] = cell;
+                    values_[slot] = 0;
+                    ++size_;
+                }
+                return slot;
+            }
+            
+            uint32_t& value(size_t slot) { return values_[slot]; }
+            
+        private:
+            std::vector<const Cell*> keys_;
+            std::vector<uint32_t> values_;
+            size_t size_;
+            
+            size_t probe(const Cell* cell) const {
+                size_t mask = keys_.size() - 1;
+                // Комірки вирівняні на 64 байти, тому молодші біти адреси нульові
+                size_t slot = static_cast<size_t>((reinterpret_cast<uintptr_t>(cell) >> 6) * 0x9E3779B97F4A7C15ULL) & mask;
+                while (keys_[slot] != nullptr && keys_[slot] != cell) {
+                    slot = (slot + 1) & mask;
+                }
+                return slot;
+            }
+            
+            void grow() {
+                std::vector<const Cell*> oldKeys(keys_.size() * 2, nullptr);
+                std::vector<uint32_t> oldValues(values_.size() * 2, 0);
+                oldKeys.swap(keys_);
+                oldValues.swap(values_);
+                for (size_t i = 0; i < oldKeys.size(); ++i) {
+                    if (oldKeys[i] != nullptr) {
+                        size_t slot = probe(oldKeys[i]);
+                        keys_[slot] = oldKeys[i];
+                        values_[slot] = oldValues[i];
+                    }
+                }
+            }
+        };
+        
+        // Розміри даних спеціальних комірок у бітах
+        const size_t LIBRARY_BITS = 8 + 256;
+        const size_t MERKLE_PROOF_BITS = 8 + 256 + 16;
+        const size_t MERKLE_UPDATE_BITS = 8 + 2 * (256 + 16);
+        
+        inline unsigned countBits(unsigned mask) {
+            unsigned count = 0;
+            for (; mask != 0; mask &= mask - 1) {
+                ++count;
+            }
+            return count;
+        }
+        
+        // Номер хешу рівня level серед значущих рівнів маски
+        inline unsigned hashIndex(uint8_t levelMask, unsigned level) {
+            if (level > Cell::MAX_LEVEL) {
+                level = Cell::MAX_LEVEL;
+            }
+            return countBits(levelMask & ((1u << level) - 1));
+        }
+        
+        inline uint16_t readDepth(const uint8_t* data) {
+            return static_cast<uint16_t>((data[0] << 8) | data[1]);
+        }
+        
+        // Кількість монет зберігається як VarUInteger 16
+        const size_t COINS_MAX_BYTES = 16;
+        
+        void checkUInt256(size_t bits, const UInt256& value) {
+            if (bits > UInt256::BITS) {
+                throw std::invalid_argument("Bits count cannot exceed 256");
+            }
+            if (value.bitLength() > bits) {
+                throw std::invalid_argument("Value does not fit in bits count");
+            }
+        }
+        
+        /**
+         * @brief Розмітка VarUInteger: ширина поля довжини і довжина значення в байтах
+         */
+        void varUIntLayout(size_t maxBytes, const UInt256& value, unsigned& lengthBits, size_t& length) {
+            lengthBits = UInt256::varUIntLengthBits(maxBytes);
+            length = value.byteLength();
+            if (length >= maxBytes) {
+                throw std::invalid_argument("Value does not fit in VarUInteger");
+            }
+        }
+        
+        /**
+         * @brief Записати поле довжини і значення VarUInteger (місце вже перевірене)
+         */
+        void writeVarUInt(uint8_t* buffer, size_t bitOffset, unsigned lengthBits, size_t length, const UInt256& value) {
+            if (lengthBits > 0) {
+                BitString::writeUInt(buffer, Cell::MAX_BYTES, bitOffset, lengthBits, length);
+            }
+            if (length > 0) {
+                BitString::writeUInt256(buffer, Cell::MAX_BYTES, bitOffset + lengthBits, length * 8, value);
+            }
+        }
+    }
+    
+    Cell::Cell()
+        : depth_(0), hashState_(HASH_STATE_EMPTY), levelMask_(0), bitSize_(0), refsCount_(0), isSpecial_(false),
+          refCount_(0), atomicRefCount_(true), arena_(nullptr) {
+        std::memset(data_, 0, MAX_BYTES);
+        trackCell(sizeof(Cell));
+    }
+    
+    Cell::Cell(const Cell& other)
+        : hash_(other.hash_), depth_(other.depth_), hashState_(HASH_STATE_EMPTY), levelMask_(0),
+          bitSize_(other.bitSize_), refsCount_(other.refsCount_), isSpecial_(other.isSpecial_),
+          refCount_(0), atomicRefCount_(true), arena_(nullptr) {
+        std::memcpy(data_, other.data_, MAX_BYTES);
+        for (size_t i = 0; i < refsCount_; ++i) {
+            references_[i] = other.references_[i];
+        }
+        if (other.hashState_.load(std::memory_order_acquire) == HASH_STATE_READY) {
+            levelMask_ = other.levelMask_;
+            hashState_.store(HASH_STATE_READY, std::memory_order_relaxed);
+        }
+        trackCell(sizeof(Cell));
+        if (levelMask_ != 0) {
+            assignLevelHashes(other.levelHashes_.get());
+        }
+    }
+    
+    Cell::~Cell() {
+        liveCellCount.fetch_sub(1, std::memory_order_relaxed);
+        liveCellBytes.fetch_sub(memoryFootprint(), std::memory_order_relaxed);
+    }
+    
+    Cell& Cell::operator=(const Cell& other) {
+        if (this != &other) {
+            std::memcpy(data_, other.data_, MAX_BYTES);
+            for (size_t i = 0; i < MAX_REFS; ++i) {
+                references_[i] = other.references_[i];
+            }
+            bitSize_ = other.bitSize_;
+            refsCount_ = other.refsCount_;
+            isSpecial_ = other.isSpecial_;
+            bool ready = other.hashState_.load(std::memory_order_acquire) == HASH_STATE_READY;
+            hash_ = other.hash_;
+            depth_ = other.depth_;
+            levelMask_ = other.levelMask_;
+            assignLevelHashes(ready ? other.levelHashes_.get() : nullptr);
+            hashState_.store(ready ? HASH_STATE_READY : HASH_STATE_EMPTY, std::memory_order_release);
+        }
+        return *this;
+    }
     
     Cell::Cell(const std::vector<uint8_t>& data, 
                size_t bitSize, 
-               const std::vector<std::shared_ptr<Cell>>& references,
+               const std::vector<CellRef>& references,
                bool isSpecial)
-        : data_(data), bitSize_(bitSize), references_(references), isSpecial_(isSpecial) {
+        : depth_(0), hashState_(HASH_STATE_EMPTY), levelMask_(0), bitSize_(0), refsCount_(0), isSpecial_(isSpecial),
+          refCount_(0), atomicRefCount_(true), arena_(nullptr) {
         // Validate parameters
         if (bitSize > MAX_BITS) {
             throw std::invalid_argument("Bit size exceeds maximum allowed");
@@ -26,54 +335,159 @@ namespace cton {
         
         // Validate that data size is consistent with bit size
         size_t expectedByteSize = (bitSize + 7) / 8;
-        if (data_.size() < expectedByteSize) {
+        if (data.size() < expectedByteSize) {
             throw std::invalid_argument("Data size is smaller than expected for given bit size");
         }
+        
+        if (isSpecial) {
+            validateSpecial(data.data(), bitSize, references.data(), references.size());
+        }
+        
+        assignData(data.data(), bitSize);
+        for (size_t i = 0; i < references.size(); ++i) {
+            references_[i] = references[i];
+        }
+        refsCount_ = static_cast<uint8_t>(references.size());
+        trackCell(sizeof(Cell));
+    }
+    
+    Cell::Cell(const uint8_t* data,
+               size_t bitSize,
+               const CellRef* references,
+               size_t refCount,
+               bool isSpecial)
+        : depth_(0), hashState_(HASH_STATE_EMPTY), levelMask_(0), bitSize_(0), refsCount_(0), isSpecial_(isSpecial),
+          refCount_(0), atomicRefCount_(true), arena_(nullptr) {
+        if (bitSize > MAX_BITS) {
+            throw std::invalid_argument("Bit size exceeds maximum allowed");
+        }
+        
+        if (refCount > MAX_REFS) {
+            throw std::invalid_argument("Number of references exceeds maximum allowed");
+        }
+        
+        if (isSpecial) {
+            validateSpecial(data, bitSize, references, refCount);
+        }
+        
+        assignData(data, bitSize);
+        for (size_t i = 0; i < refCount; ++i) {
+            references_[i] = references[i];
+        }
+        refsCount_ = static_cast<uint8_t>(refCount);
+        trackCell(sizeof(Cell));
+    }
+    
+    void Cell::assignData(const uint8_t* data, size_t bitSize) {
+        size_t byteSize = (bitSize + 7) / 8;
+        if (byteSize > 0) {
+            std::memcpy(data_, data, byteSize);
+        }
+        std::memset(data_ + byteSize, 0, MAX_BYTES - byteSize);
+        
+        // Обнуляємо біти після кінця даних (наприклад, completion tag з BOC)
+        if (bitSize % 8 != 0) {
+            data_[byteSize - 1] &= static_cast<uint8_t>(0xFF << (8 - bitSize % 8));
+        }
+        bitSize_ = static_cast<uint16_t>(bitSize);
     }
     
     void Cell::storeUInt(size_t bits, uint64_t value) {
-        CellBuilder builder;
-        builder.storeUInt(bits, value);
-        auto builtCell = builder.build();
+        if (bits > MAX_BITS) {
+            throw std::invalid_argument("Bits count cannot exceed MAX_BITS");
+        }
+        
+        if (bits == 0) {
+            return;
+        }
         
-        // Copy data from built cell to this cell
-        data_ = builtCell->data_;
-        bitSize_ = builtCell->bitSize_;
+        // Дописуємо безпосередньо у вбудований буфер: біти після bitSize_ завжди нульові
+        checkCapacity(bits);
+        BitString::writeUInt(data_, MAX_BYTES, bitSize_, bits, value);
+        bitSize_ = static_cast<uint16_t>(bitSize_ + bits);
+        invalidateHash();
     }
     
     void Cell::storeInt(size_t bits, int64_t value) {
-        CellBuilder builder;
-        builder.storeInt(bits, value);
-        auto builtCell = builder.build();
+        if (bits > MAX_BITS) {
+            throw std::invalid_argument("Bits count cannot exceed MAX_BITS");
+        }
+        
+        if (bits == 0) {
+            return;
+        }
         
-        // Copy data from built cell to this cell
-        data_ = builtCell->data_;
-        bitSize_ = builtCell->bitSize_;
+        checkCapacity(bits);
+        BitString::writeInt(data_, MAX_BYTES, bitSize_, bits, value);
+        bitSize_ = static_cast<uint16_t>(bitSize_ + bits);
+        invalidateHash();
     }
     
     void Cell::storeBytes(const std::vector<uint8_t>& bytes) {
-        CellBuilder builder;
-        builder.storeBytes(bytes);
-        auto builtCell = builder.build();
+        storeBits(bytes.data(), bytes.size() * 8);
+    }
+    
+    void Cell::storeBits(const uint8_t* data, size_t bitLength, size_t bitOffset) {
+        if (bitLength == 0) {
+            return;
+        }
+        
+        if (data == nullptr) {
+            throw std::invalid_argument("Cannot store bits from null buffer");
+        }
+        
+        checkCapacity(bitLength);
+        BitString::copyBits(data_, bitSize_, data, bitOffset, bitLength);
+        bitSize_ = static_cast<uint16_t>(bitSize_ + bitLength);
+        invalidateHash();
+    }
+    
+    void Cell::storeUInt256(size_t bits, const UInt256& value) {
+        checkUInt256(bits, value);
+        if (bits == 0) {
+            return;
+        }
         
-        // Copy data from built cell to this cell
-        data_ = builtCell->data_;
-        bitSize_ = builtCell->bitSize_;
+        checkCapacity(bits);
+        BitString::writeUInt256(data_, MAX_BYTES, bitSize_, bits, value);
+        bitSize_ = static_cast<uint16_t>(bitSize_ + bits);
+        invalidateHash();
     }
     
-    void Cell::addReference(std::shared_ptr<Cell> cell) {
+    void Cell::storeVarUInt(size_t maxBytes, const UInt256& value) {
+        unsigned lengthBits;
+        size_t length;
+        varUIntLayout(maxBytes, value, lengthBits, length);
+        
+        size_t bits = lengthBits + length * 8;
+        checkCapacity(bits);
+        writeVarUInt(data_, bitSize_, lengthBits, length, value);
+        bitSize_ = static_cast<uint16_t>(bitSize_ + bits);
+        invalidateHash();
+    }
+    
+    void Cell::storeCoins(const UInt256& amount) {
+        storeVarUInt(COINS_MAX_BYTES, amount);
+    }
+    
+    void Cell::addReference(CellRef cell) {
         if (!cell) {
             throw std::invalid_argument("Cannot add null reference");
         }
         
-        if (references_.size() >= MAX_REFS) {
+        if (refsCount_ >= MAX_REFS) {
             throw std::overflow_error("Maximum number of references reached");
         }
         
-        references_.push_back(cell);
+        references_[refsCount_++] = cell;
+        invalidateHash();
     }
     
     std::vector<uint8_t> Cell::getData() const {
+        return std::vector<uint8_t>(data_, data_ + (bitSize_ + 7) / 8);
+    }
+    
+    const uint8_t* Cell::getRawData() const {
         return data_;
     }
     
@@ -81,33 +495,569 @@ namespace cton {
         return bitSize_;
     }
     
-    std::vector<std::weak_ptr<Cell>> Cell::getReferences() const {
-        // Convert shared_ptr to weak_ptr
-        std::vector<std::weak_ptr<Cell>> weakRefs;
-        weakRefs.reserve(references_.size());
-        
-        for (const auto& ref : references_) {
-            weakRefs.push_back(ref);
+    std::vector<CellRef> Cell::getReferences() const {
+        return std::vector<CellRef>(references_, references_ + refsCount_);
+    }
+    
+    const CellRef& Cell::getReference(size_t index) const {
+        if (index >= refsCount_) {
+            throw std::out_of_range("Reference index out of range");
         }
-        
-        return weakRefs;
+        return references_[index];
     }
     
     size_t Cell::getRefsCount() const {
-        return references_.size();
+        return refsCount_;
     }
     
     bool Cell::isSpecial() const {
         return isSpecial_;
     }
     
+    CellType Cell::getType() const {
+        if (!isSpecial_ || bitSize_ < 8) {
+            return CellType::Ordinary;
+        }
+        return static_cast<CellType>(data_[0]);
+    }
+    
+    uint8_t Cell::getLevelMask() const {
+        ensureHash();
+        return levelMask_;
+    }
+    
+    unsigned Cell::getLevel() const {
+        uint8_t mask = getLevelMask();
+        unsigned level = 0;
+        for (; mask != 0; mask >>= 1) {
+            ++level;
+        }
+        return level;
+    }
+    
+    Cell::Hash Cell::hash() const {
+        ensureHash();
+        return hash_;
+    }
+    
+    Cell::Hash Cell::hash(unsigned level) const {
+        ensureHash();
+        if (!levelHashes_) {
+            return hash_;
+        }
+        return levelHashes_->hashes[hashIndex(levelMask_, level)];
+    }
+    
+    uint16_t Cell::depth() const {
+        ensureHash();
+        return depth_;
+    }
+    
+    uint16_t Cell::depth(unsigned level) const {
+        ensureHash();
+        if (!levelHashes_) {
+            return depth_;
+        }
+        return levelHashes_->depths[hashIndex(levelMask_, level)];
+    }
+    
+    void Cell::hashTree(const CellRef& root, unsigned threads) {
+        if (!root) {
+            throw std::invalid_argument("Cannot hash null cell");
+        }
+        auto isReady = [](const Cell* cell) {
+            return cell->hashState_.load(std::memory_order_acquire) == HASH_STATE_READY;
+        };
+        if (isReady(root.get())) {
+            return;
+        }
+        
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        
+        if (threads == 1) {
+            hashSubgraph(root.get());
+            return;
+        }
+        
+        // Обхід у зворотному порядку без рекурсії; хешовані піддерева не відвідуються
+        struct Frame {
+            const Cell* cell;
+            uint32_t height;
+            uint8_t next;
+        };
+        std::vector<Frame> stack;
+        
+        // Висота комірки - на одиницю більша за найбільшу висоту нехешованих дочірніх;
+        // у таблиці висота записується, коли комірку знято зі стеку
+        HeightTable heights;
+        std::vector<std::pair<const Cell*, uint32_t>> postOrder;
+        bool inserted;
+        heights.findOrInsert(root.get(), inserted);
+        stack.push_back(Frame{root.get(), 0, 0});
+        uint32_t maxHeight = 0;
+        while (!stack.empty()) {
+            Frame& frame = stack.back();
+            if (frame.next < frame.cell->refsCount_) {
+                const Cell* child = frame.cell->references_[frame.next++].get();
+                if (isReady(child)) {
+                    continue;
+                }
+                size_t slot = heights.findOrInsert(child, inserted);
+                if (!inserted) {
+                    // Спільна комірка вже оброблена (у DAG предки не повторюються)
+                    frame.height = std::max(frame.height, heights.value(slot) + 1);
+                    continue;
+                }
+                stack.push_back(Frame{child, 0, 0});
+                continue;
+            }
+            
+            uint32_t height = frame.height;
+            bool existing;
+            heights.value(heights.findOrInsert(frame.cell, existing)) = height;
+            postOrder.push_back(std::make_pair(frame.cell, height));
+            maxHeight = std::max(maxHeight, height);
+            stack.pop_back();
+            if (!stack.empty()) {
+                stack.back().height = std::max(stack.back().height, height + 1);
+            }
+        }
+        
+        if (postOrder.size() < PARALLEL_HASH_MIN_CELLS) {
+            // Зворотний порядок вже йде знизу вгору
+            for (const auto& entry : postOrder) {
+                entry.first->ensureHash();
+            }
+            return;
+        }
+        
+        // Сортування підрахунком за висотою: шар h - відрізок [layerStart[h], layerStart[h + 1])
+        size_t layerCount = static_cast<size_t>(maxHeight) + 1;
+        std::vector<size_t> layerStart(layerCount + 1, 0);
+        for (const auto& entry : postOrder) {
+            ++layerStart[entry.second + 1];
+        }
+        for (size_t h = 0; h < layerCount; ++h) {
+            layerStart[h + 1] += layerStart[h];
+        }
+        std::vector<const Cell*> layers(postOrder.size());
+        {
+            std::vector<size_t> fill(layerStart.begin(), layerStart.end() - 1);
+            for (const auto& entry : postOrder) {
+                layers[fill[entry.second]++] = entry.first;
+            }
+        }
+        
+        // Потоків понад кількість порцій у найширшому шарі лише чекали б на бар'єрі
+        size_t widestLayer = 0;
+        for (size_t h = 0; h < layerCount; ++h) {
+            widestLayer = std::max(widestLayer, layerStart[h + 1] - layerStart[h]);
+        }
+        size_t usefulThreads = (widestLayer + PARALLEL_HASH_CHUNK - 1) / PARALLEL_HASH_CHUNK;
+        threads = static_cast<unsigned>(std::min<size_t>(threads, usefulThreads));
+        
+        std::unique_ptr<std::atomic<size_t>[]> cursors(new std::atomic<size_t>[layerCount]);
+        for (size_t h = 0; h < layerCount; ++h) {
+            cursors[h].store(0, std::memory_order_relaxed);
+        }
+        LayerBarrier barrier(threads);
+        std::mutex errorMutex;
+        std::exception_ptr error;
+        std::atomic<bool> failed(false);
+        
+        auto work = [&]() {
+            for (size_t h = 0; h < layerCount; ++h) {
+                size_t begin = layerStart[h];
+                size_t size = layerStart[h + 1] - begin;
+                while (!failed.load(std::memory_order_relaxed)) {
+                    size_t first = cursors[h].fetch_add(PARALLEL_HASH_CHUNK, std::memory_order_relaxed);
+                    if (first >= size) {
+                        break;
+                    }
+                    size_t last = std::min(size, first + PARALLEL_HASH_CHUNK);
+                    try {
+                        hashCells(layers.data() + begin + first, last - first);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(errorMutex);
+                        if (!error) {
+                            error = std::current_exception();
+                        }
+                        failed.store(true, std::memory_order_relaxed);
+                    }
+                }
+                // Наступний шар читає хеші цього шару
+                barrier.wait();
+            }
+        };
+        
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        try {
+            for (unsigned t = 1; t < threads; ++t) {
+                workers.emplace_back(work);
+            }
+        } catch (const std::system_error&) {
+            // Запущені потоки вже можуть чекати на бар'єрі: зменшуємо його до фактичної
+            // кількості учасників, а їхню частку шарів забирає поточний потік через курсори
+            barrier.resize(workers.size() + 1);
+        }
+        work();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    
+    void Cell::hashCells(const Cell* const* cells, size_t count) {
+        // Звичайні комірки без рівнів (один хеш) збираються в пакет для векторного SHA-256,
+        // решта хешується по одній
+        uint8_t reprs[PARALLEL_HASH_CHUNK][MAX_REPR_SIZE];
+        size_t sizes[PARALLEL_HASH_CHUNK];
+        const uint8_t* messages[PARALLEL_HASH_CHUNK];
+        uint8_t* digests[PARALLEL_HASH_CHUNK];
+        const Cell* batch[PARALLEL_HASH_CHUNK];
+        LevelHashes hashes[PARALLEL_HASH_CHUNK];
+        
+        size_t i = 0;
+        while (i < count) {
+            size_t batchSize = 0;
+            for (; i < count && batchSize < PARALLEL_HASH_CHUNK; ++i) {
+                const Cell* cell = cells[i];
+                if (cell->hashState_.load(std::memory_order_acquire) == HASH_STATE_READY) {
+                    continue;
+                }
+                uint8_t levelMask = 0;
+                for (size_t j = 0; j < cell->refsCount_; ++j) {
+                    levelMask |= cell->references_[j]->getLevelMask();
+                }
+                if (cell->isSpecial_ || levelMask != 0) {
+                    cell->ensureHash();
+                    continue;
+                }
+                
+                LevelHashes& result = hashes[batchSize];
+                uint16_t maxChildDepth;
+                sizes[batchSize] = writeRepresentation(reprs[batchSize], cell->refsCount_, cell->data_, cell->bitSize_,
+                                                       nullptr, cell->references_, cell->refsCount_, 0, maxChildDepth);
+                result.depths[0] = cell->refsCount_ == 0 ? 0 : nextDepth(maxChildDepth);
+                result.levelMask = 0;
+                result.hashCount = 1;
+                messages[batchSize] = reprs[batchSize];
+                digests[batchSize] = result.hashes[0].data();
+                batch[batchSize++] = cell;
+            }
+            
+            Sha256::hashBatch(messages, sizes, digests, batchSize);
+            for (size_t j = 0; j < batchSize; ++j) {
+                batch[j]->publishHash(hashes[j]);
+            }
+        }
+    }
+    
+    void Cell::hashSubgraph(const Cell* root) {
+        // Комірка хешується одразу після дочірніх, поки їхні хеші ще в кеші
+        // процесора, а спільні піддерева відсікає сам кеш хешу
+        auto notReady = [](const Cell* cell) {
+            return cell->hashState_.load(std::memory_order_acquire) != HASH_STATE_READY;
+        };
+        CellTraversal traversal(root, TraversalOrder::PostOrder, false, CellTraversal::UNLIMITED_DEPTH, notReady);
+        for (; traversal.valid(); traversal.next()) {
+            traversal.cell()->ensureHash();
+        }
+    }
+    
+    void Cell::ensureHash() const {
+        if (hashState_.load(std::memory_order_acquire) == HASH_STATE_READY) {
+            return;
+        }
+        // Нехешовані дочірні комірки обходяться з явним стеком: рекурсія через
+        // getLevelMask/depth/hash дочірніх переповнила б стек на довгому ланцюжку
+        for (size_t i = 0; i < refsCount_; ++i) {
+            if (references_[i]->hashState_.load(std::memory_order_acquire) != HASH_STATE_READY) {
+                hashSubgraph(this);
+                return;
+            }
+        }
+        computeHash();
+    }
+    
+    void Cell::computeHash() const {
+        LevelHashes result;
+        computeLevelHashes(data_, bitSize_, references_, refsCount_, isSpecial_, result);
+        publishHash(result);
+    }
+    
+    void Cell::validateSpecial(const uint8_t* data,
+                               size_t bitSize,
+                               const CellRef* references,
+                               size_t refCount) {
+        if (bitSize < 8) {
+            throw std::invalid_argument("Special cell must contain type byte");
+        }
+        
+        switch (static_cast<CellType>(data[0])) {
+            case CellType::PrunedBranch: {
+                if (bitSize < 16) {
+                    throw std::invalid_argument("Pruned branch must contain level mask");
+                }
+                uint8_t mask = data[1];
+                if (mask == 0 || mask > 7) {
+                    throw std::invalid_argument("Invalid pruned branch level mask");
+                }
+                if (refCount != 0 || bitSize != 16 + countBits(mask) * (HASH_SIZE + 2) * 8) {
+                    throw std::invalid_argument("Invalid pruned branch size");
+                }
+                break;
+            }
+            case CellType::Library:
+                if (refCount != 0 || bitSize != LIBRARY_BITS) {
+                    throw std::invalid_argument("Invalid library cell size");
+                }
+                break;
+            case CellType::MerkleProof:
+                if (refCount != 1 || bitSize != MERKLE_PROOF_BITS) {
+                    throw std::invalid_argument("Invalid Merkle proof size");
+                }
+                if (std::memcmp(data + 1, references[0]->hash(0).data(), HASH_SIZE) != 0 ||
+                    readDepth(data + 1 + HASH_SIZE) != references[0]->depth(0)) {
+                    throw std::invalid_argument("Merkle proof does not match its child");
+                }
+                break;
+            case CellType::MerkleUpdate:
+                if (refCount != 2 || bitSize != MERKLE_UPDATE_BITS) {
+                    throw std::invalid_argument("Invalid Merkle update size");
+                }
+                for (size_t i = 0; i < 2; ++i) {
+                    if (std::memcmp(data + 1 + i * HASH_SIZE, references[i]->hash(0).data(), HASH_SIZE) != 0 ||
+                        readDepth(data + 1 + 2 * HASH_SIZE + i * 2) != references[i]->depth(0)) {
+                        throw std::invalid_argument("Merkle update does not match its children");
+                    }
+                }
+                break;
+            default:
+                throw std::invalid_argument("Unknown special cell type");
+        }
+    }
+    
+    void Cell::computeLevelHashes(const uint8_t* data,
+                                  size_t bitSize,
+                                  const CellRef* references,
+                                  size_t refCount,
+                                  bool isSpecial,
+                                  LevelHashes& result) {
+        CellType type = isSpecial && bitSize >= 8 ? static_cast<CellType>(data[0]) : CellType::Ordinary;
+        bool merkle = type == CellType::MerkleProof || type == CellType::MerkleUpdate;
+        
+        // Маска рівнів: у звичайних комірок - об'єднання масок дочірніх, у Меркла - зсунута на рівень
+        uint8_t levelMask = 0;
+        if (type == CellType::PrunedBranch) {
+            levelMask = data[1];
+        } else if (type != CellType::Library) {
+            for (size_t i = 0; i < refCount; ++i) {
+                levelMask |= references[i]->getLevelMask();
+            }
+            if (merkle) {
+                levelMask >>= 1;
+            }
+        }
+        
+        unsigned hashCount = countBits(levelMask) + 1;
+        unsigned level = 0;
+        for (uint8_t mask = levelMask; mask != 0; mask >>= 1) {
+            ++level;
+        }
+        
+        // Обрізана гілка зберігає хеші і глибини нижчих рівнів у своїх даних
+        unsigned firstComputed = 0;
+        if (type == CellType::PrunedBranch) {
+            firstComputed = hashCount - 1;
+            for (unsigned i = 0; i < firstComputed; ++i) {
+                std::memcpy(result.hashes[i].data(), data + 2 + i * HASH_SIZE, HASH_SIZE);
+                result.depths[i] = readDepth(data + 2 + firstComputed * HASH_SIZE + i * 2);
+            }
+        }
+        
+        uint8_t repr[MAX_REPR_SIZE];
+        for (unsigned levelIndex = 0, hashNumber = 0; levelIndex <= level; ++levelIndex) {
+            if (levelIndex != 0 && !(levelMask & (1u << (levelIndex - 1)))) {
+                continue;
+            }
+            if (hashNumber < firstComputed) {
+                ++hashNumber;
+                continue;
+            }
+            
+            // Представлення рівня: d1 d2 (дані з completion tag | хеш попереднього рівня)
+            // глибини_посилань хеші_посилань; комірки Меркла посилаються на наступний рівень дочірніх
+            uint8_t appliedMask = static_cast<uint8_t>(levelMask & ((1u << levelIndex) - 1));
+            uint8_t d1 = static_cast<uint8_t>(refCount + (isSpecial ? 8 : 0) + appliedMask * 32);
+            const uint8_t* previousHash = hashNumber == firstComputed ? nullptr : result.hashes[hashNumber - 1].data();
+            unsigned childLevel = merkle ? levelIndex + 1 : levelIndex;
+            uint16_t maxChildDepth;
+            size_t pos = writeRepresentation(repr, d1, data, bitSize, previousHash, references, refCount,
+                                             childLevel, maxChildDepth);
+            
+            Sha256::hash(repr, pos, result.hashes[hashNumber].data());
+            result.depths[hashNumber] = refCount == 0 ? 0 : nextDepth(maxChildDepth);
+            ++hashNumber;
+        }
+        
+        result.levelMask = levelMask;
+        result.hashCount = static_cast<uint8_t>(hashCount);
+    }
+    
+    void Cell::publishHash(const LevelHashes& hashes) const {
+        // Публікуємо результат; якщо інший потік вже обчислює, чекаємо на нього
+        uint8_t expected = HASH_STATE_EMPTY;
+        if (hashState_.compare_exchange_strong(expected, HASH_STATE_BUSY, std::memory_order_acq_rel)) {
+            hash_ = hashes.hashes[hashes.hashCount - 1];
+            depth_ = hashes.depths[hashes.hashCount - 1];
+            levelMask_ = hashes.levelMask;
+            // Окрема пам'ять потрібна лише коміркам з обрізаними гілками
+            assignLevelHashes(hashes.hashCount > 1 ? &hashes : nullptr);
+            hashState_.store(HASH_STATE_READY, std::memory_order_release);
+        } else {
+            while (hashState_.load(std::memory_order_acquire) != HASH_STATE_READY) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    
+    CellRef Cell::createPrunedBranch(const Cell& cell, unsigned level) {
+        uint8_t cellMask = cell.getLevelMask();
+        unsigned cellLevel = cell.getLevel();
+        if (level == 0 || level > MAX_LEVEL || level <= cellLevel) {
+            throw std::invalid_argument("Invalid pruned branch level");
+        }
+        
+        // Хеші і глибини всіх значущих рівнів комірки
+        uint8_t mask = static_cast<uint8_t>(cellMask | (1u << (level - 1)));
+        CellBuilder builder;
+        builder.setSpecial();
+        builder.storeUInt(8, static_cast<uint64_t>(CellType::PrunedBranch));
+        builder.storeUInt(8, mask);
+        for (unsigned i = 0; i <= cellLevel; ++i) {
+            if (i == 0 || (cellMask & (1u << (i - 1)))) {
+                Hash h = cell.hash(i);
+                builder.storeBits(h.data(), HASH_SIZE * 8);
+            }
+        }
+        for (unsigned i = 0; i <= cellLevel; ++i) {
+            if (i == 0 || (cellMask & (1u << (i - 1)))) {
+                builder.storeUInt(16, cell.depth(i));
+            }
+        }
+        return builder.build();
+    }
+    
+    CellRef Cell::createMerkleProof(const CellRef& root) {
+        if (!root) {
+            throw std::invalid_argument("Cannot create Merkle proof of null cell");
+        }
+        
+        CellBuilder builder;
+        builder.setSpecial();
+        builder.storeUInt(8, static_cast<uint64_t>(CellType::MerkleProof));
+        Hash h = root->hash(0);
+        builder.storeBits(h.data(), HASH_SIZE * 8);
+        builder.storeUInt(16, root->depth(0));
+        builder.storeRef(root);
+        return builder.build();
+    }
+    
+    CellRef Cell::createMerkleUpdate(const CellRef& from, const CellRef& to) {
+        if (!from || !to) {
+            throw std::invalid_argument("Cannot create Merkle update of null cell");
+        }
+        
+        CellBuilder builder;
+        builder.setSpecial();
+        builder.storeUInt(8, static_cast<uint64_t>(CellType::MerkleUpdate));
+        Hash fromHash = from->hash(0);
+        Hash toHash = to->hash(0);
+        builder.storeBits(fromHash.data(), HASH_SIZE * 8);
+        builder.storeBits(toHash.data(), HASH_SIZE * 8);
+        builder.storeUInt(16, from->depth(0));
+        builder.storeUInt(16, to->depth(0));
+        builder.storeRef(from);
+        builder.storeRef(to);
+        return builder.build();
+    }
+    
+    CellRef Cell::createLibrary(const Hash& libraryHash) {
+        CellBuilder builder;
+        builder.setSpecial();
+        builder.storeUInt(8, static_cast<uint64_t>(CellType::Library));
+        builder.storeBits(libraryHash.data(), HASH_SIZE * 8);
+        return builder.build();
+    }
+    
+    void Cell::destroy() const noexcept {
+        // Комірки, що чекають знищення, зв'язані в список через буфер даних
+        // (дані вже не потрібні), тому довгий ланцюжок посилань не вичерпує стек
+        Cell* pending = const_cast<Cell*>(this);
+        Cell* none = nullptr;
+        std::memcpy(pending->data_, &none, sizeof(Cell*));
+        while (pending != nullptr) {
+            Cell* cell = pending;
+            std::memcpy(&pending, cell->data_, sizeof(Cell*));
+            for (size_t i = 0; i < cell->refsCount_; ++i) {
+                Cell* child = cell->references_[i].detach();
+                if (child != nullptr && child->dropReference()) {
+                    std::memcpy(child->data_, &pending, sizeof(Cell*));
+                    pending = child;
+                }
+            }
+            if (cell->arena_ != nullptr) {
+                // Пам'ять належить арені і звільняється разом з нею
+                CellArena* arena = cell->arena_;
+                cell->~Cell();
+                arena->releaseCell();
+            } else {
+                delete cell;
+            }
+        }
+    }
+    
+    void Cell::assignLevelHashes(const LevelHashes* hashes) const {
+        if (levelHashes_) {
+            liveCellBytes.fetch_sub(sizeof(LevelHashes), std::memory_order_relaxed);
+        }
+        levelHashes_.reset(hashes != nullptr ? new LevelHashes(*hashes) : nullptr);
+        if (levelHashes_) {
+            liveCellBytes.fetch_add(sizeof(LevelHashes), std::memory_order_relaxed);
+        }
+    }
+    
+    size_t Cell::memoryFootprint() const {
+        return sizeof(Cell) + (levelHashes_ ? sizeof(LevelHashes) : 0);
+    }
+    
+    size_t Cell::liveCount() {
+        return liveCellCount.load(std::memory_order_relaxed);
+    }
+    
+    size_t Cell::liveBytes() {
+        return liveCellBytes.load(std::memory_order_relaxed);
+    }
+    
+    void Cell::invalidateHash() {
+        hashState_.store(HASH_STATE_EMPTY, std::memory_order_release);
+    }
+    
     void Cell::checkCapacity(size_t bitCount) {
         if (bitSize_ + bitCount > MAX_BITS) {
             throw std::overflow_error("Not enough space in cell");
         }
     }
     
-    CellBuilder::CellBuilder() : bitOffset_(0) {}
+    CellBuilder::CellBuilder() : bitOffset_(0), refsCount_(0), isSpecial_(false) {
+        std::memset(buffer_, 0, Cell::MAX_BYTES);
+    }
     
     CellBuilder& CellBuilder::storeUInt(size_t bits, uint64_t value) {
         // Перевірка коректності параметрів
@@ -124,55 +1074,29 @@ namespace cton {
             throw std::overflow_error("Not enough space in cell for storing bits");
         }
         
-        // Розширення буфера при необхідності
-        size_t requiredBytes = (bitOffset_ + bits + 7) / 8;
-        if (buffer_.size() < requiredBytes) {
-            buffer_.resize(requiredBytes, 0);
+        BitString::writeUInt(buffer_, Cell::MAX_BYTES, bitOffset_, bits, value);
+        bitOffset_ += bits;
+        return *this;
+    }
+    
+    CellBuilder& CellBuilder::storeInt(size_t bits, int64_t value) {
+        if (bits > Cell::MAX_BITS) {
+            throw std::invalid_argument("Bits count cannot exceed MAX_BITS");
         }
         
-        // Запис бітів у буфер
-        size_t byteIndex = bitOffset_ / 8;
-        size_t bitIndex = bitOffset_ % 8;
+        if (bits == 0) {
+            return *this;
+        }
         
-        // Якщо біти поміщаються в один байт
-        if (bitIndex + bits <= 8) {
-            uint8_t mask = ((1ULL << bits) - 1) << (8 - bitIndex - bits);
-            buffer_[byteIndex] &= ~mask; // Очищення бітів
-            buffer_[byteIndex] |= (value << (8 - bitIndex - bits)) & mask; // Встановлення нових бітів
-        } else {
-            // Якщо біти розподілені між кількома байтами
-            size_t bitsLeft = bits;
-            size_t valueShift = 0;
-            
-            while (bitsLeft > 0) {
-                size_t bitsInCurrentByte = std::min(bitsLeft, 8 - bitIndex);
-                uint8_t mask = ((1ULL << bitsInCurrentByte) - 1) << (8 - bitIndex - bitsInCurrentByte);
-                
-                buffer_[byteIndex] &= ~mask; // Очищення бітів
-                buffer_[byteIndex] |= ((value >> valueShift) << (8 - bitIndex - bitsInCurrentByte)) & mask;
-                
-                bitsLeft -= bitsInCurrentByte;
-                valueShift += bitsInCurrentByte;
-                bitIndex = 0;
-                byteIndex++;
-                
-                // Розширення буфера при необхідності
-                if (byteIndex >= buffer_.size() && bitsLeft > 0) {
-                    buffer_.resize(byteIndex + 1, 0);
-                }
-            }
+        if (bitOffset_ + bits > Cell::MAX_BITS) {
+            throw std::overflow_error("Not enough space in cell for storing bits");
         }
         
+        BitString::writeInt(buffer_, Cell::MAX_BYTES, bitOffset_, bits, value);
         bitOffset_ += bits;
         return *this;
     }
     
-    CellBuilder& CellBuilder::storeInt(size_t bits, int64_t value) {
-        // Для від'ємних чисел використовуємо two's complement
-        uint64_t unsignedValue = static_cast<uint64_t>(value);
-        return storeUInt(bits, unsignedValue);
-    }
-    
     CellBuilder& CellBuilder::storeBytes(const std::vector<uint8_t>& data) {
         if (data.empty()) {
             return *this;
@@ -184,50 +1108,179 @@ namespace cton {
             throw std::overflow_error("Not enough space in cell for storing bytes");
         }
         
-        // Розширення буфера
-        size_t requiredBytes = (bitOffset_ + bitsNeeded + 7) / 8;
-        if (buffer_.size() < requiredBytes) {
-            buffer_.resize(requiredBytes, 0);
+        // Копіювання байтів (з векторним зсувом, якщо позиція не вирівняна)
+        BitString::copyBits(buffer_, bitOffset_, data.data(), 0, bitsNeeded);
+        bitOffset_ += bitsNeeded;
+        return *this;
+    }
+    
+    CellBuilder& CellBuilder::storeBits(const uint8_t* data, size_t bitLength, size_t bitOffset) {
+        if (bitLength == 0) {
+            return *this;
+        }
+        
+        if (data == nullptr) {
+            throw std::invalid_argument("Cannot store bits from null buffer");
         }
         
-        // Копіювання байтів
-        size_t byteIndex = bitOffset_ / 8;
-        size_t bitIndex = bitOffset_ % 8;
+        // Перевірка чи вистачить місця в комірці
+        if (bitOffset_ + bitLength > Cell::MAX_BITS) {
+            throw std::overflow_error("Not enough space in cell for storing bits");
+        }
         
-        if (bitIndex == 0) {
-            // Просте копіювання, якщо вирівняно по байтах
-            std::memcpy(buffer_.data() + byteIndex, data.data(), data.size());
-        } else {
-            // Зсув бітів при копіюванні
-            for (size_t i = 0; i < data.size(); ++i) {
-                uint16_t combined = (buffer_[byteIndex + i] << 8) | data[i];
-                buffer_[byteIndex + i] = (combined >> bitIndex) & 0xFF;
-                if (byteIndex + i + 1 < buffer_.size()) {
-                    buffer_[byteIndex + i + 1] |= (combined << (8 - bitIndex)) & 0xFF;
-                }
-            }
+        BitString::copyBits(buffer_, bitOffset_, data, bitOffset, bitLength);
+        bitOffset_ += bitLength;
+        return *this;
+    }
+    
+    CellBuilder& CellBuilder::storeUInt256(size_t bits, const UInt256& value) {
+        checkUInt256(bits, value);
+        if (bits == 0) {
+            return *this;
         }
         
-        bitOffset_ += bitsNeeded;
+        if (bitOffset_ + bits > Cell::MAX_BITS) {
+            throw std::overflow_error("Not enough space in cell for storing bits");
+        }
+        
+        BitString::writeUInt256(buffer_, Cell::MAX_BYTES, bitOffset_, bits, value);
+        bitOffset_ += bits;
         return *this;
     }
     
-    CellBuilder& CellBuilder::storeRef(std::shared_ptr<Cell> cell) {
+    CellBuilder& CellBuilder::storeVarUInt(size_t maxBytes, const UInt256& value) {
+        unsigned lengthBits;
+        size_t length;
+        varUIntLayout(maxBytes, value, lengthBits, length);
+        
+        size_t bits = lengthBits + length * 8;
+        if (bitOffset_ + bits > Cell::MAX_BITS) {
+            throw std::overflow_error("Not enough space in cell for storing bits");
+        }
+        
+        writeVarUInt(buffer_, bitOffset_, lengthBits, length, value);
+        bitOffset_ += bits;
+        return *this;
+    }
+    
+    CellBuilder& CellBuilder::storeCoins(const UInt256& amount) {
+        return storeVarUInt(COINS_MAX_BYTES, amount);
+    }
+    
+    CellBuilder& CellBuilder::storeSlice(const CellSlice& slice) {
+        // Перевірка обох обмежень до запису, щоб не залишити будівельник частково зміненим
+        if (bitOffset_ + slice.remainingBits() > Cell::MAX_BITS) {
+            throw std::overflow_error("Not enough space in cell for storing slice");
+        }
+        
+        if (refsCount_ + slice.remainingRefs() > Cell::MAX_REFS) {
+            throw std::overflow_error("Maximum number of references reached");
+        }
+        
+        storeBits(slice.getData(), slice.remainingBits(), slice.getBitOffset());
+        for (size_t i = 0; i < slice.remainingRefs(); ++i) {
+            references_[refsCount_++] = slice.preloadRef(i);
+        }
+        return *this;
+    }
+    
+    CellBuilder& CellBuilder::storeSnakeBytes(const uint8_t* data, size_t size) {
+        size_t headBytes = std::min(size, (Cell::MAX_BITS - bitOffset_) / 8);
+        if (headBytes < size && refsCount_ != 0) {
+            // Інакше читання пішло б за чужим посиланням замість хвоста
+            throw std::invalid_argument("Snake tail must be the first reference");
+        }
+        
+        // Хвіст будується з останньої комірки, тож кожна створюється один раз
+        const size_t chunkBytes = Cell::MAX_BITS / 8;
+        size_t tailBytes = size - headBytes;
+        CellRef tail;
+        for (size_t chunk = (tailBytes + chunkBytes - 1) / chunkBytes; chunk-- > 0;) {
+            size_t begin = headBytes + chunk * chunkBytes;
+            size_t count = std::min(chunkBytes, size - begin);
+            CellRef next = tail;
+            tail = Cell::create(data + begin, count * 8, static_cast<const CellRef*>(&next),
+                                static_cast<size_t>(next ? 1 : 0));
+        }
+        
+        if (headBytes > 0) {
+            BitString::copyBits(buffer_, bitOffset_, data, 0, headBytes * 8);
+            bitOffset_ += headBytes * 8;
+        }
+        if (tail) {
+            references_[refsCount_++] = tail;
+        }
+        return *this;
+    }
+    
+    CellBuilder& CellBuilder::storeSnakeBytes(const std::vector<uint8_t>& bytes) {
+        return storeSnakeBytes(bytes.data(), bytes.size());
+    }
+    
+    CellBuilder& CellBuilder::storeSnakeString(const std::string& text) {
+        return storeSnakeBytes(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+    }
+    
+    CellBuilder& CellBuilder::storeRef(CellRef cell) {
         if (!cell) {
             throw std::invalid_argument("Cannot store null cell reference");
         }
         
-        if (references_.size() >= Cell::MAX_REFS) {
+        if (refsCount_ >= Cell::MAX_REFS) {
             throw std::overflow_error("Maximum number of references reached");
         }
         
-        references_.push_back(cell);
+        references_[refsCount_++] = cell;
+        return *this;
+    }
+    
+    CellBuilder& CellBuilder::setSpecial(bool special) {
+        isSpecial_ = special;
         return *this;
     }
     
-    std::shared_ptr<Cell> CellBuilder::build() {
-        // Створення комірки через new і shared_ptr
-        // This approach avoids the private constructor issue with make_shared
-        return std::shared_ptr<Cell>(new Cell(buffer_, bitOffset_, references_, false));
+    CellRef CellBuilder::build() {
+        // Дані копіюються з вбудованого буфера будівельника у вбудований буфер комірки
+        return Cell::create(static_cast<const uint8_t*>(buffer_), bitOffset_,
+                                      static_cast<const CellRef*>(references_), refsCount_, isSpecial_);
+    }
+    
+    CellRef CellBuilder::build(CellArena& arena) {
+        return arena.createCell(buffer_, bitOffset_, references_, refsCount_, isSpecial_);
+    }
+    
+    CellRef CellBuilder::build(CellInterner& interner) {
+        return interner.intern(buffer_, bitOffset_, references_, refsCount_, isSpecial_);
+    }
+    
+    bool operator==(const Cell& a, const Cell& b) {
+        return &a == &b || a.hash() == b.hash();
+    }
+    
+    bool operator!=(const Cell& a, const Cell& b) {
+        return !(a == b);
+    }
+    
+    size_t CellHash::operator()(const Cell& cell) const {
+        // Хеш представлення вже рівномірно розподілений - беремо перші байти
+        Cell::Hash h = cell.hash();
+        size_t result;
+        std::memcpy(&result, h.data(), sizeof(result));
+        return result;
+    }
+    
+    size_t CellHash::operator()(const CellRef& cell) const {
+        return cell ? (*this)(*cell) : 0;
+    }
+    
+    bool CellEqual::operator()(const Cell& a, const Cell& b) const {
+        return a == b;
+    }
+    
+    bool CellEqual::operator()(const CellRef& a, const CellRef& b) const {
+        if (!a || !b) {
+            return a == b;
+        }
+        return *a == *b;
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,102 @@
+// CellArena.cpp - реалізація арени для комірок
+// Author: Андрій Будильников (Sparky)
+// Bump allocator for cell graphs
+// Арена для размещения графов ячеек
+
+#include "../include/CellArena.h"
+#include <stdexcept>
+#include <algorithm>
+#include <new>
+#include <cassert>
+
+namespace cton {
+
+    CellArena::CellArena(size_t chunkSize, RefCountMode refCountMode)
+        : chunkSize_(chunkSize), refCountMode_(refCountMode), current_(nullptr), remaining_(0),
+          allocatedBytes_(0), reservedBytes_(0), liveCells_(0) {
+        if (chunkSize_ == 0) {
+            throw std::invalid_argument("Arena chunk size must be positive");
+        }
+    }
+
+    CellArena::~CellArena() {
+        // Контракт: жива комірка після цього вказувала б на звільнену пам'ять
+        assert(liveCells_.load(std::memory_order_acquire) == 0 && "CellArena destroyed with live cells");
+    }
+
+    CellRef CellArena::createCell(const uint8_t* data,
+                                                size_t bitSize,
+                                                const CellRef* references,
+                                                size_t refCount,
+                                                bool isSpecial) {
+        // Комірка разом з вбудованими даними і лічильником посилань розміщується в арені
+        void* memory = allocate(sizeof(Cell), alignof(Cell));
+        Cell* cell = new (memory) Cell(data, bitSize, references, refCount, isSpecial);
+        cell->arena_ = this;
+        cell->atomicRefCount_ = refCountMode_ == RefCountMode::Atomic;
+        liveCells_.fetch_add(1, std::memory_order_relaxed);
+        return CellRef(cell);
+    }
+
+    size_t CellArena::getAllocatedBytes() const {
+        return allocatedBytes_;
+    }
+
+    size_t CellArena::getReservedBytes() const {
+        return reservedBytes_;
+    }
+
+    RefCountMode CellArena::getRefCountMode() const {
+        return refCountMode_;
+    }
+
+    size_t CellArena::getChunkCount() const {
+        return chunks_.size();
+    }
+
+    size_t CellArena::getLiveCellCount() const {
+        return liveCells_.load(std::memory_order_relaxed);
+    }
+
+    void CellArena::releaseCell() noexcept {
+        liveCells_.fetch_sub(1, std::memory_order_release);
+    }
+
+    void* CellArena::do_allocate(size_t bytes, size_t alignment) {
+        if (bytes == 0) {
+            bytes = 1;
+        }
+
+        // Вирівнювання поточного вказівника
+        size_t padding = (alignment - reinterpret_cast<uintptr_t>(current_) % alignment) % alignment;
+        if (current_ == nullptr || padding + bytes > remaining_) {
+            addChunk(bytes + alignment);
+            padding = (alignment - reinterpret_cast<uintptr_t>(current_) % alignment) % alignment;
+        }
+
+        uint8_t* result = current_ + padding;
+        current_ += padding + bytes;
+        remaining_ -= padding + bytes;
+        allocatedBytes_ += bytes;
+        return result;
+    }
+
+    void CellArena::do_deallocate(void* p, size_t bytes, size_t alignment) {
+        // Пам'ять звільняється лише разом з ареною
+        (void)p;
+        (void)bytes;
+        (void)alignment;
+    }
+
+    bool CellArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+        return this == &other;
+    }
+
+    void CellArena::addChunk(size_t minSize) {
+        size_t size = std::max(chunkSize_, minSize);
+        chunks_.emplace_back(new uint8_t[size]);
+        current_ = chunks_.back().get();
+        remaining_ = size;
+        reservedBytes_ += size;
+    }
+}
@@ -0,0 +1,124 @@
+// CellEditor.cpp - реалізація редактора дерева комірок
+// Author: Андрій Будильников (Sparky)
+// Implementation of the copy-on-write cell editor
+// Реализация редактора дерева ячеек
+
+#include "../include/CellEditor.h"
+#include <stdexcept>
+#include <utility>
+
+namespace cton {
+
+    namespace {
+        /**
+         * @brief Створити копію комірки з іншим посиланням
+         */
+        CellRef withReference(const Cell& cell, size_t refIndex, const CellRef& child) {
+            CellRef references[Cell::MAX_REFS];
+            size_t refCount = cell.getRefsCount();
+            for (size_t i = 0; i < refCount; ++i) {
+                references[i] = cell.getReference(i);
+            }
+            references[refIndex] = child;
+            return Cell::create(cell.getRawData(), cell.getBitSize(), references, refCount, cell.isSpecial());
+        }
+    }
+
+    CellEditor::CellEditor(CellRef root) {
+        if (!root) {
+            throw std::invalid_argument("Root cell cannot be null");
+        }
+        path_.push_back(Frame{std::move(root), 0, false});
+    }
+
+    CellEditor& CellEditor::down(size_t refIndex) {
+        const CellRef& cell = path_.back().cell;
+        if (refIndex >= cell->getRefsCount()) {
+            throw std::out_of_range("Reference index out of range");
+        }
+        path_.push_back(Frame{cell->getReference(refIndex), refIndex, false});
+        return *this;
+    }
+
+    CellEditor& CellEditor::up() {
+        if (path_.size() == 1) {
+            throw std::out_of_range("Editor is already at the root");
+        }
+        propagate(path_.size() - 1);
+        path_.pop_back();
+        return *this;
+    }
+
+    CellEditor& CellEditor::toRoot() {
+        while (path_.size() > 1) {
+            up();
+        }
+        return *this;
+    }
+
+    size_t CellEditor::depth() const {
+        return path_.size() - 1;
+    }
+
+    const CellRef& CellEditor::current() const {
+        return path_.back().cell;
+    }
+
+    void CellEditor::replace(CellRef cell) {
+        if (!cell) {
+            throw std::invalid_argument("Replacement cell cannot be null");
+        }
+        Frame& frame = path_.back();
+        frame.cell = std::move(cell);
+        frame.modified = true;
+    }
+
+    void CellEditor::setData(const uint8_t* data, size_t bitSize) {
+        const Cell& cell = *path_.back().cell;
+        CellRef references[Cell::MAX_REFS];
+        size_t refCount = cell.getRefsCount();
+        for (size_t i = 0; i < refCount; ++i) {
+            references[i] = cell.getReference(i);
+        }
+        replace(Cell::create(data, bitSize, references, refCount, cell.isSpecial()));
+    }
+
+    void CellEditor::setReference(size_t refIndex, CellRef cell) {
+        if (!cell) {
+            throw std::invalid_argument("Reference cannot be null");
+        }
+        const Cell& parent = *path_.back().cell;
+        if (refIndex >= parent.getRefsCount()) {
+            throw std::out_of_range("Reference index out of range");
+        }
+        replace(withReference(parent, refIndex, cell));
+    }
+
+    CellRef CellEditor::root() {
+        // Знизу вгору, щоб кожен предок перебудовувався один раз
+        for (size_t pos = path_.size() - 1; pos > 0; --pos) {
+            propagate(pos);
+        }
+        return path_.front().cell;
+    }
+
+    CellRef CellEditor::replaceAt(const CellRef& root, const std::vector<size_t>& path, CellRef replacement) {
+        CellEditor editor(root);
+        for (size_t refIndex : path) {
+            editor.down(refIndex);
+        }
+        editor.replace(std::move(replacement));
+        return editor.root();
+    }
+
+    void CellEditor::propagate(size_t childPos) {
+        Frame& child = path_[childPos];
+        if (!child.modified) {
+            return;
+        }
+        Frame& parent = path_[childPos - 1];
+        parent.cell = withReference(*parent.cell, child.refIndex, child.cell);
+        parent.modified = true;
+        child.modified = false;
+    }
+}
@@ -0,0 +1,292 @@
+// CellGraph.cpp - реалізація компактного графа комірок
+// Author: Андрій Будильников (Sparky)
+// Implementation of the structure-of-arrays cell graph
+// Реализация компактного графа ячеек
+
+#include "../include/CellGraph.h"
+#include "../include/CellTraversal.h"
+#include "../include/Sha256.h"
+#include <unordered_map>
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace cton {
+
+    namespace {
+        const size_t HASH_BATCH_SIZE = 64;
+        const size_t MAX_REPR_SIZE = 2 + Cell::MAX_BYTES + Cell::MAX_REFS * (2 + Cell::HASH_SIZE);
+        const size_t MAX_INDEX = std::numeric_limits<uint32_t>::max();
+    }
+
+    CellGraph::CellGraph() {}
+
+    CellGraph CellGraph::fromCell(const CellRef& root) {
+        CellGraph graph;
+        if (!root) {
+            return graph;
+        }
+
+        // Зворотний post-order: батьківська комірка перед дочірніми
+        std::vector<const Cell*> order = CellTraversal::collect(root.get());
+        std::reverse(order.begin(), order.end());
+        if (order.size() > MAX_INDEX) {
+            throw std::overflow_error("Cell graph is too large");
+        }
+
+        std::unordered_map<const Cell*, Index> indices;
+        indices.reserve(order.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            indices[order[i]] = static_cast<Index>(i);
+        }
+
+        graph.cells_.reserve(order.size());
+        for (const Cell* cell : order) {
+            size_t refsCount = cell->getRefsCount();
+            graph.appendCell(cell->getRawData(), cell->getBitSize(), refsCount, cell->isSpecial(), cell->getLevelMask());
+            for (size_t j = 0; j < refsCount; ++j) {
+                graph.refs_.push_back(indices[cell->getReference(j).get()]);
+            }
+        }
+        graph.roots_.push_back(0);
+        return graph;
+    }
+
+    CellRef CellGraph::toCell(Index index) const {
+        checkIndex(index);
+        // Кеш лише для комірок піддерева, а не для всього графа
+        std::unordered_map<Index, CellRef> cache;
+        return materialize(index, cache);
+    }
+
+    size_t CellGraph::cellCount() const {
+        return cells_.size();
+    }
+
+    size_t CellGraph::rootCount() const {
+        return roots_.size();
+    }
+
+    CellGraph::Index CellGraph::root(size_t i) const {
+        if (i >= roots_.size()) {
+            throw std::out_of_range("Cell graph root index out of range");
+        }
+        return roots_[i];
+    }
+
+    size_t CellGraph::bitSize(Index index) const {
+        checkIndex(index);
+        return cells_[index].bitSize;
+    }
+
+    const uint8_t* CellGraph::data(Index index) const {
+        checkIndex(index);
+        return data_.data() + cells_[index].dataOffset;
+    }
+
+    size_t CellGraph::refCount(Index index) const {
+        checkIndex(index);
+        return cells_[index].refCount;
+    }
+
+    CellGraph::Index CellGraph::ref(Index index, size_t i) const {
+        checkIndex(index);
+        if (i >= cells_[index].refCount) {
+            throw std::out_of_range("Reference index out of range");
+        }
+        return refs_[cells_[index].firstRef + i];
+    }
+
+    bool CellGraph::isSpecial(Index index) const {
+        checkIndex(index);
+        return (cells_[index].flags & SPECIAL_FLAG) != 0;
+    }
+
+    uint8_t CellGraph::levelMask(Index index) const {
+        checkIndex(index);
+        return static_cast<uint8_t>(cells_[index].flags & 0x07);
+    }
+
+    void CellGraph::computeHashes() {
+        size_t count = cells_.size();
+        std::vector<Cell::Hash> hashes(count);
+        std::vector<uint16_t> depths(count);
+        std::unordered_map<Index, CellRef> materialized;
+
+        uint8_t reprs[HASH_BATCH_SIZE][MAX_REPR_SIZE];
+        size_t sizes[HASH_BATCH_SIZE];
+        const uint8_t* messages[HASH_BATCH_SIZE];
+        uint8_t* digests[HASH_BATCH_SIZE];
+        size_t batchSize = 0;
+        // Найбільший індекс у пакеті: дочірні комірки з меншим або рівним індексом можуть бути ще не пораховані
+        size_t batchHigh = 0;
+
+        // Від кінця: дочірні комірки завжди мають більший індекс
+        for (size_t i = count; i-- > 0;) {
+            const Descriptor& cell = cells_[i];
+            const Index* children = refs_.data() + cell.firstRef;
+
+            if ((cell.flags & (SPECIAL_FLAG | 0x07)) != 0) {
+                // Комірки з рівнями рахує Cell
+                CellRef full = materialize(static_cast<Index>(i), materialized);
+                hashes[i] = full->hash();
+                depths[i] = full->depth();
+                continue;
+            }
+
+            if (batchSize > 0) {
+                for (size_t j = 0; j < cell.refCount; ++j) {
+                    if (children[j] <= batchHigh) {
+                        Sha256::hashBatch(messages, sizes, digests, batchSize);
+                        batchSize = 0;
+                        break;
+                    }
+                }
+            }
+
+            // Представлення: d1, d2, дані з completion tag, глибини і хеші дочірніх комірок
+            uint8_t* repr = reprs[batchSize];
+            size_t fullBytes = cell.bitSize / 8;
+            size_t dataBytes = (cell.bitSize + 7) / 8;
+            size_t pos = 0;
+            repr[pos++] = cell.refCount;
+            repr[pos++] = static_cast<uint8_t>(fullBytes + dataBytes);
+            if (dataBytes > 0) {
+                std::memcpy(repr + pos, data_.data() + cell.dataOffset, dataBytes);
+                size_t tailBits = cell.bitSize % 8;
+                if (tailBits != 0) {
+                    repr[pos + dataBytes - 1] |= static_cast<uint8_t>(0x80 >> tailBits);
+                }
+                pos += dataBytes;
+            }
+            uint16_t maxChildDepth = 0;
+            for (size_t j = 0; j < cell.refCount; ++j) {
+                uint16_t childDepth = depths[children[j]];
+                maxChildDepth = std::max(maxChildDepth, childDepth);
+                repr[pos++] = static_cast<uint8_t>(childDepth >> 8);
+                repr[pos++] = static_cast<uint8_t>(childDepth);
+            }
+            for (size_t j = 0; j < cell.refCount; ++j) {
+                std::memcpy(repr + pos, hashes[children[j]].data(), Cell::HASH_SIZE);
+                pos += Cell::HASH_SIZE;
+            }
+            if (maxChildDepth == std::numeric_limits<uint16_t>::max()) {
+                throw std::overflow_error("Cell depth exceeds 65535");
+            }
+            depths[i] = cell.refCount == 0 ? 0 : static_cast<uint16_t>(maxChildDepth + 1);
+
+            if (batchSize == 0) {
+                batchHigh = i;
+            }
+            sizes[batchSize] = pos;
+            messages[batchSize] = repr;
+            digests[batchSize] = hashes[i].data();
+            if (++batchSize == HASH_BATCH_SIZE) {
+                Sha256::hashBatch(messages, sizes, digests, batchSize);
+                batchSize = 0;
+            }
+        }
+        Sha256::hashBatch(messages, sizes, digests, batchSize);
+
+        hashes_.swap(hashes);
+        depths_.swap(depths);
+    }
+
+    bool CellGraph::hasHashes() const {
+        return !cells_.empty() && hashes_.size() == cells_.size();
+    }
+
+    Cell::Hash CellGraph::hash(Index index) const {
+        checkIndex(index);
+        if (!hasHashes()) {
+            throw std::logic_error("Cell graph hashes are not computed");
+        }
+        return hashes_[index];
+    }
+
+    uint16_t CellGraph::depth(Index index) const {
+        checkIndex(index);
+        if (!hasHashes()) {
+            throw std::logic_error("Cell graph hashes are not computed");
+        }
+        return depths_[index];
+    }
+
+    size_t CellGraph::memoryUsage() const {
+        return sizeof(CellGraph) +
+               data_.capacity() +
+               cells_.capacity() * sizeof(Descriptor) +
+               (refs_.capacity() + roots_.capacity()) * sizeof(Index) +
+               hashes_.capacity() * sizeof(Cell::Hash) +
+               depths_.capacity() * sizeof(uint16_t);
+    }
+
+    void CellGraph::appendCell(const uint8_t* data, size_t bitSize, size_t refCount, bool special, uint8_t levelMask) {
+        size_t dataBytes = (bitSize + 7) / 8;
+        if (cells_.size() >= MAX_INDEX || data_.size() + dataBytes > MAX_INDEX || refs_.size() + refCount > MAX_INDEX) {
+            throw std::overflow_error("Cell graph is too large");
+        }
+
+        Descriptor cell;
+        cell.dataOffset = static_cast<uint32_t>(data_.size());
+        cell.firstRef = static_cast<uint32_t>(refs_.size());
+        cell.bitSize = static_cast<uint16_t>(bitSize);
+        cell.refCount = static_cast<uint8_t>(refCount);
+        cell.flags = static_cast<uint8_t>((levelMask & 0x07) | (special ? SPECIAL_FLAG : 0));
+
+        // Біти після bitSize (зокрема completion tag з BOC) обнуляються
+        data_.insert(data_.end(), data, data + dataBytes);
+        if (bitSize % 8 != 0) {
+            data_.back() &= static_cast<uint8_t>(0xFF << (8 - bitSize % 8));
+        }
+        cells_.push_back(cell);
+        hashes_.clear();
+        depths_.clear();
+    }
+
+    CellRef CellGraph::materialize(Index index, std::unordered_map<Index, CellRef>& cache) const {
+        // Явний стек: комірка створюється, коли всі її дочірні вже в cache
+        std::vector<Index> stack(1, index);
+        while (!stack.empty()) {
+            Index current = stack.back();
+            if (cache.count(current) != 0) {
+                stack.pop_back();
+                continue;
+            }
+
+            const Descriptor& cell = cells_[current];
+            const Index* children = refs_.data() + cell.firstRef;
+            bool ready = true;
+            for (size_t j = 0; j < cell.refCount; ++j) {
+                if (cache.count(children[j]) == 0) {
+                    stack.push_back(children[j]);
+                    ready = false;
+                }
+            }
+            if (!ready) {
+                continue;
+            }
+
+            CellRef refs[Cell::MAX_REFS];
+            for (size_t j = 0; j < cell.refCount; ++j) {
+                refs[j] = cache[children[j]];
+            }
+            CellRef created = Cell::create(data_.data() + cell.dataOffset, static_cast<size_t>(cell.bitSize),
+                                           static_cast<const CellRef*>(refs), static_cast<size_t>(cell.refCount),
+                                           (cell.flags & SPECIAL_FLAG) != 0);
+            if (created->getLevelMask() != (cell.flags & 0x07)) {
+                throw std::invalid_argument("Cell graph level mask mismatch");
+            }
+            cache[current] = created;
+            stack.pop_back();
+        }
+        return cache[index];
+    }
+
+    void CellGraph::checkIndex(Index index) const {
+        if (index >= cells_.size()) {
+            throw std::out_of_range("Cell graph index out of range");
+        }
+    }
+}
@@ -0,0 +1,143 @@
+// CellGraphStats.cpp - реалізація обліку пам'яті графа комірок
+// Author: Андрій Будильников (Sparky)
+// Implementation of cell graph memory accounting
+// Реализация учета памяти графа ячеек
+
+#include "../include/CellGraphStats.h"
+#include "../include/CellTraversal.h"
+#include <unordered_map>
+#include <algorithm>
+#include <limits>
+#include <cstring>
+
+namespace cton {
+
+    namespace {
+        // Розмір піддерева з повтореннями і його глибина
+        struct SubtreeInfo {
+            uint64_t treeCells;
+            uint32_t depth;
+        };
+
+        // Хеш представлення вже рівномірний: кошик - його байти
+        struct RepresentationHash {
+            size_t operator()(const Cell::Hash& hash) const {
+                size_t result;
+                std::memcpy(&result, hash.data(), sizeof(result));
+                return result;
+            }
+        };
+
+        inline uint64_t saturatingAdd(uint64_t a, uint64_t b) {
+            uint64_t sum = a + b;
+            return sum < a ? std::numeric_limits<uint64_t>::max() : sum;
+        }
+    }
+
+    CellGraphStats::CellGraphStats()
+        : cellCount(0), treeCellCount(0), totalBits(0), totalRefs(0), specialCells(0),
+          payloadBytes(0), overheadBytes(0), maxDepth(0) {}
+
+    uint64_t CellGraphStats::totalBytes() const {
+        return payloadBytes + overheadBytes;
+    }
+
+    double CellGraphStats::sharedRatio() const {
+        if (treeCellCount == 0) {
+            return 0.0;
+        }
+        return 1.0 - static_cast<double>(cellCount) / static_cast<double>(treeCellCount);
+    }
+
+    CellGraphStats CellGraphStats::compute(const CellRef& root) {
+        CellGraphStats stats;
+        if (!root) {
+            return stats;
+        }
+
+        // Зворотний порядок: значення дочірніх комірок уже пораховані
+        std::unordered_map<const Cell*, SubtreeInfo> subtrees;
+        SubtreeInfo rootInfo = {0, 0};
+        for (CellTraversal it(root.get()); it.valid(); it.next()) {
+            const Cell* cell = it.cell();
+            size_t refsCount = cell->getRefsCount();
+            SubtreeInfo info = {1, 0};
+            for (size_t i = 0; i < refsCount; ++i) {
+                const SubtreeInfo& child = subtrees[cell->getReference(i).get()];
+                info.treeCells = saturatingAdd(info.treeCells, child.treeCells);
+                info.depth = std::max(info.depth, child.depth + 1);
+            }
+            subtrees[cell] = info;
+            rootInfo = info;
+
+            size_t payload = (cell->getBitSize() + 7) / 8;
+            ++stats.cellCount;
+            stats.totalBits += cell->getBitSize();
+            stats.totalRefs += refsCount;
+            stats.specialCells += cell->isSpecial() ? 1 : 0;
+            stats.payloadBytes += payload;
+            stats.overheadBytes += cell->memoryFootprint() - payload;
+        }
+        stats.treeCellCount = rootInfo.treeCells;
+        stats.maxDepth = rootInfo.depth;
+        return stats;
+    }
+
+    StorageLimits::StorageLimits()
+        : maxCells(std::numeric_limits<uint64_t>::max()), maxBits(std::numeric_limits<uint64_t>::max()),
+          maxDepth(std::numeric_limits<uint32_t>::max()) {}
+
+    StorageLimits::StorageLimits(uint64_t maxCells, uint64_t maxBits, uint32_t maxDepth)
+        : maxCells(maxCells), maxBits(maxBits), maxDepth(maxDepth) {}
+
+    StorageStats::StorageStats() : cells(0), bits(0), maxDepth(0), limitExceeded(false) {}
+
+    StorageStats computeStorageStats(const CellRef& root, const StorageLimits& limits) {
+        StorageStats stats;
+        if (!root) {
+            return stats;
+        }
+
+        // Однакові комірки (зокрема різні об'єкти з тим самим хешем представлення)
+        // рахуються один раз, хоча обхід з maxDepth може повторно зайти в комірку
+        // з меншої глибини; глибина - глибина входу плюс висота піддерева.
+        // У зворотному порядку дочірні комірки вже хешовані, тож hash() - один блок SHA-256
+        std::unordered_map<Cell::Hash, uint32_t, RepresentationHash> heights;
+        // Найбільше значення uint32_t означає відсутність обмеження глибини
+        size_t maxDepth = limits.maxDepth == std::numeric_limits<uint32_t>::max()
+            ? CellTraversal::UNLIMITED_DEPTH : limits.maxDepth;
+        CellTraversal it(root.get(), TraversalOrder::PostOrder, true, maxDepth);
+        for (; it.valid(); it.next()) {
+            if (it.depthLimitReached()) {
+                stats.limitExceeded = true;
+                return stats;
+            }
+
+            const Cell* cell = it.cell();
+            size_t refsCount = cell->getRefsCount();
+            uint32_t height = 0;
+            for (size_t i = 0; i < refsCount; ++i) {
+                const Cell* child = cell->getReference(i).get();
+                if (child->getRefsCount() > 0) {
+                    height = std::max(height, heights[child->hash()] + 1);
+                } else {
+                    height = std::max<uint32_t>(height, 1);
+                }
+            }
+            bool first = heights.emplace(cell->hash(), height).second;
+
+            // Глибина комірки плюс висота її піддерева - довжина реального шляху від кореня
+            uint64_t pathDepth = static_cast<uint64_t>(it.depth()) + height;
+            stats.maxDepth = static_cast<uint32_t>(std::max<uint64_t>(stats.maxDepth, pathDepth));
+            if (first) {
+                ++stats.cells;
+                stats.bits += cell->getBitSize();
+            }
+            if (stats.cells > limits.maxCells || stats.bits > limits.maxBits || pathDepth > limits.maxDepth) {
+                stats.limitExceeded = true;
+                return stats;
+            }
+        }
+        return stats;
+    }
+}
@@ -0,0 +1,135 @@
+// CellInterner.cpp - реалізація інтернування комірок
+// Author: Андрій Будильников (Sparky)
+// Concurrent hash-consing table for cells
+// Потокобезопасная таблица интернирования ячеек
+
+#include "../include/CellInterner.h"
+#include <stdexcept>
+#include <cstring>
+
+namespace cton {
+
+    CellInterner::CellInterner(size_t stripeCount) {
+        if (stripeCount == 0) {
+            throw std::invalid_argument("Stripe count must be positive");
+        }
+
+        // Округлюємо до степеня двійки, щоб вибирати сегмент маскою
+        size_t count = 1;
+        while (count < stripeCount) {
+            count <<= 1;
+        }
+
+        stripes_.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            stripes_.emplace_back(new Stripe());
+        }
+        stripeMask_ = count - 1;
+    }
+
+    CellRef CellInterner::intern(const CellRef& cell) {
+        if (!cell) {
+            throw std::invalid_argument("Cannot intern null cell");
+        }
+
+        Cell::Hash hash = cell->hash();
+        Stripe& stripe = stripeFor(hash);
+
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        auto result = stripe.cells.emplace(hash, cell);
+        return result.first->second;
+    }
+
+    CellRef CellInterner::intern(const uint8_t* data,
+                                               size_t bitSize,
+                                               const CellRef* references,
+                                               size_t refCount,
+                                               bool isSpecial) {
+        if (bitSize > Cell::MAX_BITS) {
+            throw std::invalid_argument("Bit size exceeds maximum allowed");
+        }
+
+        if (refCount > Cell::MAX_REFS) {
+            throw std::invalid_argument("Number of references exceeds maximum allowed");
+        }
+
+        if (isSpecial) {
+            Cell::validateSpecial(data, bitSize, references, refCount);
+        }
+
+        // Хеш обчислюється до створення комірки, тому повторний вміст не виділяє пам'ять
+        Cell::LevelHashes hashes;
+        Cell::computeLevelHashes(data, bitSize, references, refCount, isSpecial, hashes);
+        const Cell::Hash& hash = hashes.hashes[hashes.hashCount - 1];
+
+        Stripe& stripe = stripeFor(hash);
+        {
+            std::lock_guard<std::mutex> lock(stripe.mutex);
+            auto it = stripe.cells.find(hash);
+            if (it != stripe.cells.end()) {
+                return it->second;
+            }
+        }
+
+        // Комірка створюється поза блокуванням; якщо інший потік встиг першим,
+        // повертається його комірка
+        auto cell = Cell::create(data, bitSize, references, refCount, isSpecial);
+        cell->publishHash(hashes);
+
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        auto result = stripe.cells.emplace(hash, cell);
+        return result.first->second;
+    }
+
+    size_t CellInterner::size() const {
+        size_t total = 0;
+        for (const auto& stripe : stripes_) {
+            std::lock_guard<std::mutex> lock(stripe->mutex);
+            total += stripe->cells.size();
+        }
+        return total;
+    }
+
+    size_t CellInterner::purgeUnused() {
+        // Видалення батьківської комірки може звільнити дочірні, тому повторюємо,
+        // доки знаходяться невикористані комірки
+        size_t removed = 0;
+        size_t removedInPass;
+        do {
+            removedInPass = 0;
+            for (auto& stripe : stripes_) {
+                std::lock_guard<std::mutex> lock(stripe->mutex);
+                for (auto it = stripe->cells.begin(); it != stripe->cells.end();) {
+                    if (it->second.useCount() == 1) {
+                        it = stripe->cells.erase(it);
+                        ++removedInPass;
+                    } else {
+                        ++it;
+                    }
+                }
+            }
+            removed += removedInPass;
+        } while (removedInPass > 0);
+        return removed;
+    }
+
+    void CellInterner::clear() {
+        for (auto& stripe : stripes_) {
+            std::lock_guard<std::mutex> lock(stripe->mutex);
+            stripe->cells.clear();
+        }
+    }
+
+    size_t CellInterner::KeyHash::operator()(const Cell::Hash& hash) const {
+        // Перші байти вибирають сегмент, наступні - кошик усередині сегмента
+        size_t result;
+        std::memcpy(&result, hash.data() + 8, sizeof(result));
+        return result;
+    }
+
+    CellInterner::Stripe& CellInterner::stripeFor(const Cell::Hash& hash) {
+        size_t index;
+        std::memcpy(&index, hash.data(), sizeof(index));
+        return *stripes_[index & stripeMask_];
+    }
+}
@@ -0,0 +1,270 @@
+// CellSlice.cpp - реалізація читання комірки без копіювання
+// Author: Андрій Будильников (Sparky)
+// Zero-copy reader over cell bits and references
+// Чтение ячейки без копирования
+
+#include "../include/CellSlice.h"
+#include "../include/BitString.h"
+#include <stdexcept>
+#include <cstring>
+#include <algorithm>
+
+namespace cton {
+
+    namespace {
+        /**
+         * @brief Прочитати 64-бітне слово big-endian з буфера комірки
+         *
+         * Біля кінця буфера відсутні байти вважаються нульовими
+         */
+        inline uint64_t loadWord(const uint8_t* data, size_t byteIndex) {
+            if (byteIndex + 8 <= Cell::MAX_BYTES) {
+                return BitString::loadWord(data + byteIndex);
+            }
+            uint8_t bytes[8] = {0};
+            std::memcpy(bytes, data + byteIndex, Cell::MAX_BYTES - byteIndex);
+            return BitString::loadWord(bytes);
+        }
+
+        /**
+         * @brief Прочитати до 64 бітів з довільної бітової позиції
+         * @return біти, вирівняні по старшому розряду результату
+         */
+        inline uint64_t loadBitsAligned(const uint8_t* data, size_t bitPos, size_t bitCount) {
+            size_t byteIndex = bitPos / 8;
+            size_t shift = bitPos % 8;
+            uint64_t word = loadWord(data, byteIndex) << shift;
+            if (shift != 0 && shift + bitCount > 64) {
+                // Останні біти значення лежать у дев'ятому байті
+                word |= static_cast<uint64_t>(data[byteIndex + 8]) >> (8 - shift);
+            }
+            return word;
+        }
+    }
+
+    CellSlice::CellSlice()
+        : cell_(nullptr), data_(nullptr), bitPos_(0), bitEnd_(0), refPos_(0), refEnd_(0) {
+    }
+
+    CellSlice::CellSlice(const Cell& cell)
+        : cell_(&cell), data_(cell.getRawData()), bitPos_(0), bitEnd_(cell.getBitSize()),
+          refPos_(0), refEnd_(cell.getRefsCount()) {
+    }
+
+    uint64_t CellSlice::loadUInt(size_t bitCount) {
+        uint64_t value = preloadUInt(bitCount);
+        bitPos_ += bitCount;
+        return value;
+    }
+
+    int64_t CellSlice::loadInt(size_t bitCount) {
+        int64_t value = preloadInt(bitCount);
+        bitPos_ += bitCount;
+        return value;
+    }
+
+    uint64_t CellSlice::preloadUInt(size_t bitCount) const {
+        if (bitCount > 64) {
+            throw std::invalid_argument("Bits count cannot exceed 64");
+        }
+        checkBits(bitCount);
+
+        if (bitCount == 0) {
+            return 0;
+        }
+        return loadBitsAligned(data_, bitPos_, bitCount) >> (64 - bitCount);
+    }
+
+    int64_t CellSlice::preloadInt(size_t bitCount) const {
+        if (bitCount > 64) {
+            throw std::invalid_argument("Bits count cannot exceed 64");
+        }
+        checkBits(bitCount);
+
+        if (bitCount == 0) {
+            return 0;
+        }
+        // Арифметичний зсув розширює знаковий біт
+        return static_cast<int64_t>(loadBitsAligned(data_, bitPos_, bitCount)) >> (64 - bitCount);
+    }
+
+    UInt256 CellSlice::loadUInt256(size_t bitCount) {
+        if (bitCount > UInt256::BITS) {
+            throw std::invalid_argument("Bits count cannot exceed 256");
+        }
+        checkBits(bitCount);
+
+        // Неповне старше слово, далі - повні 64-бітні слова
+        uint64_t words[UInt256::WORDS] = {0, 0, 0, 0};
+        size_t wordCount = (bitCount + 63) / 64;
+        for (size_t i = UInt256::WORDS - wordCount; i < UInt256::WORDS; ++i) {
+            size_t bits = i == UInt256::WORDS - wordCount ? bitCount - 64 * (wordCount - 1) : 64;
+            words[i] = loadBitsAligned(data_, bitPos_, bits) >> (64 - bits);
+            bitPos_ += bits;
+        }
+        return UInt256(words[0], words[1], words[2], words[3]);
+    }
+
+    UInt256 CellSlice::loadVarUInt(size_t maxBytes) {
+        unsigned lengthBits = UInt256::varUIntLengthBits(maxBytes);
+        size_t length = static_cast<size_t>(preloadUInt(lengthBits));
+        if (length >= maxBytes) {
+            throw std::invalid_argument("Invalid VarUInteger length");
+        }
+        checkBits(lengthBits + length * 8);
+
+        bitPos_ += lengthBits;
+        return loadUInt256(length * 8);
+    }
+
+    UInt256 CellSlice::loadCoins() {
+        return loadVarUInt(16);
+    }
+
+    bool CellSlice::loadBit() {
+        checkBits(1);
+        bool bit = (data_[bitPos_ / 8] >> (7 - bitPos_ % 8)) & 1;
+        ++bitPos_;
+        return bit;
+    }
+
+    void CellSlice::loadBits(uint8_t* out, size_t bitCount) {
+        checkBits(bitCount);
+        BitString::copyBits(out, 0, data_, bitPos_, bitCount);
+        bitPos_ += bitCount;
+    }
+
+    std::vector<uint8_t> CellSlice::loadBytes(size_t byteCount) {
+        std::vector<uint8_t> result(byteCount);
+        if (byteCount > 0) {
+            loadBits(result.data(), byteCount * 8);
+        }
+        return result;
+    }
+
+    size_t CellSlice::snakeLength() const {
+        if (remainingBits() % 8 != 0) {
+            throw std::invalid_argument("Snake data is not byte-aligned");
+        }
+        size_t length = remainingBits() / 8;
+        const Cell* cell = refPos_ < refEnd_ ? cell_->getReference(refPos_).get() : nullptr;
+        while (cell != nullptr) {
+            if (cell->isSpecial() || cell->getBitSize() % 8 != 0) {
+                throw std::invalid_argument("Invalid snake cell");
+            }
+            length += cell->getBitSize() / 8;
+            cell = cell->getRefsCount() > 0 ? cell->getReference(0).get() : nullptr;
+        }
+        return length;
+    }
+
+    size_t CellSlice::loadSnakeBytes(uint8_t* out) {
+        // Перевіряє весь ланцюжок до запису в буфер
+        size_t length = snakeLength();
+        size_t headBytes = remainingBits() / 8;
+        if (headBytes > 0) {
+            BitString::copyBits(out, 0, data_, bitPos_, headBytes * 8);
+            bitPos_ = bitEnd_;
+        }
+
+        // Дані комірок ланцюжка вирівняні на байт - копіюються напряму
+        size_t pos = headBytes;
+        const Cell* cell = refPos_ < refEnd_ ? cell_->getReference(refPos_++).get() : nullptr;
+        while (cell != nullptr) {
+            size_t bytes = cell->getBitSize() / 8;
+            std::memcpy(out + pos, cell->getRawData(), bytes);
+            pos += bytes;
+            cell = cell->getRefsCount() > 0 ? cell->getReference(0).get() : nullptr;
+        }
+        return length;
+    }
+
+    std::vector<uint8_t> CellSlice::loadSnakeBytes() {
+        std::vector<uint8_t> result(snakeLength());
+        uint8_t empty;
+        loadSnakeBytes(result.empty() ? &empty : result.data());
+        return result;
+    }
+
+    std::string CellSlice::loadSnakeString() {
+        std::vector<uint8_t> bytes = loadSnakeBytes();
+        return std::string(bytes.begin(), bytes.end());
+    }
+
+    const CellRef& CellSlice::loadRef() {
+        const CellRef& ref = preloadRef(0);
+        ++refPos_;
+        return ref;
+    }
+
+    const CellRef& CellSlice::preloadRef(size_t index) const {
+        if (refPos_ + index >= refEnd_) {
+            throw std::out_of_range("Not enough references in slice");
+        }
+        return cell_->getReference(refPos_ + index);
+    }
+
+    void CellSlice::skip(size_t bitCount) {
+        checkBits(bitCount);
+        bitPos_ += bitCount;
+    }
+
+    void CellSlice::skipRefs(size_t refCount) {
+        if (refCount > refEnd_ - refPos_) {
+            throw std::out_of_range("Not enough references in slice");
+        }
+        refPos_ += refCount;
+    }
+
+    size_t CellSlice::remainingBits() const {
+        return bitEnd_ - bitPos_;
+    }
+
+    size_t CellSlice::remainingRefs() const {
+        return refEnd_ - refPos_;
+    }
+
+    bool CellSlice::empty() const {
+        return bitPos_ == bitEnd_ && refPos_ == refEnd_;
+    }
+
+    const uint8_t* CellSlice::getData() const {
+        return data_;
+    }
+
+    size_t CellSlice::getBitOffset() const {
+        return bitPos_;
+    }
+
+    size_t CellSlice::commonPrefix(const CellSlice& other) const {
+        return commonPrefix(other.data_, other.bitPos_, other.remainingBits());
+    }
+
+    size_t CellSlice::commonPrefix(const uint8_t* bits, size_t bitOffset, size_t bitCount) const {
+        size_t length = std::min(remainingBits(), bitCount);
+        return BitString::commonPrefix(data_, bitPos_, bits, bitOffset, length);
+    }
+
+    bool CellSlice::startsWith(const CellSlice& prefix) const {
+        size_t length = prefix.remainingBits();
+        return length <= remainingBits() && BitString::equal(data_, bitPos_, prefix.data_, prefix.bitPos_, length);
+    }
+
+    bool CellSlice::bitsEqual(const CellSlice& other) const {
+        return remainingBits() == other.remainingBits() && startsWith(other);
+    }
+
+    int CellSlice::compareBits(const CellSlice& other) const {
+        return BitString::compare(data_, bitPos_, remainingBits(), other.data_, other.bitPos_, other.remainingBits());
+    }
+
+    size_t CellSlice::countLeading(bool bit) const {
+        return BitString::countLeading(data_, bitPos_, remainingBits(), bit);
+    }
+
+    void CellSlice::checkBits(size_t bitCount) const {
+        if (bitCount > bitEnd_ - bitPos_) {
+            throw std::out_of_range("Not enough bits in slice");
+        }
+    }
+}
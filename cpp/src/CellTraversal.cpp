@@ -0,0 +1,189 @@
+// CellTraversal.cpp - реалізація ітеративного обходу графа комірок
+// Author: Андрій Будильников (Sparky)
+// Implementation of the iterative cell traversal
+// Реализация итеративного обхода графа ячеек
+
+#include "../include/CellTraversal.h"
+#include <cstdint>
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define CTON_PREFETCH(address) __builtin_prefetch(address)
+#else
+    #define CTON_PREFETCH(address) ((void)0)
+#endif
+
+namespace cton {
+
+    namespace {
+        const size_t MIN_VISITED_SLOTS = 1024;
+    }
+
+    CellVisitedSet::CellVisitedSet(size_t expectedSize) : size_(0) {
+        // Заповненість не більше половини
+        size_t slots = MIN_VISITED_SLOTS;
+        while (slots < expectedSize * 2) {
+            slots *= 2;
+        }
+        slots_.assign(slots, nullptr);
+    }
+
+    bool CellVisitedSet::insert(const Cell* cell) {
+        if ((size_ + 1) * 2 > slots_.size()) {
+            grow();
+        }
+        size_t slot = probe(cell);
+        if (slots_[slot] != nullptr) {
+            return false;
+        }
+        slots_[slot] = cell;
+        ++size_;
+        return true;
+    }
+
+    bool CellVisitedSet::contains(const Cell* cell) const {
+        return slots_[probe(cell)] != nullptr;
+    }
+
+    size_t CellVisitedSet::size() const {
+        return size_;
+    }
+
+    void CellVisitedSet::clear() {
+        std::fill(slots_.begin(), slots_.end(), nullptr);
+        size_ = 0;
+    }
+
+    size_t CellVisitedSet::probe(const Cell* cell) const {
+        size_t mask = slots_.size() - 1;
+        // Комірки вирівняні на 64 байти, тому молодші біти адреси нульові
+        size_t slot = static_cast<size_t>((reinterpret_cast<uintptr_t>(cell) >> 6) * 0x9E3779B97F4A7C15ULL) & mask;
+        while (slots_[slot] != nullptr && slots_[slot] != cell) {
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    void CellVisitedSet::grow() {
+        std::vector<const Cell*> oldSlots(slots_.size() * 2, nullptr);
+        oldSlots.swap(slots_);
+        for (const Cell* cell : oldSlots) {
+            if (cell != nullptr) {
+                slots_[probe(cell)] = cell;
+            }
+        }
+    }
+
+    CellTraversal::CellTraversal(const Cell* root, TraversalOrder order, bool unique, size_t maxDepth, Filter filter)
+        : order_(order), unique_(unique), maxDepth_(maxDepth), filter_(filter),
+          current_(nullptr), currentDepth_(0), depthLimitReached_(false) {
+        stack_.reserve(64);
+        if (root == nullptr || !enter(root)) {
+            return;
+        }
+        if (order_ == TraversalOrder::PreOrder) {
+            current_ = root;
+        } else {
+            next();
+        }
+    }
+
+    bool CellTraversal::valid() const {
+        return current_ != nullptr;
+    }
+
+    void CellTraversal::next() {
+        while (!stack_.empty()) {
+            Frame& frame = stack_.back();
+            if (frame.next < frame.cell->refsCount_) {
+                const Cell* child = frame.cell->references_[frame.next++].get();
+                if (enter(child) && order_ == TraversalOrder::PreOrder) {
+                    current_ = child;
+                    currentDepth_ = stack_.size() - 1;
+                    return;
+                }
+                continue;
+            }
+
+            const Cell* cell = frame.cell;
+            stack_.pop_back();
+            if (order_ == TraversalOrder::PostOrder) {
+                current_ = cell;
+                currentDepth_ = stack_.size();
+                return;
+            }
+        }
+        current_ = nullptr;
+    }
+
+    const Cell* CellTraversal::cell() const {
+        return current_;
+    }
+
+    size_t CellTraversal::depth() const {
+        return currentDepth_;
+    }
+
+    void CellTraversal::skipChildren() {
+        if (order_ == TraversalOrder::PreOrder && current_ != nullptr && !stack_.empty() &&
+            stack_.back().cell == current_) {
+            stack_.back().next = current_->refsCount_;
+        }
+    }
+
+    bool CellTraversal::depthLimitReached() const {
+        return depthLimitReached_;
+    }
+
+    size_t CellTraversal::visitedCount() const {
+        // З maxDepth відвідані комірки зберігаються лише в entryDepths_
+        return maxDepth_ == UNLIMITED_DEPTH ? visited_.size() : entryDepths_.size();
+    }
+
+    std::vector<const Cell*> CellTraversal::collect(const Cell* root, TraversalOrder order) {
+        std::vector<const Cell*> cells;
+        for (CellTraversal traversal(root, order); traversal.valid(); traversal.next()) {
+            cells.push_back(traversal.cell());
+        }
+        return cells;
+    }
+
+    bool CellTraversal::enter(const Cell* cell) {
+        if (filter_ != nullptr && !filter_(cell)) {
+            return false;
+        }
+        if (unique_) {
+            if (maxDepth_ == UNLIMITED_DEPTH) {
+                if (!visited_.insert(cell)) {
+                    return false;
+                }
+            } else {
+                // Комірка, вперше досягнута глибше, могла бути обрізана maxDepth:
+                // з меншої глибини її піддерево обходиться знову
+                auto entry = entryDepths_.emplace(cell, stack_.size());
+                if (!entry.second) {
+                    if (stack_.size() >= entry.first->second) {
+                        return false;
+                    }
+                    entry.first->second = stack_.size();
+                }
+            }
+        }
+
+        uint8_t refsCount = cell->refsCount_;
+        if (stack_.size() == maxDepth_) {
+            // Глибше не спускаємось
+            depthLimitReached_ = depthLimitReached_ || refsCount > 0;
+            stack_.push_back(Frame{cell, refsCount});
+            return true;
+        }
+        stack_.push_back(Frame{cell, 0});
+
+        // Посилання і заголовок дочірніх комірок знадобляться на наступних кроках
+        for (uint8_t i = 0; i < refsCount; ++i) {
+            const Cell* child = cell->references_[i].get();
+            CTON_PREFETCH(&child->references_);
+            CTON_PREFETCH(&child->refsCount_);
+        }
+        return true;
+    }
+}
@@ -0,0 +1,719 @@
+// Dictionary.cpp - реалізація словників TON (HashmapE)
+// Author: Андрій Будильников (Sparky)
+// Patricia-trie dictionaries stored in cells
+// Словари TON (HashmapE)
+
+#include "../include/Dictionary.h"
+#include "../include/BitString.h"
+#include <stdexcept>
+#include <cstring>
+
+namespace cton {
+
+    namespace {
+        inline bool getBit(const uint8_t* data, size_t pos) {
+            return (data[pos / 8] >> (7 - pos % 8)) & 1;
+        }
+
+        inline void setBit(uint8_t* data, size_t pos, bool value) {
+            uint8_t mask = static_cast<uint8_t>(0x80 >> (pos % 8));
+            data[pos / 8] = static_cast<uint8_t>(value ? (data[pos / 8] | mask) : (data[pos / 8] & ~mask));
+        }
+
+        /**
+         * @brief Довжина спільного префікса двох ключів на відрізку [from, to)
+         */
+        inline size_t commonPrefix(const uint8_t* a, const uint8_t* b, size_t from, size_t to) {
+            return BitString::commonPrefix(a, from, b, from, to - from);
+        }
+
+        /**
+         * @brief Перевірити чи всі біти відрізка однакові
+         */
+        inline bool allBitsEqual(const uint8_t* data, size_t offset, size_t length) {
+            return BitString::countLeading(data, offset, length, getBit(data, offset)) == length;
+        }
+
+        /**
+         * @brief Заповнити відрізок бітів одним значенням
+         */
+        void fillBits(uint8_t* data, size_t offset, size_t length, bool value) {
+            size_t pos = offset;
+            size_t end = offset + length;
+            while (pos < end) {
+                size_t byteIndex = pos / 8;
+                size_t bitsInByte = 8 - pos % 8;
+                if (bitsInByte > end - pos) {
+                    bitsInByte = end - pos;
+                }
+                uint8_t mask = static_cast<uint8_t>((0xFF >> (pos % 8)) & (0xFF << (8 - pos % 8 - bitsInByte)));
+                data[byteIndex] = static_cast<uint8_t>(value ? (data[byteIndex] | mask) : (data[byteIndex] & ~mask));
+                pos += bitsInByte;
+            }
+        }
+
+        /**
+         * @brief Кількість бітів поля #<= m
+         */
+        inline unsigned lengthBits(size_t maxLength) {
+            unsigned bits = 0;
+            while ((static_cast<size_t>(1) << bits) <= maxLength) {
+                ++bits;
+            }
+            return bits;
+        }
+
+        /**
+         * @brief Записати extra розгалуження HashmapAug з extra його гілок
+         *
+         * Посилання на гілки мають бути вже записані: посилання extra йдуть після них
+         * @param childPos позиція в ключі, з якої починаються мітки гілок
+         */
+        void storeForkExtra(CellBuilder& builder, const AugmentationOps* augmentation,
+                            const CellRef& left, const CellRef& right, size_t keyBits, size_t childPos) {
+            if (augmentation == nullptr) {
+                return;
+            }
+            CellSlice leftSlice(*left);
+            CellSlice rightSlice(*right);
+            Dictionary::skipToExtra(leftSlice, keyBits - childPos);
+            Dictionary::skipToExtra(rightSlice, keyBits - childPos);
+            augmentation->combine(leftSlice, rightSlice, builder);
+        }
+
+        /**
+         * @brief Параметри однопрохідної побудови
+         */
+        struct BuildContext {
+            const uint8_t* keys;
+            const CellRef* values;
+            size_t keyBits;
+            size_t keyBytes;
+            const AugmentationOps* augmentation;
+        };
+
+        CellRef buildNode(const BuildContext& context, size_t lo, size_t hi, size_t pos) {
+            const uint8_t* first = context.keys + lo * context.keyBytes;
+            size_t remaining = context.keyBits - pos;
+
+            CellBuilder builder;
+            if (hi - lo == 1) {
+                // Лист: мітка - весь залишок ключа, далі значення
+                Dictionary::storeLabel(builder, first, pos, remaining, remaining);
+                builder.storeSlice(CellSlice(*context.values[lo]));
+                return builder.build();
+            }
+
+            // Ключі відсортовані, тому спільний префікс діапазону - префікс першого і останнього
+            const uint8_t* last = context.keys + (hi - 1) * context.keyBytes;
+            size_t label = commonPrefix(first, last, pos, context.keyBits);
+            size_t forkBit = pos + label;
+
+            // Перший ключ з одиницею в біті розгалуження
+            size_t left = lo + 1;
+            size_t right = hi - 1;
+            while (left < right) {
+                size_t middle = left + (right - left) / 2;
+                if (getBit(context.keys + middle * context.keyBytes, forkBit)) {
+                    right = middle;
+                } else {
+                    left = middle + 1;
+                }
+            }
+
+            CellRef leftNode = buildNode(context, lo, left, forkBit + 1);
+            CellRef rightNode = buildNode(context, left, hi, forkBit + 1);
+            Dictionary::storeLabel(builder, first, pos, label, remaining);
+            builder.storeRef(leftNode);
+            builder.storeRef(rightNode);
+            storeForkExtra(builder, context.augmentation, leftNode, rightNode, context.keyBits, forkBit + 1);
+            return builder.build();
+        }
+
+        /**
+         * @brief Параметри зміни одного ключа
+         */
+        struct UpdateContext {
+            const uint8_t* key;
+            const CellRef* value;
+            size_t keyBits;
+            size_t keyBytes;
+            uint8_t* path;      // Біти міток пройденого шляху на позиціях ключа
+            const AugmentationOps* augmentation;
+        };
+
+        CellRef makeLeaf(const UpdateContext& context, size_t pos) {
+            size_t remaining = context.keyBits - pos;
+            CellBuilder builder;
+            Dictionary::storeLabel(builder, context.key, pos, remaining, remaining);
+            builder.storeSlice(CellSlice(**context.value));
+            return builder.build();
+        }
+
+        // Розгалуження з тією самою міткою (біти копіюються як є) і заміненою гілкою;
+        // extra розгалуження HashmapAug перераховується
+        CellRef replaceChild(const UpdateContext& context, const Cell& node, const CellSlice& afterLabel,
+                             size_t childPos, unsigned bit, const CellRef& child) {
+            const CellRef& left = bit == 0 ? child : node.getReference(0);
+            const CellRef& right = bit == 1 ? child : node.getReference(1);
+            CellBuilder builder;
+            builder.storeBits(afterLabel.getData(), afterLabel.getBitOffset(), 0);
+            builder.storeRef(left);
+            builder.storeRef(right);
+            storeForkExtra(builder, context.augmentation, left, right, context.keyBits, childPos);
+            return builder.build();
+        }
+
+        CellRef setNode(const UpdateContext& context, const CellRef& node, size_t pos) {
+            CellSlice slice(*node);
+            size_t label = Dictionary::loadLabel(slice, context.keyBits - pos, context.path, pos);
+            size_t common = commonPrefix(context.path, context.key, pos, pos + label);
+            size_t end = pos + label;
+
+            if (common < label) {
+                // Ключ відгалужується всередині мітки: новий вузол розгалуження,
+                // під ним новий лист і старий вузол з укороченою міткою
+                size_t forkBit = pos + common;
+                size_t restLength = label - common - 1;
+                CellBuilder shortened;
+                Dictionary::storeLabel(shortened, context.path, forkBit + 1, restLength,
+                                       context.keyBits - forkBit - 1);
+                shortened.storeSlice(slice);
+                CellRef oldBranch = shortened.build();
+                CellRef newBranch = makeLeaf(context, forkBit + 1);
+
+                bool newIsRight = getBit(context.key, forkBit);
+                const CellRef& left = newIsRight ? oldBranch : newBranch;
+                const CellRef& right = newIsRight ? newBranch : oldBranch;
+                CellBuilder fork;
+                Dictionary::storeLabel(fork, context.key, pos, common, context.keyBits - pos);
+                fork.storeRef(left);
+                fork.storeRef(right);
+                storeForkExtra(fork, context.augmentation, left, right, context.keyBits, forkBit + 1);
+                return fork.build();
+            }
+
+            if (end == context.keyBits) {
+                return makeLeaf(context, pos);
+            }
+
+            unsigned bit = getBit(context.key, end) ? 1 : 0;
+            CellRef child = setNode(context, node->getReference(bit), end + 1);
+            return replaceChild(context, *node, slice, end + 1, bit, child);
+        }
+
+        // Повертає nullptr, якщо вузол зник; found - чи був ключ
+        CellRef eraseNode(const UpdateContext& context, const CellRef& node, size_t pos, bool& found) {
+            CellSlice slice(*node);
+            size_t label = Dictionary::loadLabel(slice, context.keyBits - pos, context.path, pos);
+            if (commonPrefix(context.path, context.key, pos, pos + label) != label) {
+                found = false;
+                return node;
+            }
+
+            size_t end = pos + label;
+            if (end == context.keyBits) {
+                found = true;
+                return CellRef();
+            }
+
+            unsigned bit = getBit(context.key, end) ? 1 : 0;
+            CellRef child = eraseNode(context, node->getReference(bit), end + 1, found);
+            if (!found) {
+                return node;
+            }
+            if (child) {
+                return replaceChild(context, *node, slice, end + 1, bit, child);
+            }
+
+            // Розгалуження з однією гілкою зливається з нею: мітки склеюються через біт гілки
+            unsigned siblingBit = bit ^ 1;
+            CellSlice sibling(*node->getReference(siblingBit));
+            setBit(context.path, end, siblingBit != 0);
+            size_t siblingLabel = Dictionary::loadLabel(sibling, context.keyBits - end - 1, context.path, end + 1);
+            CellBuilder merged;
+            Dictionary::storeLabel(merged, context.path, pos, label + 1 + siblingLabel, context.keyBits - pos);
+            merged.storeSlice(sibling);
+            return merged.build();
+        }
+
+        // Вузол задається або матеріалізованою коміркою, або номером комірки в BOC.
+        // Для BOC читаються лише біти вузла в тимчасову комірку scratch
+        CellSlice openNode(const BocView* boc, const Cell* cell, size_t index, Cell& scratch) {
+            if (boc != nullptr) {
+                scratch = boc->loadCellData(index);
+                return CellSlice(scratch);
+            }
+            return CellSlice(*cell);
+        }
+
+        void childNode(const BocView* boc, const Cell* cell, size_t index, unsigned bit,
+                       const Cell*& childCell, size_t& childIndex) {
+            if (boc != nullptr) {
+                childIndex = boc->getRefIndex(index, bit);
+                childCell = nullptr;
+            } else {
+                childCell = cell->getReference(bit).get();
+                childIndex = 0;
+            }
+        }
+
+        // Значення листа: для BOC матеріалізується лише піддерево листа
+        CellSlice leafValue(const BocView* boc, const Cell* cell, size_t index, size_t valueOffset) {
+            if (boc != nullptr) {
+                cell = boc->loadCell(index).get();
+            }
+            CellSlice value(*cell);
+            value.skip(valueOffset);
+            return value;
+        }
+    }
+
+    DictionaryIterator::DictionaryIterator() : keyBits_(0), reverse_(false), valid_(false) {}
+
+    bool DictionaryIterator::valid() const {
+        return valid_;
+    }
+
+    void DictionaryIterator::next() {
+        if (!valid_) {
+            throw std::out_of_range("Dictionary iterator is exhausted");
+        }
+        advance();
+    }
+
+    const uint8_t* DictionaryIterator::key() const {
+        if (!valid_) {
+            throw std::out_of_range("Dictionary iterator is exhausted");
+        }
+        return key_.data();
+    }
+
+    uint64_t DictionaryIterator::keyUInt() const {
+        if (keyBits_ > 64) {
+            throw std::invalid_argument("Integer dictionary keys must be 1 to 64 bits");
+        }
+        return BitString::loadWord(key()) >> (64 - keyBits_);
+    }
+
+    const CellSlice& DictionaryIterator::value() const {
+        if (!valid_) {
+            throw std::out_of_range("Dictionary iterator is exhausted");
+        }
+        return value_;
+    }
+
+    void DictionaryIterator::advance() {
+        const BocView* boc = boc_.get();
+        valid_ = false;
+        while (!stack_.empty()) {
+            Frame frame = stack_.back();
+            stack_.pop_back();
+            if (frame.bit >= 0) {
+                setBit(key_.data(), frame.pos - 1, frame.bit != 0);
+            }
+
+            CellSlice slice = openNode(boc, frame.cell, frame.index, scratch_);
+            size_t end = frame.pos + Dictionary::loadLabel(slice, keyBits_ - frame.pos, key_.data(), frame.pos);
+            if (end == keyBits_) {
+                value_ = leafValue(boc, frame.cell, frame.index, slice.getBitOffset());
+                valid_ = true;
+                return;
+            }
+
+            // Гілка, що йде першою, кладеться на стек останньою
+            Frame children[2];
+            for (unsigned bit = 0; bit < 2; ++bit) {
+                childNode(boc, frame.cell, frame.index, bit, children[bit].cell, children[bit].index);
+                children[bit].pos = end + 1;
+                children[bit].bit = static_cast<int>(bit);
+            }
+            stack_.push_back(children[reverse_ ? 0 : 1]);
+            stack_.push_back(children[reverse_ ? 1 : 0]);
+        }
+    }
+
+    void DictionaryIterator::seek(const uint8_t* key) {
+        // Спуск шляхом ключа; піддерева, що лежать повністю після ключа в напрямку
+        // обходу, відкладаються на стек (глибше - ближче до ключа)
+        const BocView* boc = boc_.get();
+        Frame node = stack_.back();
+        stack_.pop_back();
+        while (true) {
+            CellSlice slice = openNode(boc, node.cell, node.index, scratch_);
+            size_t label = Dictionary::loadLabel(slice, keyBits_ - node.pos, key_.data(), node.pos);
+            size_t common = commonPrefix(key_.data(), key, node.pos, node.pos + label);
+            if (common < label) {
+                // Усе піддерево з одного боку від ключа
+                bool nodeBit = getBit(key_.data(), node.pos + common);
+                if (nodeBit != reverse_) {
+                    stack_.push_back(node);
+                }
+                break;
+            }
+
+            size_t end = node.pos + label;
+            if (end == keyBits_) {
+                stack_.push_back(node);
+                break;
+            }
+
+            unsigned bit = getBit(key, end) ? 1 : 0;
+            unsigned skipped = bit ^ 1;
+            Frame child;
+            if ((skipped == 1) != reverse_) {
+                childNode(boc, node.cell, node.index, skipped, child.cell, child.index);
+                child.pos = end + 1;
+                child.bit = static_cast<int>(skipped);
+                stack_.push_back(child);
+            }
+            setBit(key_.data(), end, bit != 0);
+            childNode(boc, node.cell, node.index, bit, child.cell, child.index);
+            child.pos = end + 1;
+            child.bit = -1;
+            node = child;
+        }
+        advance();
+    }
+
+    Dictionary::Dictionary(size_t keyBits) : keyBits_(keyBits), rootIndex_(0), augmentation_(nullptr) {
+        checkKeyBits(keyBits);
+    }
+
+    Dictionary::Dictionary(size_t keyBits, CellRef root)
+        : keyBits_(keyBits), root_(std::move(root)), rootIndex_(0), augmentation_(nullptr) {
+        checkKeyBits(keyBits);
+    }
+
+    Dictionary::Dictionary(size_t keyBits, CellRef root, const AugmentationOps* augmentation)
+        : keyBits_(keyBits), root_(std::move(root)), rootIndex_(0), augmentation_(augmentation) {
+        checkKeyBits(keyBits);
+    }
+
+    Dictionary Dictionary::fromBoc(std::shared_ptr<const BocView> boc, size_t rootIndex, size_t keyBits) {
+        if (!boc) {
+            throw std::invalid_argument("BOC view cannot be null");
+        }
+        if (rootIndex >= boc->getCellCount()) {
+            throw std::out_of_range("BOC cell index out of range");
+        }
+        Dictionary result(keyBits);
+        result.boc_ = std::move(boc);
+        result.rootIndex_ = rootIndex;
+        return result;
+    }
+
+    Dictionary Dictionary::build(size_t keyBits, const uint8_t* keys, const CellRef* values, size_t count,
+                                 const AugmentationOps* augmentation) {
+        Dictionary result(keyBits, CellRef(), augmentation);
+        if (count == 0) {
+            return result;
+        }
+
+        if (keys == nullptr || values == nullptr) {
+            throw std::invalid_argument("Dictionary keys and values cannot be null");
+        }
+
+        size_t keyBytes = (keyBits + 7) / 8;
+        for (size_t i = 0; i < count; ++i) {
+            if (!values[i]) {
+                throw std::invalid_argument("Dictionary value cannot be null");
+            }
+            if (i > 0) {
+                // Строге зростання: перший відмінний біт має бути одиницею в наступному ключі
+                const uint8_t* previous = keys + (i - 1) * keyBytes;
+                const uint8_t* current = keys + i * keyBytes;
+                size_t prefix = commonPrefix(previous, current, 0, keyBits);
+                if (prefix == keyBits || !getBit(current, prefix)) {
+                    throw std::invalid_argument("Dictionary keys must be strictly ascending");
+                }
+            }
+        }
+
+        BuildContext context = {keys, values, keyBits, keyBytes, augmentation};
+        result.root_ = buildNode(context, 0, count, 0);
+        return result;
+    }
+
+    Dictionary Dictionary::build(size_t keyBits, const std::vector<std::pair<uint64_t, CellRef>>& entries) {
+        if (keyBits == 0 || keyBits > 64) {
+            throw std::invalid_argument("Integer dictionary keys must be 1 to 64 bits");
+        }
+
+        size_t keyBytes = (keyBits + 7) / 8;
+        std::vector<uint8_t> keys(entries.size() * keyBytes + 8);
+        std::vector<CellRef> values;
+        values.reserve(entries.size());
+        uint8_t packed[8];
+        for (size_t i = 0; i < entries.size(); ++i) {
+            packKey(keyBits, entries[i].first, packed);
+            std::memcpy(keys.data() + i * keyBytes, packed, keyBytes);
+            values.push_back(entries[i].second);
+        }
+        return build(keyBits, keys.data(), values.data(), entries.size());
+    }
+
+    Dictionary Dictionary::load(CellSlice& slice, size_t keyBits, const AugmentationOps* augmentation) {
+        CellRef root;
+        if (slice.loadBit()) {
+            root = slice.loadRef();
+        }
+        if (augmentation != nullptr) {
+            // Extra кореня дублює extra кореневого вузла
+            augmentation->skip(slice);
+        }
+        return Dictionary(keyBits, root, augmentation);
+    }
+
+    void Dictionary::store(CellBuilder& builder) const {
+        if (empty()) {
+            builder.storeUInt(1, 0);
+            if (augmentation_ != nullptr) {
+                augmentation_->storeEmpty(builder);
+            }
+            return;
+        }
+
+        CellRef root = getRoot();
+        builder.storeUInt(1, 1);
+        builder.storeRef(root);
+        if (augmentation_ != nullptr) {
+            // Копіюємо extra кореневого вузла (біти і посилання)
+            CellSlice extra(*root);
+            skipToExtra(extra, keyBits_);
+            CellSlice end = extra;
+            augmentation_->skip(end);
+            builder.storeBits(extra.getData(), end.getBitOffset() - extra.getBitOffset(), extra.getBitOffset());
+            for (size_t i = 0; i < extra.remainingRefs() - end.remainingRefs(); ++i) {
+                builder.storeRef(extra.preloadRef(i));
+            }
+        }
+    }
+
+    bool Dictionary::get(const uint8_t* key, CellSlice& value) const {
+        if (empty()) {
+            return false;
+        }
+
+        // Біти міток читаються в буфер на тих самих позиціях, що й у ключі
+        uint8_t path[Cell::MAX_BYTES];
+        const BocView* boc = boc_.get();
+        Cell scratch;
+        const Cell* cell = root_.get();
+        size_t index = rootIndex_;
+        size_t pos = 0;
+        while (true) {
+            CellSlice slice = openNode(boc, cell, index, scratch);
+            size_t label = loadLabel(slice, keyBits_ - pos, path, pos);
+            if (commonPrefix(path, key, pos, pos + label) != label) {
+                return false;
+            }
+            pos += label;
+            if (pos == keyBits_) {
+                value = leafValue(boc, cell, index, slice.getBitOffset());
+                return true;
+            }
+
+            childNode(boc, cell, index, getBit(key, pos) ? 1 : 0, cell, index);
+            ++pos;
+        }
+    }
+
+    bool Dictionary::get(uint64_t key, CellSlice& value) const {
+        uint8_t packed[8];
+        packKey(keyBits_, key, packed);
+        return get(packed, value);
+    }
+
+    void Dictionary::set(const uint8_t* key, const CellRef& value) {
+        if (!value) {
+            throw std::invalid_argument("Dictionary value cannot be null");
+        }
+        detachBoc();
+
+        uint8_t path[Cell::MAX_BYTES];
+        UpdateContext context = {key, &value, keyBits_, keyBytes(), path, augmentation_};
+        root_ = root_ ? setNode(context, root_, 0) : makeLeaf(context, 0);
+    }
+
+    void Dictionary::set(uint64_t key, const CellRef& value) {
+        uint8_t packed[8];
+        packKey(keyBits_, key, packed);
+        set(packed, value);
+    }
+
+    bool Dictionary::erase(const uint8_t* key) {
+        detachBoc();
+        if (!root_) {
+            return false;
+        }
+
+        uint8_t path[Cell::MAX_BYTES];
+        UpdateContext context = {key, nullptr, keyBits_, keyBytes(), path, augmentation_};
+        bool found = false;
+        CellRef root = eraseNode(context, root_, 0, found);
+        if (found) {
+            root_ = root;
+        }
+        return found;
+    }
+
+    bool Dictionary::erase(uint64_t key) {
+        uint8_t packed[8];
+        packKey(keyBits_, key, packed);
+        return erase(packed);
+    }
+
+    bool Dictionary::lowerBound(const uint8_t* key, uint8_t* foundKey, CellSlice& value) const {
+        DictionaryIterator it = seek(key);
+        if (!it.valid()) {
+            return false;
+        }
+        std::memcpy(foundKey, it.key(), keyBytes());
+        value = it.value();
+        return true;
+    }
+
+    DictionaryIterator Dictionary::begin(bool reverse) const {
+        DictionaryIterator it = makeIterator(reverse);
+        it.advance();
+        return it;
+    }
+
+    DictionaryIterator Dictionary::seek(const uint8_t* key, bool reverse) const {
+        DictionaryIterator it = makeIterator(reverse);
+        if (!it.stack_.empty()) {
+            it.seek(key);
+        }
+        return it;
+    }
+
+    CellRef Dictionary::getRoot() const {
+        if (boc_) {
+            return boc_->loadCell(rootIndex_);
+        }
+        return root_;
+    }
+
+    size_t Dictionary::getKeyBits() const {
+        return keyBits_;
+    }
+
+    size_t Dictionary::keyBytes() const {
+        return (keyBits_ + 7) / 8;
+    }
+
+    bool Dictionary::empty() const {
+        return !root_ && !boc_;
+    }
+
+    void Dictionary::packKey(size_t keyBits, uint64_t key, uint8_t* out) {
+        if (keyBits == 0 || keyBits > 64) {
+            throw std::invalid_argument("Integer dictionary keys must be 1 to 64 bits");
+        }
+        if (keyBits < 64 && (key >> keyBits) != 0) {
+            throw std::invalid_argument("Key does not fit in key bits");
+        }
+        BitString::storeWord(out, key << (64 - keyBits));
+    }
+
+    void Dictionary::storeLabel(CellBuilder& builder, const uint8_t* bits, size_t bitOffset,
+                                size_t length, size_t maxLength) {
+        // Вартість: hml_short - 2n + 2, hml_long - 2 + k + n, hml_same - 3 + k;
+        // при рівній вартості перевага short, потім long (як у TON)
+        unsigned k = lengthBits(maxLength);
+        size_t shortCost = 2 * length + 2;
+        size_t longCost = 2 + k + length;
+        bool same = length > 1 && allBitsEqual(bits, bitOffset, length);
+        size_t sameCost = 3 + k;
+
+        if (same && sameCost < shortCost && sameCost < longCost) {
+            builder.storeUInt(2, 0x3);
+            builder.storeUInt(1, getBit(bits, bitOffset) ? 1 : 0);
+            builder.storeUInt(k, length);
+        } else if (longCost < shortCost) {
+            builder.storeUInt(2, 0x2);
+            builder.storeUInt(k, length);
+            builder.storeBits(bits, length, bitOffset);
+        } else {
+            // Унарна довжина: n одиниць і нуль
+            builder.storeUInt(1, 0);
+            for (size_t ones = length; ones > 0;) {
+                size_t chunk = ones < 64 ? ones : 64;
+                builder.storeUInt(chunk, ~0ULL >> (64 - chunk));
+                ones -= chunk;
+            }
+            builder.storeUInt(1, 0);
+            builder.storeBits(bits, length, bitOffset);
+        }
+    }
+
+    size_t Dictionary::loadLabel(CellSlice& slice, size_t maxLength, uint8_t* out, size_t outOffset) {
+        size_t length;
+        if (!slice.loadBit()) {
+            // hml_short
+            length = 0;
+            while (slice.loadBit()) {
+                ++length;
+            }
+        } else if (!slice.loadBit()) {
+            // hml_long
+            length = static_cast<size_t>(slice.loadUInt(lengthBits(maxLength)));
+        } else {
+            // hml_same
+            bool bit = slice.loadBit();
+            length = static_cast<size_t>(slice.loadUInt(lengthBits(maxLength)));
+            if (length > maxLength) {
+                throw std::invalid_argument("Invalid dictionary label length");
+            }
+            fillBits(out, outOffset, length, bit);
+            return length;
+        }
+
+        if (length > maxLength) {
+            throw std::invalid_argument("Invalid dictionary label length");
+        }
+        size_t labelOffset = slice.getBitOffset();
+        slice.skip(length);
+        if (length > 0) {
+            BitString::copyBits(out, outOffset, slice.getData(), labelOffset, length);
+        }
+        return length;
+    }
+
+    void Dictionary::skipToExtra(CellSlice& slice, size_t maxLength) {
+        uint8_t scratch[Cell::MAX_BYTES];
+        if (loadLabel(slice, maxLength, scratch, 0) < maxLength) {
+            // Розгалуження: перші два посилання - гілки
+            slice.skipRefs(2);
+        }
+    }
+
+    void Dictionary::detachBoc() {
+        if (boc_) {
+            root_ = boc_->loadCell(rootIndex_);
+            boc_.reset();
+        }
+    }
+
+    DictionaryIterator Dictionary::makeIterator(bool reverse) const {
+        DictionaryIterator it;
+        it.root_ = root_;
+        it.boc_ = boc_;
+        it.keyBits_ = keyBits_;
+        it.reverse_ = reverse;
+        // Запас у 8 байтів дозволяє читати ключ словом
+        it.key_.assign(keyBytes() + 8, 0);
+        if (!empty()) {
+            DictionaryIterator::Frame root = {root_.get(), rootIndex_, 0, -1};
+            it.stack_.push_back(root);
+        }
+        return it;
+    }
+
+    void Dictionary::checkKeyBits(size_t keyBits) {
+        if (keyBits == 0 || keyBits > Cell::MAX_BITS) {
+            throw std::invalid_argument("Dictionary key bits must be 1 to MAX_BITS");
+        }
+    }
+}
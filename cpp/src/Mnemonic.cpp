@@ -4,6 +4,7 @@
 // Реализация мнемонической фразы BIP-39
 
 #include "../include/Mnemonic.h"
+#include "../include/Sha256.h"
 #include <stdexcept>
 #include <random>
 #include <cstring>
@@ -485,11 +486,22 @@ namespace cton {
         // Calculate SHA256 checksum
         // Вычисление контрольной суммы SHA256
         
+        // SHA-NI - власна реалізація; інакше OpenSSL, а без нього - портабельна власна
+        // SHA-NI - internal implementation; otherwise OpenSSL, and without it the portable internal one
+        // SHA-NI - собственная реализация; иначе OpenSSL, а без него - переносимая собственная
+        std::vector<uint8_t> hash;
+        if (Sha256::hardwareAccelerated()) {
+            hash = Sha256::hash(entropy);
+        } else {
 #if OPENSSL_AVAILABLE
-        std::vector<uint8_t> hash(32);
-        
-        // Use OpenSSL implementation
-        SHA256(entropy.data(), entropy.size(), hash.data());
+            hash.resize(32);
+            
+            // Use OpenSSL implementation
+            SHA256(entropy.data(), entropy.size(), hash.data());
+#else
+            hash = Sha256::hash(entropy);
+#endif
+        }
         
         // Повертаємо перші біти в залежності від розміру ентропії
         // Return first bits depending on entropy size
@@ -497,10 +509,14 @@ namespace cton {
         int checksumBits = entropy.size() * 8 / 32;
         int checksumBytes = (checksumBits + 7) / 8;
         
-        return std::vector<uint8_t>(hash.begin(), hash.begin() + checksumBytes);
-#else
-        throw std::runtime_error("OpenSSL not available - SHA256 checksum calculation disabled");
-#endif
+        // Обнуляємо молодші біти, що не входять до контрольної суми
+        // Clear the low bits that are not part of the checksum
+        // Обнуляем младшие биты, не входящие в контрольную сумму
+        std::vector<uint8_t> checksum(hash.begin(), hash.begin() + checksumBytes);
+        if (checksumBits % 8 != 0) {
+            checksum.back() &= static_cast<uint8_t>(0xFF << (8 - checksumBits % 8));
+        }
+        return checksum;
     }
     
 }
\ No newline at end of file
@@ -5,10 +5,12 @@
 
 #include "../include/NativeInterface.h"
 #include "../include/Cell.h"
+#include "../include/CellSlice.h"
 #include "../include/Address.h"
 #include "../include/Crypto.h"
 #include "../include/Boc.h"
 #include <cstring>
+#include <algorithm>
 #include <cstdlib>
 #include <stdexcept>
 
@@ -51,7 +53,8 @@ void free_string_array(char** strArray) {
 // Cell functions
 void* cell_create() {
     try {
-        return new Cell();
+        // Дескриптор для Java володіє одним посиланням на комірку
+        return Cell::create().detach();
     } catch (const std::bad_alloc&) {
         // Handle memory allocation failure
         return nullptr;
@@ -64,7 +67,8 @@ void* cell_create() {
 void cell_destroy(void* cell) {
     if (cell) {
         try {
-            delete static_cast<Cell*>(cell);
+            // Повертаємо посилання дескриптора; комірка знищується, коли на неї ніхто не посилається
+            CellRef::adopt(static_cast<Cell*>(cell));
         } catch (...) {
             // Ignore exceptions during destruction
         }
@@ -111,8 +115,30 @@ bool cell_store_bytes(void* cell, const uint8_t* data, int length) {
     }
     
     try {
-        std::vector<uint8_t> vec(data, data + length);
-        static_cast<Cell*>(cell)->storeBytes(vec);
+        // Дописуємо напряму з буфера викликача, без проміжного вектора
+        static_cast<Cell*>(cell)->storeBits(data, static_cast<size_t>(length) * 8);
+        return true;
+    } catch (const std::exception&) {
+        // Handle standard exceptions
+        return false;
+    } catch (...) {
+        // Handle any other unexpected exceptions
+        return false;
+    }
+}
+
+bool cell_store_coins(void* cell, const uint8_t* amount, int length) {
+    if (!cell || length < 0 || (length > 0 && !amount)) {
+        return false;
+    }
+    
+    try {
+        // Провідні нульові байти (наприклад, знаковий байт BigInteger) не впливають на значення
+        while (length > 0 && amount[0] == 0) {
+            ++amount;
+            --length;
+        }
+        static_cast<Cell*>(cell)->storeCoins(UInt256::fromBytes(amount, static_cast<size_t>(length)));
         return true;
     } catch (const std::exception&) {
         // Handle standard exceptions
@@ -129,8 +155,8 @@ bool cell_store_ref(void* cell, void* refCell) {
     }
     
     try {
-        // Convert void* to shared_ptr<Cell>
-        std::shared_ptr<Cell> ref(static_cast<Cell*>(refCell));
+        // Батьківська комірка отримує власне посилання, дескриптор refCell лишається дійсним
+        CellRef ref(static_cast<Cell*>(refCell));
         static_cast<Cell*>(cell)->addReference(ref);
         return true;
     } catch (const std::exception&) {
@@ -148,9 +174,11 @@ int cell_get_data(void* cell, uint8_t* buffer, int bufferSize) {
     }
     
     try {
-        auto data = static_cast<Cell*>(cell)->getData();
-        int copySize = std::min(bufferSize, (int)data.size());
-        std::memcpy(buffer, data.data(), copySize);
+        // Копіюємо з вбудованого буфера комірки без проміжного вектора
+        const Cell* source = static_cast<Cell*>(cell);
+        int dataSize = static_cast<int>((source->getBitSize() + 7) / 8);
+        int copySize = std::min(bufferSize, dataSize);
+        std::memcpy(buffer, source->getRawData(), copySize);
         return copySize;
     } catch (const std::exception&) {
         // Handle standard exceptions
@@ -183,8 +211,7 @@ int cell_get_refs_count(void* cell) {
     }
     
     try {
-        auto refs = static_cast<Cell*>(cell)->getReferences();
-        return static_cast<int>(refs.size());
+        return static_cast<int>(static_cast<Cell*>(cell)->getRefsCount());
     } catch (const std::exception&) {
         // Handle standard exceptions
         return -1;
@@ -200,19 +227,14 @@ void* cell_get_ref(void* cell, int index) {
     }
     
     try {
-        auto refs = static_cast<Cell*>(cell)->getReferences();
-        if (index >= static_cast<int>(refs.size())) {
-            return nullptr;
-        }
-        
-        // Lock the weak_ptr to get the shared_ptr
-        auto ref = refs[index].lock();
-        if (!ref) {
+        const Cell* source = static_cast<Cell*>(cell);
+        if (index >= static_cast<int>(source->getRefsCount())) {
             return nullptr;
         }
         
-        // Return the raw pointer to the Cell object
-        return ref.get();
+        // Новий дескриптор володіє власним посиланням і звільняється через cell_destroy
+        CellRef ref = source->getReference(static_cast<size_t>(index));
+        return ref.detach();
     } catch (const std::exception&) {
         // Handle standard exceptions
         return nullptr;
@@ -222,6 +244,65 @@ void* cell_get_ref(void* cell, int index) {
     }
 }
 
+bool cell_store_snake_bytes(void* cell, const uint8_t* data, int length) {
+    if (!cell || length < 0 || (length > 0 && !data)) {
+        return false;
+    }
+    
+    try {
+        // Голова дописується в комірку, хвіст будується CellBuilder одним ланцюжком
+        Cell* target = static_cast<Cell*>(cell);
+        size_t size = static_cast<size_t>(length);
+        size_t headBytes = std::min(size, (Cell::MAX_BITS - target->getBitSize()) / 8);
+        if (headBytes < size && target->getRefsCount() != 0) {
+            // cell_load_snake_bytes читає хвіст за першим посиланням
+            return false;
+        }
+        CellRef tail;
+        if (headBytes < size) {
+            CellBuilder builder;
+            tail = builder.storeSnakeBytes(data + headBytes, size - headBytes).build();
+        }
+        if (headBytes > 0) {
+            target->storeBits(data, headBytes * 8);
+        }
+        if (tail) {
+            target->addReference(tail);
+        }
+        return true;
+    } catch (const std::exception&) {
+        // Handle standard exceptions
+        return false;
+    } catch (...) {
+        // Handle any other unexpected exceptions
+        return false;
+    }
+}
+
+int cell_load_snake_bytes(void* cell, uint8_t* buffer, int bufferSize) {
+    if (!cell || bufferSize < 0 || (bufferSize > 0 && !buffer)) {
+        return -1;
+    }
+    
+    try {
+        CellSlice slice(*static_cast<Cell*>(cell));
+        size_t length = slice.snakeLength();
+        if (length > static_cast<size_t>(INT32_MAX)) {
+            return -1;
+        }
+        if (length > 0 && length <= static_cast<size_t>(bufferSize)) {
+            slice.loadSnakeBytes(buffer);
+        }
+        return static_cast<int>(length);
+    } catch (const std::exception&) {
+        // Handle standard exceptions
+        return -1;
+    } catch (...) {
+        // Handle any other unexpected exceptions
+        return -1;
+    }
+}
+
 // Address functions
 void* address_create() {
     try {
@@ -848,8 +929,8 @@ void* boc_create_with_root(void* rootCell) {
     }
     
     try {
-        // Convert void* to shared_ptr<Cell>
-        std::shared_ptr<Cell> cell(static_cast<Cell*>(rootCell));
+        // BOC отримує власне посилання на комірку
+        CellRef cell(static_cast<Cell*>(rootCell));
         // Create a new Boc object with the root cell
         return new Boc(cell);
     } catch (const std::bad_alloc&) {
@@ -935,18 +1016,11 @@ void* boc_get_root(void* boc) {
     }
     
     try {
-        std::shared_ptr<Cell> root = static_cast<Boc*>(boc)->getRoot();
-        // Create a new Cell object that's a copy of the root cell
-        // This ensures proper memory management
-        if (root) {
-            std::vector<uint8_t> data = root->getData();
-            size_t bitSize = root->getBitSize();
-            
-            // Create a new cell with the same data
-            Cell* newCell = new Cell(data, bitSize, std::vector<std::shared_ptr<Cell>>(), root->isSpecial());
-            return newCell;
-        }
-        return nullptr;
+        CellRef root = static_cast<Boc*>(boc)->getRoot();
+        // Дескриптор володіє власним посиланням на корінь (разом з його посиланнями)
+        // The handle owns its own reference to the root (including its references)
+        // Дескриптор владеет собственной ссылкой на корень (вместе с его ссылками)
+        return root.detach();
     } catch (const std::bad_alloc&) {
         // Handle memory allocation failure
         return nullptr;
@@ -962,8 +1036,8 @@ void boc_set_root(void* boc, void* rootCell) {
     }
     
     try {
-        // Convert void* to shared_ptr<Cell>
-        std::shared_ptr<Cell> cell(static_cast<Cell*>(rootCell));
+        // BOC отримує власне посилання на комірку
+        CellRef cell(static_cast<Cell*>(rootCell));
         static_cast<Boc*>(boc)->setRoot(cell);
     } catch (...) {
         // Нічого не робимо
@@ -0,0 +1,568 @@
+// Sha256.cpp - реалізація SHA-256
+// Author: Андрій Будильников (Sparky)
+// Portable SHA-256 implementation
+// Портируемая реализация SHA-256
+
+#include "../include/Sha256.h"
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define CTON_SHA256_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #define CTON_TARGET(isa)
+    #else
+        #include <cpuid.h>
+        #define CTON_TARGET(isa) __attribute__((target(isa)))
+    #endif
+#endif
+
+namespace cton {
+
+    namespace {
+
+        const uint32_t K[64] = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+        };
+
+        const uint32_t INITIAL_STATE[8] = {
+            0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+            0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+        };
+
+        inline uint32_t rotr(uint32_t x, int n) {
+            return (x >> n) | (x << (32 - n));
+        }
+
+        inline uint32_t loadBE32(const uint8_t* p) {
+            return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+                   (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+        }
+
+        inline void storeBE32(uint8_t* p, uint32_t v) {
+            p[0] = static_cast<uint8_t>(v >> 24);
+            p[1] = static_cast<uint8_t>(v >> 16);
+            p[2] = static_cast<uint8_t>(v >> 8);
+            p[3] = static_cast<uint8_t>(v);
+        }
+
+        // Найбільша кількість потоків векторного ядра
+        const size_t MAX_LANES = 8;
+        // hashBatch сортує повідомлення вікнами такого розміру в масиві на стеку
+        const size_t BATCH_WINDOW = 64;
+        // Повідомлення до стількох блоків доповнюються в буфері на стеку
+        const size_t LOCAL_BLOCKS = 6;
+
+        const uint8_t ZERO_BLOCK[Sha256::BLOCK_SIZE] = {0};
+
+        /**
+         * @brief Ядро, що стискає по одному блоку в кожному з потоків
+         *
+         * Стан - "структура масивів": state[j * MAX_LANES + lane] - слово j потоку lane
+         */
+        typedef void (*LaneCompress)(uint32_t* state, const uint8_t* const* blocks);
+
+        /**
+         * @brief Портабельне стиснення блоків (без апаратних розширень)
+         */
+        void compressPortable(uint32_t* state, const uint8_t* blocks, size_t blockCount) {
+            uint32_t w[64];
+
+            for (size_t block = 0; block < blockCount; ++block, blocks += Sha256::BLOCK_SIZE) {
+                for (int i = 0; i < 16; ++i) {
+                    w[i] = loadBE32(blocks + 4 * i);
+                }
+                for (int i = 16; i < 64; ++i) {
+                    uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+                    uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+                    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+                }
+
+                uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+                uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+                for (int i = 0; i < 64; ++i) {
+                    uint32_t S1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+                    uint32_t ch = (e & f) ^ (~e & g);
+                    uint32_t temp1 = h + S1 + ch + K[i] + w[i];
+                    uint32_t S0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+                    uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+                    uint32_t temp2 = S0 + maj;
+
+                    h = g;
+                    g = f;
+                    f = e;
+                    e = d + temp1;
+                    d = c;
+                    c = b;
+                    b = a;
+                    a = temp1 + temp2;
+                }
+
+                state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+                state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+            }
+        }
+
+        inline size_t paddedBlocks(size_t size) {
+            return (size + 9 + Sha256::BLOCK_SIZE - 1) / Sha256::BLOCK_SIZE;
+        }
+
+        /**
+         * @brief Записати повідомлення з доповненням (0x80, нулі, довжина в бітах)
+         */
+        void padMessage(const uint8_t* message, size_t size, uint8_t* out, size_t blocks) {
+            size_t total = blocks * Sha256::BLOCK_SIZE;
+            if (size > 0) {
+                std::memcpy(out, message, size);
+            }
+            out[size] = 0x80;
+            std::memset(out + size + 1, 0, total - size - 1 - 8);
+            uint64_t bitLength = static_cast<uint64_t>(size) * 8;
+            for (int i = 0; i < 8; ++i) {
+                out[total - 1 - i] = static_cast<uint8_t>(bitLength >> (8 * i));
+            }
+        }
+
+        /**
+         * @brief Стиснути до lanes повідомлень у лад одним ядром
+         *
+         * Потоки, повідомлення яких закінчилися, отримують нульові блоки,
+         * а їхній хеш зберігається після останнього власного блоку
+         */
+        void hashLanes(LaneCompress compress, size_t lanes, const uint8_t* const* messages,
+                       const size_t* sizes, uint8_t* const* digests, size_t count) {
+            size_t blocks[MAX_LANES];
+            size_t offsets[MAX_LANES];
+            size_t total = 0;
+            size_t maxBlocks = 0;
+            for (size_t lane = 0; lane < count; ++lane) {
+                blocks[lane] = paddedBlocks(sizes[lane]);
+                offsets[lane] = total;
+                total += blocks[lane] * Sha256::BLOCK_SIZE;
+                maxBlocks = std::max(maxBlocks, blocks[lane]);
+            }
+
+            uint8_t local[MAX_LANES * LOCAL_BLOCKS * Sha256::BLOCK_SIZE];
+            std::vector<uint8_t> heap;
+            uint8_t* padded = local;
+            if (total > sizeof(local)) {
+                heap.resize(total);
+                padded = heap.data();
+            }
+            for (size_t lane = 0; lane < count; ++lane) {
+                padMessage(messages[lane], sizes[lane], padded + offsets[lane], blocks[lane]);
+            }
+
+            uint32_t state[8 * MAX_LANES];
+            for (size_t j = 0; j < 8; ++j) {
+                for (size_t lane = 0; lane < MAX_LANES; ++lane) {
+                    state[j * MAX_LANES + lane] = INITIAL_STATE[j];
+                }
+            }
+
+            const uint8_t* current[MAX_LANES];
+            for (size_t block = 0; block < maxBlocks; ++block) {
+                for (size_t lane = 0; lane < lanes; ++lane) {
+                    bool active = lane < count && block < blocks[lane];
+                    current[lane] = active ? padded + offsets[lane] + block * Sha256::BLOCK_SIZE : ZERO_BLOCK;
+                }
+                compress(state, current);
+                for (size_t lane = 0; lane < count; ++lane) {
+                    if (blocks[lane] == block + 1) {
+                        for (size_t j = 0; j < 8; ++j) {
+                            storeBE32(digests[lane] + 4 * j, state[j * MAX_LANES + lane]);
+                        }
+                    }
+                }
+            }
+        }
+
+#ifdef CTON_SHA256_X86
+        #define SSE_ROTR(x, n) _mm_or_si128(_mm_srli_epi32(x, n), _mm_slli_epi32(x, 32 - (n)))
+
+        // SSE2 входить до базового набору x86-64, тому ядро на 4 потоки не потребує перевірки
+        CTON_TARGET("sse2")
+        void compressSse2(uint32_t* state, const uint8_t* const* blocks) {
+            __m128i w[64];
+            for (int i = 0; i < 16; ++i) {
+                w[i] = _mm_setr_epi32(static_cast<int>(loadBE32(blocks[0] + 4 * i)),
+                                      static_cast<int>(loadBE32(blocks[1] + 4 * i)),
+                                      static_cast<int>(loadBE32(blocks[2] + 4 * i)),
+                                      static_cast<int>(loadBE32(blocks[3] + 4 * i)));
+            }
+            for (int i = 16; i < 64; ++i) {
+                __m128i s0 = _mm_xor_si128(_mm_xor_si128(SSE_ROTR(w[i - 15], 7), SSE_ROTR(w[i - 15], 18)),
+                                           _mm_srli_epi32(w[i - 15], 3));
+                __m128i s1 = _mm_xor_si128(_mm_xor_si128(SSE_ROTR(w[i - 2], 17), SSE_ROTR(w[i - 2], 19)),
+                                           _mm_srli_epi32(w[i - 2], 10));
+                w[i] = _mm_add_epi32(_mm_add_epi32(w[i - 16], s0), _mm_add_epi32(w[i - 7], s1));
+            }
+
+            __m128i v[8];
+            for (int j = 0; j < 8; ++j) {
+                v[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state + j * MAX_LANES));
+            }
+            __m128i a = v[0], b = v[1], c = v[2], d = v[3], e = v[4], f = v[5], g = v[6], h = v[7];
+
+            for (int i = 0; i < 64; ++i) {
+                __m128i S1 = _mm_xor_si128(_mm_xor_si128(SSE_ROTR(e, 6), SSE_ROTR(e, 11)), SSE_ROTR(e, 25));
+                __m128i ch = _mm_xor_si128(_mm_and_si128(e, f), _mm_andnot_si128(e, g));
+                __m128i temp1 = _mm_add_epi32(_mm_add_epi32(_mm_add_epi32(h, S1), ch),
+                                              _mm_add_epi32(_mm_set1_epi32(static_cast<int>(K[i])), w[i]));
+                __m128i S0 = _mm_xor_si128(_mm_xor_si128(SSE_ROTR(a, 2), SSE_ROTR(a, 13)), SSE_ROTR(a, 22));
+                __m128i maj = _mm_xor_si128(_mm_xor_si128(_mm_and_si128(a, b), _mm_and_si128(a, c)),
+                                            _mm_and_si128(b, c));
+                __m128i temp2 = _mm_add_epi32(S0, maj);
+
+                h = g;
+                g = f;
+                f = e;
+                e = _mm_add_epi32(d, temp1);
+                d = c;
+                c = b;
+                b = a;
+                a = _mm_add_epi32(temp1, temp2);
+            }
+
+            __m128i out[8] = {a, b, c, d, e, f, g, h};
+            for (int j = 0; j < 8; ++j) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(state + j * MAX_LANES), _mm_add_epi32(v[j], out[j]));
+            }
+        }
+
+        #define AVX2_ROTR(x, n) _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - (n)))
+
+        CTON_TARGET("avx2")
+        void compressAvx2(uint32_t* state, const uint8_t* const* blocks) {
+            __m256i w[64];
+            for (int i = 0; i < 16; ++i) {
+                w[i] = _mm256_setr_epi32(static_cast<int>(loadBE32(blocks[0] + 4 * i)),
+                                         static_cast<int>(loadBE32(blocks[1] + 4 * i)),
+                                         static_cast<int>(loadBE32(blocks[2] + 4 * i)),
+                                         static_cast<int>(loadBE32(blocks[3] + 4 * i)),
+                                         static_cast<int>(loadBE32(blocks[4] + 4 * i)),
+                                         static_cast<int>(loadBE32(blocks[5] + 4 * i)),
+                                         static_cast<int>(loadBE32(blocks[6] + 4 * i)),
+                                         static_cast<int>(loadBE32(blocks[7] + 4 * i)));
+            }
+            for (int i = 16; i < 64; ++i) {
+                __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(AVX2_ROTR(w[i - 15], 7), AVX2_ROTR(w[i - 15], 18)),
+                                              _mm256_srli_epi32(w[i - 15], 3));
+                __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(AVX2_ROTR(w[i - 2], 17), AVX2_ROTR(w[i - 2], 19)),
+                                              _mm256_srli_epi32(w[i - 2], 10));
+                w[i] = _mm256_add_epi32(_mm256_add_epi32(w[i - 16], s0), _mm256_add_epi32(w[i - 7], s1));
+            }
+
+            __m256i v[8];
+            for (int j = 0; j < 8; ++j) {
+                v[j] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state + j * MAX_LANES));
+            }
+            __m256i a = v[0], b = v[1], c = v[2], d = v[3], e = v[4], f = v[5], g = v[6], h = v[7];
+
+            for (int i = 0; i < 64; ++i) {
+                __m256i S1 = _mm256_xor_si256(_mm256_xor_si256(AVX2_ROTR(e, 6), AVX2_ROTR(e, 11)), AVX2_ROTR(e, 25));
+                __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+                __m256i temp1 = _mm256_add_epi32(_mm256_add_epi32(_mm256_add_epi32(h, S1), ch),
+                                                 _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(K[i])), w[i]));
+                __m256i S0 = _mm256_xor_si256(_mm256_xor_si256(AVX2_ROTR(a, 2), AVX2_ROTR(a, 13)), AVX2_ROTR(a, 22));
+                __m256i maj = _mm256_xor_si256(_mm256_xor_si256(_mm256_and_si256(a, b), _mm256_and_si256(a, c)),
+                                               _mm256_and_si256(b, c));
+                __m256i temp2 = _mm256_add_epi32(S0, maj);
+
+                h = g;
+                g = f;
+                f = e;
+                e = _mm256_add_epi32(d, temp1);
+                d = c;
+                c = b;
+                b = a;
+                a = _mm256_add_epi32(temp1, temp2);
+            }
+
+            __m256i out[8] = {a, b, c, d, e, f, g, h};
+            for (int j = 0; j < 8; ++j) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(state + j * MAX_LANES), _mm256_add_epi32(v[j], out[j]));
+            }
+        }
+
+        bool cpuHasAvx2() {
+    #if defined(_MSC_VER) && !defined(__clang__)
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7) {
+                return false;
+            }
+            __cpuid(info, 1);
+            bool osxsave = (info[2] & (1 << 27)) != 0;
+            if (!osxsave || (_xgetbv(0) & 0x6) != 0x6) {
+                return false;
+            }
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+    #else
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") != 0;
+    #endif
+        }
+
+        /**
+         * @brief Стиснення блоків інструкціями SHA-NI (sha256rnds2, sha256msg1, sha256msg2)
+         *
+         * Стан тримається в парах ABEF/CDGH, як того вимагає sha256rnds2;
+         * кожна ітерація циклу - чотири раунди
+         */
+        CTON_TARGET("sha,sse4.1")
+        void compressShaNi(uint32_t* state, const uint8_t* blocks, size_t blockCount) {
+            const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+            __m128i dcba = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state));
+            __m128i hgfe = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4));
+            __m128i cdab = _mm_shuffle_epi32(dcba, 0xB1);
+            __m128i efgh = _mm_shuffle_epi32(hgfe, 0x1B);
+            __m128i abef = _mm_alignr_epi8(cdab, efgh, 8);
+            __m128i cdgh = _mm_blend_epi16(efgh, cdab, 0xF0);
+
+            for (size_t block = 0; block < blockCount; ++block, blocks += Sha256::BLOCK_SIZE) {
+                __m128i savedAbef = abef;
+                __m128i savedCdgh = cdgh;
+
+                // w[i & 3] - слова 4i..4i+3 розкладу повідомлення
+                __m128i w[4];
+                for (int i = 0; i < 4; ++i) {
+                    w[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks + 16 * i)),
+                                            byteSwap);
+                }
+
+                for (int i = 0; i < 16; ++i) {
+                    if (i >= 4) {
+                        __m128i next = _mm_sha256msg1_epu32(w[i & 3], w[(i + 1) & 3]);
+                        next = _mm_add_epi32(next, _mm_alignr_epi8(w[(i + 3) & 3], w[(i + 2) & 3], 4));
+                        w[i & 3] = _mm_sha256msg2_epu32(next, w[(i + 3) & 3]);
+                    }
+                    __m128i message = _mm_add_epi32(w[i & 3],
+                                                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(K + 4 * i)));
+                    cdgh = _mm_sha256rnds2_epu32(cdgh, abef, message);
+                    abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(message, 0x0E));
+                }
+
+                abef = _mm_add_epi32(abef, savedAbef);
+                cdgh = _mm_add_epi32(cdgh, savedCdgh);
+            }
+
+            __m128i feba = _mm_shuffle_epi32(abef, 0x1B);
+            __m128i dchg = _mm_shuffle_epi32(cdgh, 0xB1);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_blend_epi16(feba, dchg, 0xF0));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), _mm_alignr_epi8(dchg, feba, 8));
+        }
+
+        bool cpuHasShaNi() {
+            // CPUID.1:ECX - SSSE3 (біт 9) і SSE4.1 (біт 19); CPUID.7.0:EBX - SHA (біт 29)
+    #if defined(_MSC_VER) && !defined(__clang__)
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7) {
+                return false;
+            }
+            __cpuid(info, 1);
+            unsigned features = static_cast<unsigned>(info[2]);
+            __cpuidex(info, 7, 0);
+            unsigned extended = static_cast<unsigned>(info[1]);
+    #else
+            unsigned eax, ebx, ecx, edx;
+            if (__get_cpuid_max(0, nullptr) < 7 || !__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+                return false;
+            }
+            unsigned features = ecx;
+            __cpuid_count(7, 0, eax, ebx, ecx, edx);
+            unsigned extended = ebx;
+    #endif
+            return (features & (1u << 9)) != 0 && (features & (1u << 19)) != 0 &&
+                   (extended & (1u << 29)) != 0;
+        }
+#endif
+
+        typedef void (*BlockCompress)(uint32_t* state, const uint8_t* blocks, size_t blockCount);
+
+        BlockCompress selectBlockCompress() {
+#ifdef CTON_SHA256_X86
+            if (cpuHasShaNi()) {
+                return compressShaNi;
+            }
+#endif
+            return compressPortable;
+        }
+
+        // Ядро для одного потоку теж вибирається при завантаженні бібліотеки
+        const BlockCompress BLOCK_COMPRESS = selectBlockCompress();
+
+        struct BatchKernel {
+            LaneCompress compress;
+            size_t lanes;
+        };
+
+        BatchKernel selectBatchKernel() {
+#ifdef CTON_SHA256_X86
+            if (cpuHasAvx2()) {
+                return BatchKernel{compressAvx2, 8};
+            }
+    #if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+            return BatchKernel{compressSse2, 4};
+    #endif
+#endif
+            return BatchKernel{nullptr, 1};
+        }
+
+        // Ядро вибирається один раз при завантаженні бібліотеки
+        const BatchKernel BATCH_KERNEL = selectBatchKernel();
+    }
+
+    Sha256::Sha256() : bufferSize_(0), totalSize_(0) {
+        std::memcpy(state_, INITIAL_STATE, sizeof(state_));
+    }
+
+    void Sha256::update(const uint8_t* data, size_t size) {
+        totalSize_ += size;
+
+        // Доповнюємо неповний блок
+        if (bufferSize_ > 0) {
+            size_t toCopy = BLOCK_SIZE - bufferSize_;
+            if (toCopy > size) {
+                toCopy = size;
+            }
+            std::memcpy(buffer_ + bufferSize_, data, toCopy);
+            bufferSize_ += toCopy;
+            data += toCopy;
+            size -= toCopy;
+            if (bufferSize_ < BLOCK_SIZE) {
+                return;
+            }
+            compress(state_, buffer_, 1);
+            bufferSize_ = 0;
+        }
+
+        // Повні блоки обробляємо без копіювання
+        size_t blockCount = size / BLOCK_SIZE;
+        if (blockCount > 0) {
+            compress(state_, data, blockCount);
+            data += blockCount * BLOCK_SIZE;
+            size -= blockCount * BLOCK_SIZE;
+        }
+
+        if (size > 0) {
+            std::memcpy(buffer_, data, size);
+            bufferSize_ = size;
+        }
+    }
+
+    void Sha256::finalize(uint8_t* digest) {
+        uint64_t bitLength = totalSize_ * 8;
+
+        // Padding: 0x80, нулі, довжина в бітах (big-endian)
+        buffer_[bufferSize_++] = 0x80;
+        if (bufferSize_ > BLOCK_SIZE - 8) {
+            std::memset(buffer_ + bufferSize_, 0, BLOCK_SIZE - bufferSize_);
+            compress(state_, buffer_, 1);
+            bufferSize_ = 0;
+        }
+        std::memset(buffer_ + bufferSize_, 0, BLOCK_SIZE - 8 - bufferSize_);
+        for (int i = 0; i < 8; ++i) {
+            buffer_[BLOCK_SIZE - 1 - i] = static_cast<uint8_t>(bitLength >> (8 * i));
+        }
+        compress(state_, buffer_, 1);
+
+        for (int i = 0; i < 8; ++i) {
+            storeBE32(digest + 4 * i, state_[i]);
+        }
+
+        // Скидаємо стан для повторного використання
+        std::memcpy(state_, INITIAL_STATE, sizeof(state_));
+        bufferSize_ = 0;
+        totalSize_ = 0;
+    }
+
+    void Sha256::hash(const uint8_t* data, size_t size, uint8_t* digest) {
+        Sha256 sha;
+        sha.update(data, size);
+        sha.finalize(digest);
+    }
+
+    std::vector<uint8_t> Sha256::hash(const std::vector<uint8_t>& data) {
+        std::vector<uint8_t> digest(DIGEST_SIZE);
+        hash(data.data(), data.size(), digest.data());
+        return digest;
+    }
+
+    void Sha256::hashBatch(const uint8_t* const* messages, const size_t* sizes,
+                           uint8_t* const* digests, size_t count) {
+        // До ініціалізації BATCH_KERNEL (виклик зі статичних конструкторів інших модулів)
+        // lanes ще нульовий - тоді хешуємо по одному
+        size_t lanes = BATCH_KERNEL.lanes;
+        if (lanes < 2 || count < 2) {
+            for (size_t i = 0; i < count; ++i) {
+                hash(messages[i], sizes[i], digests[i]);
+            }
+            return;
+        }
+
+        const uint8_t* groupMessages[MAX_LANES];
+        size_t groupSizes[MAX_LANES];
+        uint8_t* groupDigests[MAX_LANES];
+        size_t order[BATCH_WINDOW];
+        for (size_t windowStart = 0; windowStart < count; windowStart += BATCH_WINDOW) {
+            size_t windowSize = std::min(BATCH_WINDOW, count - windowStart);
+
+            // Сортування за кількістю блоків, щоб потоки однієї групи закінчувались разом;
+            // при рівній кількості блоків - за індексом, тож без тимчасового буфера stable_sort
+            for (size_t i = 0; i < windowSize; ++i) {
+                order[i] = windowStart + i;
+            }
+            std::sort(order, order + windowSize, [sizes](size_t a, size_t b) {
+                size_t blocksA = paddedBlocks(sizes[a]);
+                size_t blocksB = paddedBlocks(sizes[b]);
+                return blocksA != blocksB ? blocksA < blocksB : a < b;
+            });
+
+            for (size_t first = 0; first < windowSize; first += lanes) {
+                size_t groupSize = std::min(lanes, windowSize - first);
+                if (groupSize == 1) {
+                    size_t index = order[first];
+                    hash(messages[index], sizes[index], digests[index]);
+                    break;
+                }
+                for (size_t lane = 0; lane < groupSize; ++lane) {
+                    size_t index = order[first + lane];
+                    groupMessages[lane] = messages[index];
+                    groupSizes[lane] = sizes[index];
+                    groupDigests[lane] = digests[index];
+                }
+                hashLanes(BATCH_KERNEL.compress, lanes, groupMessages, groupSizes, groupDigests, groupSize);
+            }
+        }
+    }
+
+    size_t Sha256::batchLanes() {
+        return BATCH_KERNEL.lanes != 0 ? BATCH_KERNEL.lanes : 1;
+    }
+
+    bool Sha256::hardwareAccelerated() {
+        return BLOCK_COMPRESS != compressPortable;
+    }
+
+    void Sha256::compress(uint32_t* state, const uint8_t* blocks, size_t blockCount) {
+        // До ініціалізації BLOCK_COMPRESS (хешування зі статичних конструкторів
+        // інших модулів) вказівник ще нульовий
+        BlockCompress kernel = BLOCK_COMPRESS != nullptr ? BLOCK_COMPRESS : compressPortable;
+        kernel(state, blocks, blockCount);
+    }
+}
@@ -0,0 +1,227 @@
+// UInt256.cpp - реалізація 256-бітного беззнакового цілого
+// Author: Андрій Будильников (Sparky)
+// Fixed-width 256-bit unsigned integer for coins, hashes and wide cell fields
+// 256-битное беззнаковое целое
+
+#include "../include/UInt256.h"
+#include "../include/BitString.h"
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+
+namespace cton {
+
+    namespace {
+        const uint32_t DECIMAL_CHUNK = 1000000000;  // 10^9 - найбільший степінь 10 у 32 бітах
+        const size_t DECIMAL_CHUNK_DIGITS = 9;
+
+        /**
+         * @brief Поділити на 32-бітне число на місці (по 32-бітних половинах слів)
+         * @return остача
+         */
+        uint32_t divideSmall(uint64_t* words, uint32_t divisor) {
+            uint64_t remainder = 0;
+            for (size_t i = 0; i < UInt256::WORDS; ++i) {
+                uint64_t high = (remainder << 32) | (words[i] >> 32);
+                uint64_t highQuotient = high / divisor;
+                remainder = high % divisor;
+                uint64_t low = (remainder << 32) | (words[i] & 0xFFFFFFFFULL);
+                uint64_t lowQuotient = low / divisor;
+                remainder = low % divisor;
+                words[i] = (highQuotient << 32) | lowQuotient;
+            }
+            return static_cast<uint32_t>(remainder);
+        }
+
+        /**
+         * @brief Помножити на 32-бітне число і додати 32-бітне число на місці
+         * @return true при переповненні
+         */
+        bool multiplyAddSmall(uint64_t* words, uint32_t factor, uint32_t addend) {
+            uint64_t carry = addend;
+            for (size_t i = UInt256::WORDS; i-- > 0;) {
+                uint64_t low = (words[i] & 0xFFFFFFFFULL) * factor + carry;
+                uint64_t high = (words[i] >> 32) * factor + (low >> 32);
+                words[i] = (high << 32) | (low & 0xFFFFFFFFULL);
+                carry = high >> 32;
+            }
+            return carry != 0;
+        }
+    }
+
+    UInt256::UInt256() {
+        std::memset(words_, 0, sizeof(words_));
+    }
+
+    UInt256::UInt256(uint64_t value) {
+        words_[0] = 0;
+        words_[1] = 0;
+        words_[2] = 0;
+        words_[3] = value;
+    }
+
+    UInt256::UInt256(uint64_t word0, uint64_t word1, uint64_t word2, uint64_t word3) {
+        words_[0] = word0;
+        words_[1] = word1;
+        words_[2] = word2;
+        words_[3] = word3;
+    }
+
+    UInt256 UInt256::fromBytes(const uint8_t* data, size_t size) {
+        if (size > BYTES) {
+            throw std::invalid_argument("UInt256 cannot hold more than 32 bytes");
+        }
+
+        // Вирівнюємо по правому краю 32-байтового буфера і читаємо словами
+        uint8_t bytes[BYTES] = {0};
+        if (size > 0) {
+            std::memcpy(bytes + BYTES - size, data, size);
+        }
+        UInt256 result;
+        for (size_t i = 0; i < WORDS; ++i) {
+            result.words_[i] = BitString::loadWord(bytes + i * 8);
+        }
+        return result;
+    }
+
+    UInt256 UInt256::fromString(const std::string& decimal) {
+        if (decimal.empty()) {
+            throw std::invalid_argument("Empty decimal string");
+        }
+
+        UInt256 result;
+        for (char c : decimal) {
+            if (c < '0' || c > '9') {
+                throw std::invalid_argument("Invalid decimal digit");
+            }
+            if (multiplyAddSmall(result.words_, 10, static_cast<uint32_t>(c - '0'))) {
+                throw std::overflow_error("Decimal value exceeds 256 bits");
+            }
+        }
+        return result;
+    }
+
+    void UInt256::toBytes(uint8_t* out, size_t size) const {
+        if (size > BYTES) {
+            throw std::invalid_argument("UInt256 cannot hold more than 32 bytes");
+        }
+        if (byteLength() > size) {
+            throw std::overflow_error("Value does not fit in requested byte count");
+        }
+
+        uint8_t bytes[BYTES];
+        for (size_t i = 0; i < WORDS; ++i) {
+            BitString::storeWord(bytes + i * 8, words_[i]);
+        }
+        std::memcpy(out, bytes + BYTES - size, size);
+    }
+
+    std::string UInt256::toString() const {
+        if (isZero()) {
+            return "0";
+        }
+
+        // Відділяємо по 9 десяткових цифр за раз
+        std::string digits;
+        UInt256 rest = *this;
+        while (!rest.isZero()) {
+            uint32_t chunk = divideSmall(rest.words_, DECIMAL_CHUNK);
+            for (size_t i = 0; i < DECIMAL_CHUNK_DIGITS; ++i) {
+                digits.push_back(static_cast<char>('0' + chunk % 10));
+                chunk /= 10;
+            }
+        }
+        while (digits.size() > 1 && digits.back() == '0') {
+            digits.pop_back();
+        }
+        std::reverse(digits.begin(), digits.end());
+        return digits;
+    }
+
+    uint64_t UInt256::toUInt64() const {
+        if (words_[0] != 0 || words_[1] != 0 || words_[2] != 0) {
+            throw std::overflow_error("Value does not fit in 64 bits");
+        }
+        return words_[3];
+    }
+
+    size_t UInt256::bitLength() const {
+        for (size_t i = 0; i < WORDS; ++i) {
+            uint64_t word = words_[i];
+            if (word != 0) {
+                size_t bits = 0;
+                for (; word != 0; word >>= 1) {
+                    ++bits;
+                }
+                return (WORDS - 1 - i) * 64 + bits;
+            }
+        }
+        return 0;
+    }
+
+    bool UInt256::isZero() const {
+        return (words_[0] | words_[1] | words_[2] | words_[3]) == 0;
+    }
+
+    unsigned UInt256::varUIntLengthBits(size_t maxBytes) {
+        if (maxBytes == 0 || maxBytes > BYTES + 1) {
+            throw std::invalid_argument("VarUInteger size must be between 1 and 33 bytes");
+        }
+        unsigned bits = 0;
+        while ((static_cast<size_t>(1) << bits) < maxBytes) {
+            ++bits;
+        }
+        return bits;
+    }
+
+    UInt256& UInt256::operator+=(const UInt256& other) {
+        uint64_t carry = 0;
+        for (size_t i = WORDS; i-- > 0;) {
+            uint64_t sum = words_[i] + other.words_[i];
+            uint64_t nextCarry = sum < words_[i] ? 1 : 0;
+            words_[i] = sum + carry;
+            nextCarry |= (words_[i] < sum) ? 1 : 0;
+            carry = nextCarry;
+        }
+        if (carry != 0) {
+            throw std::overflow_error("UInt256 addition overflow");
+        }
+        return *this;
+    }
+
+    UInt256& UInt256::operator-=(const UInt256& other) {
+        if (*this < other) {
+            throw std::overflow_error("UInt256 subtraction underflow");
+        }
+        uint64_t borrow = 0;
+        for (size_t i = WORDS; i-- > 0;) {
+            uint64_t difference = words_[i] - other.words_[i];
+            uint64_t nextBorrow = words_[i] < other.words_[i] ? 1 : 0;
+            nextBorrow |= difference < borrow ? 1 : 0;
+            words_[i] = difference - borrow;
+            borrow = nextBorrow;
+        }
+        return *this;
+    }
+
+    UInt256 operator+(UInt256 a, const UInt256& b) {
+        return a += b;
+    }
+
+    UInt256 operator-(UInt256 a, const UInt256& b) {
+        return a -= b;
+    }
+
+    bool operator==(const UInt256& a, const UInt256& b) {
+        return std::memcmp(a.words_, b.words_, sizeof(a.words_)) == 0;
+    }
+
+    bool operator<(const UInt256& a, const UInt256& b) {
+        for (size_t i = 0; i < UInt256::WORDS; ++i) {
+            if (a.words_[i] != b.words_[i]) {
+                return a.words_[i] < b.words_[i];
+            }
+        }
+        return false;
+    }
+}
@@ -81,7 +81,7 @@ int main() {
         // 5. BOC (Bag of Cells) demonstration
         // 5. Демонстрация BOC (Bag of Cells)
         std::cout << "\n5. BOC Operations:" << std::endl;
-        auto root = std::make_shared<Cell>(*cell);
+        auto root = Cell::create(*cell);
         Boc boc(root);
         auto serialized = boc.serialize(true, true);
         std::cout << "   Serialized BOC to " << serialized.size() << " bytes" << std::endl;
@@ -0,0 +1,198 @@
+// AugmentedDictionaryTest.cpp - тести для AugmentedDictionary класу
+// Author: Андрій Будильников (Sparky)
+// Unit tests for AugmentedDictionary class
+// Модульные тесты для класса AugmentedDictionary
+
+#include "TestFramework.h"
+#include "../include/AugmentedDictionary.h"
+#include "../include/Boc.h"
+#include <vector>
+#include <algorithm>
+
+using namespace cton;
+
+namespace {
+    typedef AugmentedDictionary<CoinsAugmentation> FeeDictionary;
+
+    // Extra з посиланням: сума лежить в окремій комірці
+    struct RefSumAugmentation {
+        typedef uint64_t Extra;
+
+        static Extra zero() { return 0; }
+        static Extra combine(const Extra& left, const Extra& right) { return left + right; }
+        static void store(CellBuilder& builder, const Extra& extra) {
+            builder.storeRef(CellBuilder().storeUInt(64, extra).build());
+        }
+        static Extra load(CellSlice& slice) {
+            CellSlice sum(*slice.loadRef());
+            return sum.loadUInt(64);
+        }
+    };
+
+    typedef AugmentedDictionary<RefSumAugmentation> RefSumDictionary;
+
+    CellRef makeValue(uint64_t value) {
+        CellBuilder builder;
+        builder.storeUInt(16, value);
+        return builder.build();
+    }
+
+    std::vector<uint8_t> packKeys(size_t keyBits, const std::vector<uint64_t>& keys) {
+        size_t keyBytes = (keyBits + 7) / 8;
+        std::vector<uint8_t> packed(keys.size() * keyBytes + 8);
+        uint8_t key[8];
+        for (size_t i = 0; i < keys.size(); ++i) {
+            Dictionary::packKey(keyBits, keys[i], key);
+            std::copy(key, key + keyBytes, packed.begin() + i * keyBytes);
+        }
+        return packed;
+    }
+}
+
+TEST(AugmentedForkCarriesSum) {
+    std::vector<uint8_t> keys = packKeys(8, {0x00, 0x80});
+    UInt256 extras[] = {UInt256(5), UInt256(7)};
+    CellRef values[] = {makeValue(1), makeValue(2)};
+    FeeDictionary dict = FeeDictionary::build(8, keys.data(), extras, values, 2);
+
+    // Корінь: порожня мітка (00) і сума 12 як Coins (0001 00001100)
+    auto root = dict.dictionary().getRoot();
+    ASSERT_EQUAL(14, root->getBitSize());
+    ASSERT_EQUAL(0x04, root->getData()[0]);
+    ASSERT_EQUAL(0x30, root->getData()[1]);
+    ASSERT_TRUE(dict.total() == UInt256(12));
+
+    CellSlice value;
+    UInt256 extra;
+    uint8_t key[8];
+    Dictionary::packKey(8, 0x80, key);
+    ASSERT_TRUE(dict.get(key, value, extra));
+    ASSERT_TRUE(extra == UInt256(7));
+    ASSERT_EQUAL(2, value.loadUInt(16));
+}
+
+TEST(AugmentedUpdatesMatchBuild) {
+    const size_t keyBits = 32;
+    std::vector<uint64_t> allKeys;
+    std::vector<UInt256> allExtras;
+    std::vector<CellRef> allValues;
+    for (uint64_t i = 0; i < 200; ++i) {
+        allKeys.push_back(i * 104729 % 4294967291ULL);
+        allExtras.push_back(UInt256(i * 1000 + 1));
+        allValues.push_back(makeValue(i));
+    }
+
+    // Вставка у довільному порядку
+    FeeDictionary dict(keyBits);
+    uint8_t key[8];
+    UInt256 sum;
+    for (size_t i = 0; i < allKeys.size(); ++i) {
+        Dictionary::packKey(keyBits, allKeys[i], key);
+        dict.set(key, allExtras[i], allValues[i]);
+        sum += allExtras[i];
+    }
+    ASSERT_TRUE(dict.total() == sum);
+
+    // Видалення половини ключів оновлює суму
+    std::vector<uint64_t> keptKeys;
+    std::vector<UInt256> keptExtras;
+    std::vector<CellRef> keptValues;
+    for (size_t i = 0; i < allKeys.size(); ++i) {
+        Dictionary::packKey(keyBits, allKeys[i], key);
+        if (i % 2 == 0) {
+            ASSERT_TRUE(dict.erase(key));
+            sum -= allExtras[i];
+        }
+    }
+    ASSERT_TRUE(dict.total() == sum);
+
+    // Той самий корінь, що й при побудові з відсортованих записів
+    for (DictionaryIterator it = dict.dictionary().begin(); it.valid(); it.next()) {
+        CellSlice leaf = it.value();
+        keptKeys.push_back(it.keyUInt());
+        keptExtras.push_back(CoinsAugmentation::load(leaf));
+        keptValues.push_back(makeValue(leaf.loadUInt(16)));
+    }
+    ASSERT_EQUAL(100, keptKeys.size());
+    std::vector<uint8_t> packed = packKeys(keyBits, keptKeys);
+    FeeDictionary rebuilt = FeeDictionary::build(keyBits, packed.data(), keptExtras.data(),
+                                                 keptValues.data(), keptKeys.size());
+    ASSERT_TRUE(rebuilt.dictionary().getRoot()->hash() == dict.dictionary().getRoot()->hash());
+}
+
+TEST(AugmentedStoreLoad) {
+    std::vector<uint8_t> keys = packKeys(16, {1, 2, 3, 500});
+    UInt256 extras[] = {UInt256(10), UInt256(20), UInt256(30), UInt256(40)};
+    CellRef values[] = {makeValue(1), makeValue(2), makeValue(3), makeValue(4)};
+    FeeDictionary dict = FeeDictionary::build(16, keys.data(), extras, values, 4);
+
+    CellBuilder holder;
+    dict.store(holder);
+    holder.storeUInt(8, 0xAB);
+    auto serialized = Boc(holder.build()).serialize();
+    auto restoredHolder = Boc::deserialize(serialized).getRoot();
+
+    CellSlice slice(*restoredHolder);
+    FeeDictionary restored = FeeDictionary::load(slice, 16);
+    ASSERT_EQUAL(0xAB, slice.loadUInt(8));
+    ASSERT_TRUE(restored.total() == UInt256(100));
+
+    // Порожній словник: 0 і нульовий extra
+    CellBuilder emptyHolder;
+    FeeDictionary(16).store(emptyHolder);
+    auto empty = emptyHolder.build();
+    ASSERT_EQUAL(1 + 4, empty->getBitSize());
+    CellSlice emptySlice(*empty);
+    ASSERT_TRUE(FeeDictionary::load(emptySlice, 16).total().isZero());
+}
+
+TEST(AugmentedExtraWithReferences) {
+    const size_t keyBits = 16;
+    std::vector<uint64_t> keys = {3, 9, 200, 4000, 65000};
+    std::vector<uint64_t> extras = {1, 2, 3, 4, 5};
+    std::vector<CellRef> values;
+    for (uint64_t key : keys) {
+        values.push_back(makeValue(key));
+    }
+    std::vector<uint8_t> packed = packKeys(keyBits, keys);
+    RefSumDictionary dict = RefSumDictionary::build(keyBits, packed.data(), extras.data(), values.data(), keys.size());
+
+    // Розгалуження: гілки - посилання 0 і 1, extra - після них
+    auto root = dict.dictionary().getRoot();
+    ASSERT_EQUAL(3, root->getRefsCount());
+    ASSERT_EQUAL(15, CellSlice(*root->getReference(2)).loadUInt(64));
+    ASSERT_EQUAL(15, dict.total());
+
+    uint8_t key[8];
+    CellSlice value;
+    uint64_t extra = 0;
+    Dictionary::packKey(keyBits, 4000, key);
+    ASSERT_TRUE(dict.get(key, value, extra));
+    ASSERT_EQUAL(4, extra);
+    ASSERT_EQUAL(4000, value.loadUInt(16));
+
+    // Зміни дають той самий корінь, що й побудова
+    RefSumDictionary updated(keyBits);
+    for (size_t i = keys.size(); i-- > 0;) {
+        Dictionary::packKey(keyBits, keys[i], key);
+        updated.set(key, extras[i], values[i]);
+    }
+    Dictionary::packKey(keyBits, 7, key);
+    updated.set(key, 100, makeValue(7));
+    ASSERT_EQUAL(115, updated.total());
+    ASSERT_TRUE(updated.erase(key));
+    ASSERT_TRUE(updated.dictionary().getRoot()->hash() == root->hash());
+
+    CellBuilder holder;
+    dict.store(holder);
+    auto serialized = Boc(holder.build()).serialize();
+    auto restoredHolder = Boc::deserialize(serialized).getRoot();
+    CellSlice slice(*restoredHolder);
+    RefSumDictionary restored = RefSumDictionary::load(slice, keyBits);
+    ASSERT_EQUAL(0, slice.remainingRefs());
+    ASSERT_EQUAL(15, restored.total());
+}
+
+int main() {
+    return RUN_ALL_TESTS();
+}
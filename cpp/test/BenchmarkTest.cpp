@@ -100,12 +100,12 @@ void testBocPerformance() {
     
     {
         Benchmark b("Create BOC with 1000 nested cells");
-        auto root = std::make_shared<Cell>();
+        auto root = Cell::create();
         root->storeUInt(32, 0x12345678);
         
         auto current = root;
         for (int i = 0; i < 1000; ++i) {
-            auto newCell = std::make_shared<Cell>();
+            auto newCell = Cell::create();
             newCell->storeUInt(32, i);
             current->addReference(newCell);
             current = newCell;
@@ -116,12 +116,12 @@ void testBocPerformance() {
     
     {
         Benchmark b("Serialize BOC with 1000 cells");
-        auto root = std::make_shared<Cell>();
+        auto root = Cell::create();
         root->storeUInt(32, 0x12345678);
         
         auto current = root;
         for (int i = 0; i < 1000; ++i) {
-            auto newCell = std::make_shared<Cell>();
+            auto newCell = Cell::create();
             newCell->storeUInt(32, i);
             current->addReference(newCell);
             current = newCell;
@@ -133,12 +133,12 @@ void testBocPerformance() {
     
     {
         Benchmark b("Deserialize BOC with 1000 cells");
-        auto root = std::make_shared<Cell>();
+        auto root = Cell::create();
         root->storeUInt(32, 0x12345678);
         
         auto current = root;
         for (int i = 0; i < 1000; ++i) {
-            auto newCell = std::make_shared<Cell>();
+            auto newCell = Cell::create();
             newCell->storeUInt(32, i);
             current->addReference(newCell);
             current = newCell;
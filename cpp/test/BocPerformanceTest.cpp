@@ -26,12 +26,12 @@ int main() {
         // Створюємо 1000 комірок у ланцюжку
         // Create 1000 cells in a chain
         // Создаем 1000 ячеек в цепочке
-        std::shared_ptr<Cell> root = std::make_shared<Cell>();
+        CellRef root = Cell::create();
         root->storeUInt(32, 0x12345678);
         
-        std::shared_ptr<Cell> current = root;
+        CellRef current = root;
         for (int i = 0; i < 1000; ++i) {
-            auto newCell = std::make_shared<Cell>();
+            auto newCell = Cell::create();
             newCell->storeUInt(32, i);
             newCell->storeBytes({static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8)});
             current->addReference(newCell);
@@ -6,6 +6,9 @@
 #include "TestFramework.h"
 #include "../include/Boc.h"
 #include "../include/Cell.h"
+#include "../include/CellArena.h"
+#include "../include/CellInterner.h"
+#include "../include/CellSlice.h"
 #include <cstring>
 
 using namespace cton;
@@ -196,6 +199,241 @@ TEST(BocRoundTrip) {
     }
 }
 
+TEST(BocRoundTripSharedCells) {
+    // DAG зі спільною дочірньою коміркою і понад 128 комірками (багатобайтові індекси)
+    CellBuilder sharedBuilder;
+    sharedBuilder.storeUInt(5, 0x15);
+    auto shared = sharedBuilder.build();
+    
+    CellRef chain = shared;
+    for (int i = 0; i < 200; ++i) {
+        CellBuilder builder;
+        builder.storeUInt(8, static_cast<uint64_t>(i));
+        builder.storeRef(chain);
+        builder.storeRef(shared);
+        chain = builder.build();
+    }
+    
+    auto serialized = Boc(chain).serialize(true, true);
+    Boc deserialized = Boc::deserialize(serialized);
+    auto root = deserialized.getRoot();
+    ASSERT_TRUE(root != nullptr);
+    ASSERT_EQUAL(2, root->getRefsCount());
+    ASSERT_EQUAL(200, root->depth());
+    ASSERT_TRUE(root->hash() == chain->hash());
+}
+
+TEST(BocParseIntoArena) {
+    CellBuilder childBuilder;
+    childBuilder.storeUInt(12, 0xABC);
+    auto child = childBuilder.build();
+    
+    CellBuilder rootBuilder;
+    rootBuilder.storeBytes({0x01, 0x02, 0x03});
+    rootBuilder.storeRef(child);
+    rootBuilder.storeRef(child);
+    auto original = rootBuilder.build();
+    
+    auto serialized = Boc(original).serialize(false, false);
+    
+    CellArena arena;
+    {
+        Boc boc = Boc::deserialize(serialized, arena);
+        auto root = boc.getRoot();
+        ASSERT_EQUAL(24, root->getBitSize());
+        ASSERT_EQUAL(2, root->getRefsCount());
+        ASSERT_TRUE(root->hash() == original->hash());
+    }
+    ASSERT_TRUE(arena.getAllocatedBytes() > 0);
+}
+
+TEST(BocParseWithInterner) {
+    CellBuilder childBuilder;
+    childBuilder.storeUInt(12, 0xABC);
+    auto child = childBuilder.build();
+    
+    CellBuilder rootBuilder;
+    rootBuilder.storeBytes({0x01, 0x02, 0x03});
+    rootBuilder.storeRef(child);
+    auto original = rootBuilder.build();
+    
+    auto serialized = Boc(original).serialize(false, false);
+    
+    CellInterner interner;
+    Boc first = Boc::deserialize(serialized, interner);
+    Boc second = Boc::deserialize(serialized, interner);
+    ASSERT_TRUE(first.getRoot().get() == second.getRoot().get());
+    ASSERT_TRUE(first.getRoot()->hash() == original->hash());
+    ASSERT_EQUAL(2, interner.size());
+}
+
+TEST(BocRoundTripMerkleProof) {
+    CellBuilder leafBuilder;
+    leafBuilder.storeUInt(24, 0x123456);
+    auto leaf = leafBuilder.build();
+    
+    CellBuilder subtreeBuilder;
+    subtreeBuilder.storeUInt(5, 0x1B);
+    subtreeBuilder.storeRef(leaf);
+    auto subtree = subtreeBuilder.build();
+    
+    CellBuilder rootBuilder;
+    rootBuilder.storeUInt(8, 0x77);
+    rootBuilder.storeRef(Cell::createPrunedBranch(*subtree, 1));
+    rootBuilder.storeRef(leaf);
+    auto proof = Cell::createMerkleProof(rootBuilder.build());
+    
+    for (int withHashes = 0; withHashes < 2; ++withHashes) {
+        auto serialized = Boc(proof).serialize(true, true, withHashes != 0);
+        Boc restored = Boc::deserialize(serialized);
+        auto root = restored.getRoot();
+        ASSERT_TRUE(root->getType() == CellType::MerkleProof);
+        ASSERT_TRUE(root->hash() == proof->hash());
+        ASSERT_EQUAL(1, root->getReference(0)->getLevelMask());
+        ASSERT_TRUE(root->getReference(0)->hash(0) == proof->getReference(0)->hash(0));
+    }
+    
+    // Пошкоджений збережений хеш відкидається
+    auto serialized = Boc(proof).serialize(false, false, true);
+    bool rejected = false;
+    for (size_t i = serialized.size() - 40; i < serialized.size(); ++i) {
+        auto corrupted = serialized;
+        corrupted[i] ^= 0x01;
+        try {
+            Boc::deserialize(corrupted);
+        } catch (const std::exception&) {
+            rejected = true;
+        }
+    }
+    ASSERT_TRUE(rejected);
+}
+
+TEST(BocViewLazyCells) {
+    CellBuilder leafBuilder;
+    leafBuilder.storeUInt(16, 0xBEEF);
+    auto leaf = leafBuilder.build();
+    
+    CellBuilder rootBuilder;
+    rootBuilder.storeUInt(8, 0x42);
+    rootBuilder.storeRef(leaf);
+    rootBuilder.storeRef(leaf);
+    auto root = rootBuilder.build();
+    
+    for (int hasIdx = 0; hasIdx < 2; ++hasIdx) {
+        BocView view(Boc(root).serialize(hasIdx != 0));
+        ASSERT_EQUAL(2, view.getCellCount());
+        ASSERT_EQUAL(1, view.getRootCount());
+        
+        size_t rootIndex = view.getRootIndex();
+        ASSERT_EQUAL(2, view.getRefsCount(rootIndex));
+        size_t leafIndex = view.getRefIndex(rootIndex, 1);
+        ASSERT_EQUAL(leafIndex, view.getRefIndex(rootIndex, 0));
+        
+        Cell data = view.loadCellData(leafIndex);
+        ASSERT_EQUAL(16, data.getBitSize());
+        ASSERT_EQUAL(0, data.getRefsCount());
+        
+        // Повторна матеріалізація повертає ту саму комірку
+        auto restored = view.getRoot();
+        ASSERT_TRUE(restored->hash() == root->hash());
+        ASSERT_TRUE(view.loadCell(leafIndex).get() == restored->getReference(0).get());
+        bool thrown = false;
+        try {
+            view.getRefIndex(leafIndex, 0);
+        } catch (const std::out_of_range&) {
+            thrown = true;
+        }
+        ASSERT_TRUE(thrown);
+    }
+}
+
+TEST(BocViewDeepChain) {
+    // Ланцюжок, який рекурсивна матеріалізація не пройшла б на стеку за замовчуванням
+    const size_t length = 60000;
+    CellRef chain;
+    for (size_t i = 0; i < length; ++i) {
+        CellBuilder builder;
+        builder.storeUInt(32, i);
+        if (chain) {
+            builder.storeRef(chain);
+        }
+        chain = builder.build();
+    }
+    
+    BocView view(Boc(chain).serialize());
+    ASSERT_EQUAL(length, view.getCellCount());
+    
+    // Спершу середина ланцюжка, потім корінь доходить до вже закешованих комірок
+    size_t middle = view.getRootIndex() + length / 2;
+    CellRef tail = view.loadCell(middle);
+    const Cell* expected = chain.get();
+    for (size_t i = 0; i < length / 2; ++i) {
+        expected = expected->getReference(0).get();
+    }
+    ASSERT_TRUE(tail->hash() == expected->hash());
+    
+    CellRef restored = view.getRoot();
+    ASSERT_TRUE(restored->hash() == chain->hash());
+    ASSERT_TRUE(view.loadCell(middle).get() == tail.get());
+}
+
+TEST(BocSerializeDeepChain) {
+    // Серіалізація нехешованого ланцюжка і довгого snake: хешування не рекурсивне
+    const size_t length = 60000;
+    CellRef chain;
+    for (size_t i = 0; i < length; ++i) {
+        CellBuilder builder;
+        builder.storeUInt(32, i);
+        if (chain) {
+            builder.storeRef(chain);
+        }
+        chain = builder.build();
+    }
+    auto serialized = Boc(chain).serialize(true, true, true);
+    CellRef restored = Boc::deserialize(serialized).getRoot();
+    ASSERT_TRUE(restored->hash() == chain->hash());
+    
+    std::vector<uint8_t> payload(1900000);
+    for (size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<uint8_t>(i * 131 + 7);
+    }
+    CellRef snake = CellBuilder().storeSnakeBytes(payload).build();
+    CellRef snakeRestored = Boc::deserialize(Boc(snake).serialize()).getRoot();
+    CellSlice slice(*snakeRestored);
+    ASSERT_TRUE(slice.loadSnakeBytes() == payload);
+}
+
+TEST(BocRejectsHostileHeader) {
+    // Кількість комірок ~2^35 при кількох байтах даних
+    std::vector<uint8_t> huge = {0xB5, 0xEE, 0x90, 0x20, 0x80, 0xFF, 0xFF, 0xFF, 0xFF, 0x7F,
+                                 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00};
+    // Число з 11 байтів не вміщується в size_t
+    std::vector<uint8_t> overflow = {0xB5, 0xEE, 0x90, 0x20, 0x00};
+    for (int i = 0; i < 10; ++i) {
+        overflow.push_back(0xFF);
+    }
+    overflow.push_back(0x01);
+    
+    const std::vector<uint8_t>* inputs[] = {&huge, &overflow};
+    for (const std::vector<uint8_t>* input : inputs) {
+        bool rejected = false;
+        try {
+            Boc::deserialize(*input);
+        } catch (const std::invalid_argument&) {
+            rejected = true;
+        }
+        ASSERT_TRUE(rejected);
+        
+        rejected = false;
+        try {
+            BocView view(*input);
+        } catch (const std::invalid_argument&) {
+            rejected = true;
+        }
+        ASSERT_TRUE(rejected);
+    }
+}
+
 int main() {
     return RUN_ALL_TESTS();
 }
\ No newline at end of file
@@ -0,0 +1,133 @@
+// CellEditorTest.cpp - тести для CellEditor класу
+// Author: Андрій Будильников (Sparky)
+// Unit tests for CellEditor class
+// Модульные тесты для класса CellEditor
+
+#include "TestFramework.h"
+#include "../include/CellEditor.h"
+#include "../include/CellSlice.h"
+#include <vector>
+
+using namespace cton;
+
+namespace {
+    CellRef makeLeaf(uint64_t value) {
+        CellBuilder builder;
+        builder.storeUInt(32, value);
+        return builder.build();
+    }
+
+    /**
+     * @brief Повне бінарне дерево глибини depth; листи нумеруються зліва направо
+     */
+    CellRef makeTree(size_t depth, uint64_t& nextLeaf, uint64_t changedLeaf, uint64_t changedValue) {
+        if (depth == 0) {
+            uint64_t leaf = nextLeaf++;
+            return makeLeaf(leaf == changedLeaf ? changedValue : leaf);
+        }
+        CellBuilder builder;
+        builder.storeUInt(8, depth);
+        builder.storeRef(makeTree(depth - 1, nextLeaf, changedLeaf, changedValue));
+        builder.storeRef(makeTree(depth - 1, nextLeaf, changedLeaf, changedValue));
+        return builder.build();
+    }
+
+    CellRef makeTree(size_t depth, uint64_t changedLeaf = ~0ULL, uint64_t changedValue = 0) {
+        uint64_t nextLeaf = 0;
+        return makeTree(depth, nextLeaf, changedLeaf, changedValue);
+    }
+}
+
+TEST(CellEditorReplaceLeafMatchesRebuild) {
+    CellRef original = makeTree(6);
+    Cell::Hash originalHash = original->hash();
+
+    // Лист 0b101100 = 44: шлях 1, 0, 1, 1, 0, 0
+    CellRef edited = CellEditor::replaceAt(original, {1, 0, 1, 1, 0, 0}, makeLeaf(1000));
+    ASSERT_TRUE(edited->hash() == makeTree(6, 44, 1000)->hash());
+    ASSERT_TRUE(edited->depth() == original->depth());
+
+    // Старе дерево не змінилось
+    ASSERT_TRUE(original->hash() == originalHash);
+}
+
+TEST(CellEditorSharesUntouchedSubtrees) {
+    CellRef original = makeTree(4);
+    CellEditor editor(original);
+    editor.down(0).down(1);
+    uint8_t data[] = {0xAB, 0xCD};
+    editor.setData(data, 16);
+    ASSERT_EQUAL(2, editor.depth());
+    CellRef edited = editor.root();
+
+    // Нові комірки лише на шляху, сусідні піддерева - ті самі об'єкти
+    ASSERT_TRUE(edited.get() != original.get());
+    ASSERT_TRUE(edited->getReference(1).get() == original->getReference(1).get());
+    ASSERT_TRUE(edited->getReference(0).get() != original->getReference(0).get());
+    ASSERT_TRUE(edited->getReference(0)->getReference(0).get() ==
+                original->getReference(0)->getReference(0).get());
+
+    // Змінена комірка зберегла посилання
+    const CellRef& changed = edited->getReference(0)->getReference(1);
+    ASSERT_EQUAL(16, changed->getBitSize());
+    ASSERT_EQUAL(0xAB, changed->getData()[0]);
+    ASSERT_TRUE(changed->getReference(0).get() == original->getReference(0)->getReference(1)->getReference(0).get());
+}
+
+TEST(CellEditorMultipleEdits) {
+    CellRef original = makeTree(3);
+    CellEditor editor(original);
+
+    // Без змін корінь той самий
+    ASSERT_TRUE(editor.root().get() == original.get());
+
+    editor.down(0).down(0).down(0).replace(makeLeaf(100));
+    editor.up().up().down(1).down(1).replace(makeLeaf(200));
+    editor.toRoot().down(1).setReference(1, makeLeaf(300));
+    ASSERT_EQUAL(1, editor.depth());
+    CellRef edited = editor.root();
+
+    CellSlice first(*edited->getReference(0)->getReference(0)->getReference(0));
+    ASSERT_EQUAL(100, first.loadUInt(32));
+    CellSlice second(*edited->getReference(0)->getReference(1)->getReference(1));
+    ASSERT_EQUAL(200, second.loadUInt(32));
+    CellSlice third(*edited->getReference(1)->getReference(1));
+    ASSERT_EQUAL(300, third.loadUInt(32));
+    ASSERT_EQUAL(0, edited->getReference(1)->getReference(1)->getRefsCount());
+
+    // Редагування можна продовжувати після root()
+    editor.replace(makeLeaf(7));
+    ASSERT_TRUE(editor.root()->getReference(1) == editor.current());
+    ASSERT_TRUE(editor.root()->getReference(0).get() == edited->getReference(0).get());
+}
+
+TEST(CellEditorRejectsInvalidNavigation) {
+    CellEditor editor(makeTree(1));
+    bool thrown = false;
+    try {
+        editor.down(2);
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    ASSERT_TRUE(thrown);
+
+    thrown = false;
+    try {
+        editor.up();
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    ASSERT_TRUE(thrown);
+
+    thrown = false;
+    try {
+        editor.down(0).replace(CellRef());
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    ASSERT_TRUE(thrown);
+}
+
+int main() {
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,229 @@
+// CellGraphTest.cpp - тести для CellGraph класу
+// Author: Андрій Будильников (Sparky)
+// Unit tests for CellGraph class
+// Модульные тесты для класса CellGraph
+
+#include "TestFramework.h"
+#include "../include/CellGraph.h"
+#include "../include/Boc.h"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+
+using namespace cton;
+
+namespace {
+    CellRef makeCell(uint64_t value, size_t bits, const std::vector<CellRef>& refs) {
+        CellBuilder builder;
+        builder.storeUInt(bits, value);
+        for (const CellRef& ref : refs) {
+            builder.storeRef(ref);
+        }
+        return builder.build();
+    }
+
+    /**
+     * @brief Merkle update зі спільною бібліотечною коміркою і обрізаною гілкою
+     */
+    CellRef makeUpdate(CellRef& to) {
+        CellRef leaf = makeCell(0x123456, 24, {});
+        CellRef library = Cell::createLibrary(leaf->hash());
+        CellRef oldState = makeCell(0x1B, 5, {leaf, library});
+        CellRef from = makeCell(0x11, 8, {Cell::createPrunedBranch(*oldState, 1), library});
+        to = makeCell(0x2C, 6, {oldState, library});
+        return Cell::createMerkleUpdate(from, to);
+    }
+
+    // Число BOC: групи по 7 бітів від старших, біт 0x80 - продовження
+    void appendVarUInt(std::vector<uint8_t>& out, size_t value) {
+        size_t shift = 0;
+        while ((value >> (shift + 7)) != 0) {
+            shift += 7;
+        }
+        for (; shift > 0; shift -= 7) {
+            out.push_back(static_cast<uint8_t>(0x80 | ((value >> shift) & 0x7F)));
+        }
+        out.push_back(static_cast<uint8_t>(value & 0x7F));
+    }
+
+    void assertSameHashes(const CellGraph& graph, CellGraph::Index index, const CellRef& cell) {
+        ASSERT_TRUE(graph.hash(index) == cell->hash());
+        ASSERT_EQUAL(cell->depth(), graph.depth(index));
+        ASSERT_EQUAL(cell->getRefsCount(), graph.refCount(index));
+        for (size_t i = 0; i < cell->getRefsCount(); ++i) {
+            assertSameHashes(graph, graph.ref(index, i), cell->getReference(i));
+        }
+    }
+}
+
+TEST(GraphFromCellRoundTrip) {
+    CellRef to;
+    CellRef root = makeUpdate(to);
+    CellGraph graph = CellGraph::fromCell(root);
+
+    // Спільні комірки зберігаються один раз; прапорці спеціальних комірок і маски рівнів - у дескрипторах
+    ASSERT_EQUAL(7, graph.cellCount());
+    ASSERT_EQUAL(1, graph.rootCount());
+    ASSERT_EQUAL(0, graph.root());
+    ASSERT_TRUE(graph.isSpecial(0));
+    ASSERT_EQUAL(0, graph.levelMask(0));
+    ASSERT_EQUAL(1, graph.levelMask(graph.ref(0, 0)));
+    ASSERT_EQUAL(0, graph.levelMask(graph.ref(0, 1)));
+    size_t specialCount = 0;
+    for (CellGraph::Index i = 0; i < graph.cellCount(); ++i) {
+        specialCount += graph.isSpecial(i) ? 1 : 0;
+        for (size_t j = 0; j < graph.refCount(i); ++j) {
+            ASSERT_TRUE(graph.ref(i, j) > i);
+        }
+    }
+    ASSERT_EQUAL(3, specialCount);
+
+    ASSERT_FALSE(graph.hasHashes());
+    bool threw = false;
+    try {
+        graph.hash(0);
+    } catch (const std::logic_error&) {
+        threw = true;
+    }
+    ASSERT_TRUE(threw);
+
+    graph.computeHashes();
+    ASSERT_TRUE(graph.hasHashes());
+    assertSameHashes(graph, 0, root);
+
+    CellRef restored = graph.toCell();
+    ASSERT_TRUE(restored->hash() == root->hash());
+    ASSERT_TRUE(restored->isSpecial());
+    ASSERT_TRUE(graph.toCell(graph.ref(0, 1))->hash() == to->hash());
+    ASSERT_TRUE(graph.memoryUsage() > 0);
+}
+
+TEST(GraphParsedFromBoc) {
+    CellRef to;
+    CellRef root = makeUpdate(to);
+    for (int withHashes = 0; withHashes < 2; ++withHashes) {
+        auto serialized = Boc(root).serialize(withHashes == 0, true, withHashes != 0);
+        CellGraph graph = BocParser(serialized).parseGraph();
+        ASSERT_EQUAL(7, graph.cellCount());
+        ASSERT_EQUAL(withHashes != 0, graph.hasHashes());
+
+        // Completion tag не потрапляє в дані графа
+        CellGraph::Index rootIndex = graph.root();
+        ASSERT_TRUE(graph.toCell(rootIndex)->hash() == root->hash());
+        graph.computeHashes();
+        assertSameHashes(graph, rootIndex, root);
+    }
+
+    // Пошкоджений збережений хеш відкидається
+    auto serialized = Boc(root).serialize(false, false, true);
+    bool rejected = false;
+    for (size_t i = serialized.size() - 40; i < serialized.size() && !rejected; ++i) {
+        auto corrupted = serialized;
+        corrupted[i] ^= 0x01;
+        try {
+            BocParser(corrupted).parseGraph();
+        } catch (const std::exception&) {
+            rejected = true;
+        }
+    }
+    ASSERT_TRUE(rejected);
+}
+
+TEST(GraphMultipleRoots) {
+    CellRef to;
+    CellRef root = makeUpdate(to);
+    auto serialized = Boc(root).serialize(false, false, false);
+    CellGraph single = BocParser(serialized).parseGraph();
+    single.computeHashes();
+    CellGraph::Index toIndex = 0;
+    for (CellGraph::Index i = 0; i < single.cellCount(); ++i) {
+        if (single.hash(i) == to->hash()) {
+            toIndex = i;
+        }
+    }
+    ASSERT_TRUE(toIndex != 0);
+
+    // Другий корінь дописується в заголовок: магія, прапорці, кількість комірок,
+    // чотири розміри полів, кількість коренів (байт 10), відсутніх, індекси коренів
+    ASSERT_EQUAL(1, serialized[10]);
+    serialized[10] = 2;
+    serialized.insert(serialized.begin() + 13, static_cast<uint8_t>(toIndex));
+
+    CellGraph graph = BocParser(serialized).parseGraph();
+    ASSERT_EQUAL(7, graph.cellCount());
+    ASSERT_EQUAL(2, graph.rootCount());
+    ASSERT_EQUAL(toIndex, graph.root(1));
+    ASSERT_TRUE(graph.toCell(graph.root(0))->hash() == root->hash());
+    ASSERT_TRUE(graph.toCell(graph.root(1))->hash() == to->hash());
+    bool threw = false;
+    try {
+        graph.root(2);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    ASSERT_TRUE(threw);
+}
+
+TEST(GraphHashesWithLevels) {
+    // Merkle proof з обрізаною гілкою: хешування через Cell
+    CellRef leaf = makeCell(0x123456, 24, {});
+    CellRef subtree = makeCell(0x1B, 5, {leaf});
+    CellRef inner = makeCell(0x77, 8, {Cell::createPrunedBranch(*subtree, 1), leaf});
+    CellRef proof = Cell::createMerkleProof(makeCell(0x99, 8, {inner}));
+
+    CellGraph graph = CellGraph::fromCell(proof);
+    ASSERT_TRUE(graph.isSpecial(0));
+    ASSERT_EQUAL(0, graph.levelMask(0));
+    ASSERT_EQUAL(1, graph.levelMask(graph.ref(0, 0)));
+    graph.computeHashes();
+    assertSameHashes(graph, 0, proof);
+
+    auto serialized = Boc(proof).serialize(true, true, true);
+    CellGraph parsed = BocParser(serialized).parseGraph();
+    ASSERT_TRUE(parsed.hash(parsed.root()) == proof->hash());
+    ASSERT_TRUE(parsed.toCell(parsed.root())->hash() == proof->hash());
+}
+
+TEST(GraphDeepChain) {
+    const size_t length = 60000;
+    CellRef chain;
+    for (size_t i = 0; i < length; ++i) {
+        chain = chain ? makeCell(i, 32, {chain}) : makeCell(i, 32, {});
+    }
+
+    CellGraph graph = CellGraph::fromCell(chain);
+    ASSERT_EQUAL(length, graph.cellCount());
+    graph.computeHashes();
+    ASSERT_TRUE(graph.hash(0) == chain->hash());
+    ASSERT_EQUAL(chain->depth(), graph.depth(0));
+    CellRef restored = graph.toCell();
+    ASSERT_TRUE(restored->hash() == chain->hash());
+
+    // Глибину понад 16 бітів, яку Cell відкидає ще до побудови графа, можна отримати
+    // лише з BOC: ланцюжок з 65537 комірок без даних
+    const size_t deepLength = static_cast<size_t>(std::numeric_limits<uint16_t>::max()) + 2;
+    std::vector<uint8_t> boc = {0xB5, 0xEE, 0x90, 0x20, 0x00};
+    appendVarUInt(boc, deepLength);
+    boc.insert(boc.end(), {0, 0, 0, 0, 1, 0});
+    appendVarUInt(boc, 0);
+    for (size_t i = 0; i + 1 < deepLength; ++i) {
+        boc.push_back(0x08);
+        appendVarUInt(boc, i + 1);
+    }
+    boc.push_back(0x00);
+
+    CellGraph deep = BocParser(boc).parseGraph();
+    ASSERT_EQUAL(deepLength, deep.cellCount());
+    bool threw = false;
+    try {
+        deep.computeHashes();
+    } catch (const std::overflow_error&) {
+        threw = true;
+    }
+    ASSERT_TRUE(threw);
+    ASSERT_FALSE(deep.hasHashes());
+}
+
+int main() {
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,347 @@
+// CellSliceTest.cpp - тести для CellSlice класу
+// Author: Андрій Будильников (Sparky)
+// Unit tests for CellSlice class
+// Модульные тесты для класса CellSlice
+
+#include "TestFramework.h"
+#include "../include/Cell.h"
+#include "../include/CellSlice.h"
+#include "../include/BitString.h"
+#include <vector>
+#include <string>
+#include <stdexcept>
+
+using namespace cton;
+
+TEST(SliceLoadUIntAligned) {
+    CellBuilder builder;
+    builder.storeBytes({0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC, 0xDE, 0xF0, 0x11});
+    auto cell = builder.build();
+
+    CellSlice slice(*cell);
+    ASSERT_EQUAL(72, slice.remainingBits());
+    ASSERT_EQUAL(0x12, slice.loadUInt(8));
+    ASSERT_EQUAL(0x3456789ABCDEF011ULL, slice.loadUInt(64));
+    ASSERT_EQUAL(0, slice.remainingBits());
+    ASSERT_TRUE(slice.empty());
+}
+
+TEST(SliceLoadUIntUnaligned) {
+    CellBuilder builder;
+    builder.storeUInt(3, 0x5);
+    builder.storeBytes({0xFF, 0x00, 0xAA, 0x55, 0x01, 0x02, 0x03, 0x04, 0x05});
+    auto cell = builder.build();
+
+    CellSlice slice(*cell);
+    ASSERT_EQUAL(0x5, slice.loadUInt(3));
+    ASSERT_EQUAL(0xFF00AA5501020304ULL, slice.loadUInt(64));
+    ASSERT_EQUAL(0x05, slice.preloadUInt(8));
+    ASSERT_EQUAL(0x0, slice.loadUInt(5));
+    ASSERT_EQUAL(0x5, slice.loadUInt(3));
+}
+
+TEST(SliceLoadInt) {
+    CellBuilder builder;
+    builder.storeInt(4, -3);
+    builder.storeUInt(4, 0x7);
+    auto cell = builder.build();
+
+    CellSlice slice(*cell);
+    ASSERT_EQUAL(-3, slice.preloadInt(4));
+    ASSERT_EQUAL(-3, slice.loadInt(4));
+    ASSERT_EQUAL(7, slice.loadInt(4));
+}
+
+TEST(SliceLoadBitsAndSkip) {
+    std::vector<uint8_t> payload;
+    for (int i = 0; i < 100; ++i) {
+        payload.push_back(static_cast<uint8_t>(i * 7 + 1));
+    }
+
+    CellBuilder builder;
+    builder.storeUInt(4, 0xA);
+    builder.storeBytes(payload);
+    builder.storeUInt(1, 1);
+    auto cell = builder.build();
+
+    CellSlice slice(*cell);
+    ASSERT_TRUE(slice.loadBit());
+    slice.skip(3);
+    ASSERT_TRUE(slice.loadBytes(100) == payload);
+    ASSERT_TRUE(slice.loadBit());
+
+    // Неповний байт: молодші біти результату обнуляються
+    CellSlice partial(*cell);
+    uint8_t out[2] = {0xFF, 0xFF};
+    partial.loadBits(out, 12);
+    ASSERT_EQUAL(0xA0, out[0]);
+    ASSERT_EQUAL(0x10, out[1]);
+}
+
+TEST(SliceRefs) {
+    CellBuilder childBuilder;
+    childBuilder.storeUInt(8, 0x42);
+    auto child = childBuilder.build();
+
+    CellBuilder emptyBuilder;
+    auto empty = emptyBuilder.build();
+
+    CellBuilder builder;
+    builder.storeRef(child);
+    builder.storeRef(empty);
+    auto cell = builder.build();
+
+    CellSlice slice(*cell);
+    ASSERT_EQUAL(2, slice.remainingRefs());
+    ASSERT_TRUE(slice.preloadRef(1).get() == empty.get());
+
+    CellSlice childSlice(*slice.loadRef());
+    ASSERT_EQUAL(0x42, childSlice.loadUInt(8));
+    slice.skipRefs(1);
+    ASSERT_EQUAL(0, slice.remainingRefs());
+    ASSERT_TRUE(slice.empty());
+}
+
+TEST(SliceUnderflow) {
+    CellBuilder builder;
+    builder.storeUInt(5, 0x1F);
+    auto cell = builder.build();
+
+    CellSlice slice(*cell);
+    try {
+        slice.loadUInt(6);
+        ASSERT_TRUE(false);
+    } catch (const std::out_of_range&) {
+        ASSERT_TRUE(true);
+    }
+
+    try {
+        slice.loadRef();
+        ASSERT_TRUE(false);
+    } catch (const std::out_of_range&) {
+        ASSERT_TRUE(true);
+    }
+    ASSERT_EQUAL(5, slice.remainingBits());
+}
+
+TEST(SliceFullCell) {
+    std::vector<uint8_t> payload(127, 0xC3);
+    CellBuilder builder;
+    builder.storeBytes(payload);
+    builder.storeUInt(7, 0x55);
+    auto cell = builder.build();
+
+    CellSlice slice(*cell);
+    slice.skip(1023 - 60);
+    ASSERT_EQUAL(60, slice.remainingBits());
+    uint64_t tail = slice.loadUInt(60);
+    ASSERT_EQUAL(0x55, tail & 0x7F);
+    ASSERT_EQUAL(0, slice.remainingBits());
+}
+
+TEST(SliceRoundTripMixedWidths) {
+    // Поля різної ширини з різними зсувами всередині байта
+    CellBuilder builder;
+    std::vector<std::pair<size_t, uint64_t>> fields;
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    size_t total = 0;
+    for (size_t width = 1; total + width <= Cell::MAX_BITS; width = width % 64 + 1) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        uint64_t value = width == 64 ? seed : seed & ((1ULL << width) - 1);
+        builder.storeUInt(width, value);
+        fields.push_back(std::make_pair(width, value));
+        total += width;
+    }
+    auto cell = builder.build();
+
+    CellSlice slice(*cell);
+    for (const auto& field : fields) {
+        ASSERT_EQUAL(field.second, slice.loadUInt(field.first));
+    }
+    ASSERT_EQUAL(total, cell->getBitSize());
+    ASSERT_EQUAL(0, slice.remainingBits());
+}
+
+namespace {
+    bool bitAt(const uint8_t* data, size_t pos) {
+        return ((data[pos / 8] >> (7 - pos % 8)) & 1) != 0;
+    }
+
+    size_t naiveCommonPrefix(const uint8_t* a, size_t aOffset, const uint8_t* b, size_t bOffset, size_t bitCount) {
+        size_t i = 0;
+        while (i < bitCount && bitAt(a, aOffset + i) == bitAt(b, bOffset + i)) {
+            ++i;
+        }
+        return i;
+    }
+}
+
+TEST(BitStringPrefixKernels) {
+    // Рядки з довгим спільним початком: різниця в одному біті на різних позиціях
+    uint64_t seed = 0x2545F4914F6CDD1DULL;
+    std::vector<uint8_t> a(160);
+    for (uint8_t& byte : a) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        byte = static_cast<uint8_t>(seed >> 56);
+    }
+
+    for (size_t iteration = 0; iteration < 2000; ++iteration) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        size_t aOffset = (seed >> 8) % 64;
+        size_t bOffset = iteration % 2 == 0 ? aOffset : (seed >> 16) % 64;
+        size_t bitCount = (seed >> 24) % 1024;
+        size_t flip = (seed >> 40) % 1100;
+
+        // b - копія відрізка a на іншому зсуві з одним зміненим бітом
+        std::vector<uint8_t> b(160, 0);
+        BitString::copyBits(b.data(), bOffset, a.data(), aOffset, bitCount);
+        if (flip < bitCount) {
+            b[(bOffset + flip) / 8] ^= static_cast<uint8_t>(0x80 >> ((bOffset + flip) % 8));
+        }
+
+        size_t expected = naiveCommonPrefix(a.data(), aOffset, b.data(), bOffset, bitCount);
+        ASSERT_EQUAL(expected, BitString::commonPrefix(a.data(), aOffset, b.data(), bOffset, bitCount));
+        ASSERT_EQUAL(expected == bitCount, BitString::equal(a.data(), aOffset, b.data(), bOffset, bitCount));
+
+        int order = BitString::compare(a.data(), aOffset, bitCount, b.data(), bOffset, bitCount);
+        int expectedOrder = expected == bitCount ? 0 : (bitAt(a.data(), aOffset + expected) ? 1 : -1);
+        ASSERT_EQUAL(expectedOrder, order);
+
+        size_t run = 0;
+        bool first = bitCount > 0 && bitAt(a.data(), aOffset);
+        while (run < bitCount && bitAt(a.data(), aOffset + run) == first) {
+            ++run;
+        }
+        ASSERT_EQUAL(run, BitString::countLeading(a.data(), aOffset, bitCount, first));
+    }
+
+    // Префікс менший за довший рядок; довгі серії однакових бітів
+    std::vector<uint8_t> ones(40, 0xFF);
+    ASSERT_EQUAL(-1, BitString::compare(ones.data(), 0, 100, ones.data(), 3, 101));
+    ASSERT_EQUAL(1, BitString::compare(ones.data(), 0, 101, ones.data(), 3, 100));
+    ASSERT_EQUAL(317, BitString::countLeading(ones.data(), 3, 317, true));
+    ASSERT_EQUAL(0, BitString::countLeading(ones.data(), 3, 317, false));
+}
+
+TEST(SliceBitComparisons) {
+    CellBuilder keyBuilder;
+    keyBuilder.storeUInt(5, 0x3);
+    keyBuilder.storeUInt(64, 0x0123456789ABCDEFULL);
+    keyBuilder.storeUInt(20, 0xFFFFF);
+    auto key = keyBuilder.build();
+
+    CellBuilder otherBuilder;
+    otherBuilder.storeUInt(64, 0x0123456789ABCDEFULL);
+    otherBuilder.storeUInt(12, 0xFFE);
+    auto other = otherBuilder.build();
+
+    CellSlice keySlice(*key);
+    CellSlice otherSlice(*other);
+    ASSERT_EQUAL(3, keySlice.commonPrefix(otherSlice));
+    keySlice.skip(5);
+    ASSERT_EQUAL(75, keySlice.commonPrefix(otherSlice));
+    ASSERT_FALSE(keySlice.startsWith(otherSlice));
+    ASSERT_EQUAL(1, keySlice.compareBits(otherSlice));
+    ASSERT_EQUAL(-1, otherSlice.compareBits(keySlice));
+
+    otherSlice.skip(64);
+    ASSERT_EQUAL(11, otherSlice.countLeading(true));
+    keySlice.skip(64);
+    ASSERT_EQUAL(20, keySlice.countLeading(true));
+    ASSERT_EQUAL(0, keySlice.countLeading(false));
+
+    CellBuilder prefixBuilder;
+    prefixBuilder.storeUInt(16, 0x0123);
+    auto prefixCell = prefixBuilder.build();
+    CellSlice prefix(*prefixCell);
+    CellSlice full(*other);
+    ASSERT_TRUE(full.startsWith(prefix));
+    ASSERT_FALSE(full.bitsEqual(prefix));
+    ASSERT_EQUAL(1, full.compareBits(prefix));
+    ASSERT_TRUE(full.bitsEqual(CellSlice(*other)));
+    ASSERT_EQUAL(0, full.compareBits(CellSlice(*other)));
+    uint8_t bytes[2] = {0x01, 0x23};
+    ASSERT_EQUAL(16, full.commonPrefix(bytes, 0, 16));
+    ASSERT_EQUAL(7, full.commonPrefix(bytes, 0, 7));
+}
+
+TEST(SnakeBytesRoundTrip) {
+    // Межі: порожньо, рівно одна комірка, одна комірка плюс байт, кілька комірок
+    size_t sizes[] = {0, 1, 123, 127, 128, 254, 255, 1000, 5000};
+    for (size_t size : sizes) {
+        std::vector<uint8_t> bytes(size);
+        for (size_t i = 0; i < size; ++i) {
+            bytes[i] = static_cast<uint8_t>(i * 31 + 7);
+        }
+
+        // Заголовок з неповним байтом: дані snake починаються не з межі байта
+        CellBuilder builder;
+        builder.storeUInt(5, 0x11);
+        builder.storeSnakeBytes(bytes);
+        auto cell = builder.build();
+
+        size_t headBytes = size < 127 ? size : 127;
+        ASSERT_EQUAL(5 + headBytes * 8, cell->getBitSize());
+        size_t chain = 0;
+        for (const Cell* next = cell.get(); next->getRefsCount() > 0; next = next->getReference(0).get()) {
+            ++chain;
+        }
+        ASSERT_EQUAL((size - headBytes + 126) / 127, chain);
+
+        CellSlice slice(*cell);
+        ASSERT_EQUAL(0x11, slice.loadUInt(5));
+        ASSERT_EQUAL(size, slice.snakeLength());
+        ASSERT_TRUE(slice.loadSnakeBytes() == bytes);
+        ASSERT_TRUE(slice.empty());
+    }
+}
+
+TEST(SnakeStringAndErrors) {
+    std::string text;
+    for (int i = 0; i < 50; ++i) {
+        text += "Привіт, TON! ";
+    }
+    CellBuilder builder;
+    builder.storeUInt(32, 0);
+    builder.storeSnakeString(text);
+    auto cell = builder.build();
+
+    CellSlice slice(*cell);
+    ASSERT_EQUAL(0, slice.loadUInt(32));
+    ASSERT_TRUE(slice.loadSnakeString() == text);
+
+    // Хвіст має бути першим посиланням: комірка з посиланням приймає лише дані без хвоста
+    CellRef other = CellBuilder().storeUInt(8, 0x77).build();
+    CellBuilder withRef;
+    withRef.storeRef(other);
+    bool threw = false;
+    try {
+        withRef.storeSnakeBytes(std::vector<uint8_t>(200, 0x55));
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    ASSERT_TRUE(threw);
+    withRef.storeSnakeString("short");
+    auto withRefCell = withRef.build();
+    ASSERT_EQUAL(1, withRefCell->getRefsCount());
+    CellSlice withRefSlice(*withRefCell);
+    ASSERT_TRUE(withRefSlice.loadRef() == other);
+    ASSERT_TRUE(withRefSlice.loadSnakeString() == "short");
+
+    // Дані не кратні байту
+    CellBuilder odd;
+    odd.storeUInt(3, 0x5);
+    auto oddCell = odd.build();
+    CellSlice oddSlice(*oddCell);
+    threw = false;
+    try {
+        oddSlice.loadSnakeBytes();
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    ASSERT_TRUE(threw);
+}
+
+int main() {
+    return RUN_ALL_TESTS();
+}
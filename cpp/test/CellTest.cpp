@@ -5,10 +5,28 @@
 
 #include "TestFramework.h"
 #include "../include/Cell.h"
+#include "../include/CellArena.h"
+#include "../include/CellInterner.h"
+#include "../include/CellSlice.h"
+#include "../include/CellGraphStats.h"
 #include <cstring>
+#include <string>
+#include <unordered_map>
+#include <thread>
+#include <vector>
 
 using namespace cton;
 
+static std::string toHex(const Cell::Hash& hash) {
+    static const char* digits = "0123456789abcdef";
+    std::string result;
+    for (uint8_t byte : hash) {
+        result.push_back(digits[byte >> 4]);
+        result.push_back(digits[byte & 0x0F]);
+    }
+    return result;
+}
+
 TEST(CellCreation) {
     Cell cell;
     ASSERT_EQUAL(0, cell.getBitSize());
@@ -34,6 +52,93 @@ TEST(StoreUInt) {
     ASSERT_EQUAL(32, cell->getBitSize());
 }
 
+TEST(StoreUIntBigEndian) {
+    CellBuilder builder;
+    builder.storeUInt(4, 0xF);
+    builder.storeUInt(32, 0x12345678);
+    builder.storeUInt(64, 0x0102030405060708ULL);
+    builder.storeInt(12, -2);
+    
+    auto data = builder.build()->getData();
+    std::vector<uint8_t> expected = {0xF1, 0x23, 0x45, 0x67, 0x80, 0x10, 0x20, 0x30,
+                                     0x40, 0x50, 0x60, 0x70, 0x8F, 0xFE};
+    ASSERT_TRUE(data == expected);
+}
+
+TEST(StoreWideInt) {
+    // Поля ширші за 64 біти доповнюються нулями або розширенням знака
+    CellBuilder unsignedBuilder;
+    unsignedBuilder.storeUInt(72, 0xAB);
+    auto unsignedData = unsignedBuilder.build()->getData();
+    ASSERT_EQUAL(9, unsignedData.size());
+    ASSERT_EQUAL(0x00, unsignedData[0]);
+    ASSERT_EQUAL(0xAB, unsignedData[8]);
+    
+    CellBuilder signedBuilder;
+    signedBuilder.storeInt(257, -1);
+    auto signedCell = signedBuilder.build();
+    ASSERT_EQUAL(257, signedCell->getBitSize());
+    auto signedData = signedCell->getData();
+    ASSERT_EQUAL(0xFF, signedData[0]);
+    ASSERT_EQUAL(0xFF, signedData[31]);
+    ASSERT_EQUAL(0x80, signedData[32]);
+}
+
+TEST(StoreBitsMatchesBitByBit) {
+    std::vector<uint8_t> source(130);
+    for (size_t i = 0; i < source.size(); ++i) {
+        source[i] = static_cast<uint8_t>(i * 37 + 11);
+    }
+    
+    // Усі комбінації зсувів джерела і призначення, довжини понад 32 байти (векторний шлях)
+    for (size_t prefix = 0; prefix < 8; ++prefix) {
+        for (size_t srcOffset = 0; srcOffset < 8; ++srcOffset) {
+            size_t length = Cell::MAX_BITS - prefix - srcOffset;
+            
+            CellBuilder fast;
+            fast.storeUInt(prefix, 0x55);
+            fast.storeBits(source.data(), length, srcOffset);
+            
+            CellBuilder reference;
+            reference.storeUInt(prefix, 0x55);
+            for (size_t i = 0; i < length; ++i) {
+                size_t bit = srcOffset + i;
+                reference.storeUInt(1, (source[bit / 8] >> (7 - bit % 8)) & 1);
+            }
+            
+            ASSERT_TRUE(fast.build()->getData() == reference.build()->getData());
+        }
+    }
+}
+
+TEST(StoreSlice) {
+    CellBuilder childBuilder;
+    childBuilder.storeUInt(8, 0x42);
+    auto child = childBuilder.build();
+    
+    CellBuilder sourceBuilder;
+    sourceBuilder.storeUInt(4, 0x9);
+    sourceBuilder.storeBytes({0xDE, 0xAD, 0xBE, 0xEF});
+    sourceBuilder.storeRef(child);
+    auto source = sourceBuilder.build();
+    
+    CellSlice slice(*source);
+    slice.skip(4);
+    
+    CellBuilder builder;
+    builder.storeUInt(2, 0x3);
+    builder.storeSlice(slice);
+    auto cell = builder.build();
+    
+    ASSERT_EQUAL(34, cell->getBitSize());
+    ASSERT_EQUAL(1, cell->getRefsCount());
+    ASSERT_TRUE(cell->getReference(0).get() == child.get());
+    
+    CellSlice result(*cell);
+    ASSERT_EQUAL(0x3, result.loadUInt(2));
+    ASSERT_EQUAL(0xDEADBEEFULL, result.loadUInt(32));
+}
+
 TEST(StoreInt) {
     CellBuilder builder;
     builder.storeInt(32, -100);
@@ -85,6 +190,671 @@ TEST(OverflowProtection) {
     }
 }
 
+TEST(EmptyCellHash) {
+    Cell cell;
+    ASSERT_EQUAL(std::string("96a296d224f285c67bee93c30f8a309157f0daa35dc5b87e410b78630a09cfc7"), toHex(cell.hash()));
+    ASSERT_EQUAL(0, cell.depth());
+}
+
+TEST(CellHashWithReference) {
+    CellBuilder childBuilder;
+    childBuilder.storeUInt(7, 0x55); // Неповний байт - перевірка completion tag
+    auto child = childBuilder.build();
+    ASSERT_EQUAL(std::string("0f256f7b1b4050029094540c7b94ecf7a50ec0fe281f5c4513c21896b4aab68f"), toHex(child->hash()));
+    
+    CellBuilder parentBuilder;
+    parentBuilder.storeBytes({0xDE, 0xAD, 0xBE, 0xEF});
+    parentBuilder.storeRef(child);
+    auto parent = parentBuilder.build();
+    ASSERT_EQUAL(std::string("9cd52e4a510663759e33ee7741e277968214b98464bc47715f8ce2c2647c8552"), toHex(parent->hash()));
+    ASSERT_EQUAL(1, parent->depth());
+}
+
+TEST(CellHashInvalidatedOnStore) {
+    Cell cell;
+    auto emptyHash = cell.hash();
+    cell.storeUInt(8, 0xFF);
+    ASSERT_TRUE(emptyHash != cell.hash());
+}
+
+TEST(CellStoreAppendsInPlace) {
+    Cell cell;
+    cell.storeUInt(4, 0x9);
+    cell.storeInt(16, -2);
+    cell.storeBytes({0xAB, 0xCD});
+    cell.storeUInt(3, 0x5);
+    
+    CellBuilder builder;
+    builder.storeUInt(4, 0x9);
+    builder.storeInt(16, -2);
+    builder.storeBytes({0xAB, 0xCD});
+    builder.storeUInt(3, 0x5);
+    auto expected = builder.build();
+    
+    ASSERT_EQUAL(39, cell.getBitSize());
+    ASSERT_TRUE(cell.getData() == expected->getData());
+    ASSERT_TRUE(cell.hash() == expected->hash());
+    
+    try {
+        cell.storeUInt(Cell::MAX_BITS, 0);
+        ASSERT_TRUE(false);
+    } catch (const std::overflow_error&) {
+        ASSERT_EQUAL(39, cell.getBitSize());
+    }
+}
+
+TEST(CellStructuralEquality) {
+    CellBuilder builder1;
+    builder1.storeUInt(16, 0xABCD);
+    auto cell1 = builder1.build();
+    
+    CellBuilder builder2;
+    builder2.storeUInt(16, 0xABCD);
+    auto cell2 = builder2.build();
+    
+    CellBuilder builder3;
+    builder3.storeUInt(16, 0xABCE);
+    auto cell3 = builder3.build();
+    
+    ASSERT_TRUE(*cell1 == *cell2);
+    ASSERT_TRUE(*cell1 != *cell3);
+    
+    std::unordered_map<CellRef, int, CellHash, CellEqual> counts;
+    counts[cell1]++;
+    counts[cell2]++;
+    counts[cell3]++;
+    ASSERT_EQUAL(2, counts.size());
+    ASSERT_EQUAL(2, counts[cell1]);
+}
+
+TEST(InlineStorageLayout) {
+    ASSERT_EQUAL(64, alignof(Cell));
+    ASSERT_TRUE(sizeof(Cell) <= 256);
+    
+    CellBuilder builder;
+    builder.storeUInt(4, 0xA);
+    builder.storeBytes({0xBC, 0xDE});
+    auto cell = builder.build();
+    ASSERT_EQUAL(20, cell->getBitSize());
+    
+    // Несумісний з байтами запис: 0xA, 0xBC, 0xDE -> 0xAB 0xCD 0xE0
+    const uint8_t* raw = cell->getRawData();
+    ASSERT_EQUAL(0xAB, raw[0]);
+    ASSERT_EQUAL(0xCD, raw[1]);
+    ASSERT_EQUAL(0xE0, raw[2]);
+    ASSERT_EQUAL(0, raw[3]);
+    ASSERT_EQUAL(3, cell->getData().size());
+}
+
+TEST(GetReferenceByIndex) {
+    CellBuilder childBuilder;
+    childBuilder.storeUInt(8, 0x42);
+    auto child = childBuilder.build();
+    
+    CellBuilder builder;
+    builder.storeRef(child);
+    auto cell = builder.build();
+    ASSERT_TRUE(cell->getReference(0) == child);
+    
+    try {
+        cell->getReference(1);
+        ASSERT_TRUE(false);
+    } catch (const std::out_of_range&) {
+        ASSERT_TRUE(true);
+    }
+}
+
+TEST(ArenaBuild) {
+    CellArena arena(1024);
+    
+    CellBuilder childBuilder;
+    childBuilder.storeUInt(8, 0xAB);
+    auto child = childBuilder.build(arena);
+    
+    CellBuilder parentBuilder;
+    parentBuilder.storeBytes({0x01, 0x02});
+    parentBuilder.storeRef(child);
+    auto parent = parentBuilder.build(arena);
+    
+    ASSERT_EQUAL(16, parent->getBitSize());
+    ASSERT_EQUAL(1, parent->getRefsCount());
+    ASSERT_EQUAL(0xAB, child->getData()[0]);
+    ASSERT_TRUE(arena.getAllocatedBytes() > 0);
+    
+    // Комірка з арени структурно дорівнює такій самій комірці з купи
+    CellBuilder heapBuilder;
+    heapBuilder.storeUInt(8, 0xAB);
+    ASSERT_TRUE(*heapBuilder.build() == *child);
+}
+
+TEST(ArenaManyCells) {
+    CellArena arena(4096);
+    std::vector<CellRef> cells;
+    for (int i = 0; i < 1000; ++i) {
+        CellBuilder builder;
+        builder.storeUInt(8, static_cast<uint64_t>(i & 0xFF));
+        cells.push_back(builder.build(arena));
+    }
+    ASSERT_TRUE(arena.getChunkCount() > 1);
+    ASSERT_TRUE(arena.getReservedBytes() >= arena.getAllocatedBytes());
+    ASSERT_EQUAL(static_cast<uint8_t>(999 & 0xFF), cells.back()->getData()[0]);
+    ASSERT_EQUAL(1000, arena.getLiveCellCount());
+    
+    // Арена рахує кожну знищену комірку, зокрема дочірні в ланцюжку
+    CellRef parent = CellBuilder().storeRef(cells[0]).build(arena);
+    cells.clear();
+    ASSERT_EQUAL(2, arena.getLiveCellCount());
+    parent.reset();
+    ASSERT_EQUAL(0, arena.getLiveCellCount());
+}
+
+TEST(InternerReturnsCanonicalCell) {
+    CellInterner interner;
+    
+    CellBuilder firstChild;
+    firstChild.storeUInt(8, 0x42);
+    CellBuilder secondChild;
+    secondChild.storeUInt(8, 0x42);
+    auto a = firstChild.build(interner);
+    auto b = secondChild.build(interner);
+    ASSERT_TRUE(a.get() == b.get());
+    
+    // Батьківські комірки з однаковим вмістом теж збігаються за вказівником
+    CellBuilder firstParent;
+    firstParent.storeBytes({0x01});
+    firstParent.storeRef(a);
+    CellBuilder secondParent;
+    secondParent.storeBytes({0x01});
+    secondParent.storeRef(b);
+    ASSERT_TRUE(firstParent.build(interner).get() == secondParent.build(interner).get());
+    ASSERT_EQUAL(2, interner.size());
+    
+    // Наявна комірка замінюється канонічною
+    CellBuilder heapBuilder;
+    heapBuilder.storeUInt(8, 0x42);
+    ASSERT_TRUE(interner.intern(heapBuilder.build()).get() == a.get());
+}
+
+TEST(InternerConcurrent) {
+    CellInterner interner(8);
+    const int threadCount = 4;
+    const int cellCount = 500;
+    std::vector<std::vector<CellRef>> results(threadCount);
+    
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&interner, &results, t]() {
+            for (int i = 0; i < cellCount; ++i) {
+                CellBuilder builder;
+                builder.storeUInt(16, static_cast<uint64_t>(i));
+                results[t].push_back(builder.build(interner));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    ASSERT_EQUAL(static_cast<size_t>(cellCount), interner.size());
+    for (int t = 1; t < threadCount; ++t) {
+        for (int i = 0; i < cellCount; ++i) {
+            ASSERT_TRUE(results[t][i].get() == results[0][i].get());
+        }
+    }
+}
+
+TEST(InternerPurgeUnused) {
+    CellInterner interner;
+    {
+        CellBuilder childBuilder;
+        childBuilder.storeUInt(4, 0x3);
+        auto child = childBuilder.build(interner);
+        CellBuilder parentBuilder;
+        parentBuilder.storeRef(child);
+        parentBuilder.build(interner);
+    }
+    CellBuilder keptBuilder;
+    keptBuilder.storeUInt(4, 0x5);
+    auto kept = keptBuilder.build(interner);
+    
+    ASSERT_EQUAL(3, interner.size());
+    ASSERT_EQUAL(2, interner.purgeUnused());
+    ASSERT_EQUAL(1, interner.size());
+}
+
+TEST(CellRefCounting) {
+    auto cell = Cell::create();
+    ASSERT_EQUAL(1, cell.useCount());
+    {
+        CellRef copy = cell;
+        ASSERT_EQUAL(2, cell.useCount());
+        ASSERT_TRUE(copy == cell);
+    }
+    ASSERT_EQUAL(1, cell.useCount());
+    
+    // Посилання з батьківської комірки теж враховується
+    CellRef parent;
+    {
+        CellBuilder builder;
+        builder.storeRef(cell);
+        parent = builder.build();
+    }
+    ASSERT_EQUAL(2, cell.useCount());
+    parent.reset();
+    ASSERT_EQUAL(1, cell.useCount());
+    
+    // detach/adopt передають володіння без зміни лічильника
+    Cell* raw = cell.detach();
+    ASSERT_TRUE(cell == nullptr);
+    CellRef adopted = CellRef::adopt(raw);
+    ASSERT_EQUAL(1, adopted.useCount());
+}
+
+TEST(ArenaNonAtomicRefCount) {
+    CellArena arena(4096, RefCountMode::NonAtomic);
+    ASSERT_TRUE(arena.getRefCountMode() == RefCountMode::NonAtomic);
+    
+    CellRef chain;
+    for (int i = 0; i < 100; ++i) {
+        CellBuilder builder;
+        builder.storeUInt(8, static_cast<uint64_t>(i));
+        if (chain) {
+            builder.storeRef(chain);
+        }
+        chain = builder.build(arena);
+    }
+    ASSERT_EQUAL(1, chain.useCount());
+    ASSERT_EQUAL(99, chain->depth());
+    
+    CellRef child = chain->getReference(0);
+    ASSERT_EQUAL(2, child.useCount());
+    chain.reset();
+    ASSERT_EQUAL(1, child.useCount());
+}
+
+TEST(PrunedBranchKeepsLowerHash) {
+    CellBuilder leafBuilder;
+    leafBuilder.storeUInt(32, 0xDEADBEEF);
+    auto leaf = leafBuilder.build();
+    
+    CellBuilder subtreeBuilder;
+    subtreeBuilder.storeUInt(7, 0x55);
+    subtreeBuilder.storeRef(leaf);
+    auto subtree = subtreeBuilder.build();
+    
+    CellBuilder otherBuilder;
+    otherBuilder.storeBytes({0x01, 0x02});
+    auto other = otherBuilder.build();
+    
+    CellBuilder rootBuilder;
+    rootBuilder.storeUInt(16, 0xCAFE);
+    rootBuilder.storeRef(subtree);
+    rootBuilder.storeRef(other);
+    auto root = rootBuilder.build();
+    
+    auto pruned = Cell::createPrunedBranch(*subtree, 1);
+    ASSERT_TRUE(pruned->getType() == CellType::PrunedBranch);
+    ASSERT_EQUAL(1, pruned->getLevelMask());
+    ASSERT_EQUAL(16 + 256 + 16, pruned->getBitSize());
+    ASSERT_TRUE(pruned->hash(0) == subtree->hash());
+    ASSERT_EQUAL(subtree->depth(), pruned->depth(0));
+    ASSERT_EQUAL(0, pruned->depth());
+    
+    // Корінь з обрізаною гілкою має той самий хеш нульового рівня, що й повне дерево
+    CellBuilder prunedRootBuilder;
+    prunedRootBuilder.storeUInt(16, 0xCAFE);
+    prunedRootBuilder.storeRef(pruned);
+    prunedRootBuilder.storeRef(other);
+    auto prunedRoot = prunedRootBuilder.build();
+    ASSERT_EQUAL(1, prunedRoot->getLevel());
+    ASSERT_TRUE(prunedRoot->hash(0) == root->hash());
+    ASSERT_EQUAL(root->depth(), prunedRoot->depth(0));
+    ASSERT_FALSE(prunedRoot->hash() == root->hash());
+    ASSERT_TRUE(prunedRoot->hash(Cell::MAX_LEVEL) == prunedRoot->hash());
+    
+    // Доказ Меркла знімає один рівень
+    auto proof = Cell::createMerkleProof(prunedRoot);
+    ASSERT_TRUE(proof->getType() == CellType::MerkleProof);
+    ASSERT_EQUAL(0, proof->getLevel());
+    ASSERT_EQUAL(0, root->getLevel());
+    
+    auto update = Cell::createMerkleUpdate(prunedRoot, root);
+    ASSERT_TRUE(update->getType() == CellType::MerkleUpdate);
+    ASSERT_EQUAL(0, update->getLevelMask());
+    
+    Cell copy(*prunedRoot);
+    ASSERT_TRUE(copy.hash(0) == root->hash());
+    ASSERT_EQUAL(1, copy.getLevelMask());
+}
+
+TEST(PrunedBranchOfPrunedTree) {
+    CellBuilder leafBuilder;
+    leafBuilder.storeUInt(8, 0x11);
+    auto leaf = leafBuilder.build();
+    
+    CellBuilder parentBuilder;
+    parentBuilder.storeRef(Cell::createPrunedBranch(*leaf, 1));
+    auto parent = parentBuilder.build();
+    
+    // Гілка другого рівня зберігає хеші обох значущих рівнів
+    auto pruned = Cell::createPrunedBranch(*parent, 2);
+    ASSERT_EQUAL(3, pruned->getLevelMask());
+    ASSERT_TRUE(pruned->hash(0) == parent->hash(0));
+    ASSERT_TRUE(pruned->hash(1) == parent->hash(1));
+    ASSERT_EQUAL(parent->depth(1), pruned->depth(1));
+    
+    try {
+        Cell::createPrunedBranch(*parent, 1);
+        ASSERT_TRUE(false);
+    } catch (const std::invalid_argument&) {
+        ASSERT_TRUE(true);
+    }
+}
+
+TEST(MalformedSpecialCells) {
+    CellBuilder leafBuilder;
+    leafBuilder.storeUInt(8, 0x42);
+    auto leaf = leafBuilder.build();
+    
+    // Невідомий тип
+    try {
+        CellBuilder builder;
+        builder.setSpecial().storeUInt(8, 0x07);
+        builder.build();
+        ASSERT_TRUE(false);
+    } catch (const std::invalid_argument&) {
+        ASSERT_TRUE(true);
+    }
+    
+    // Обрізана гілка з неправильним розміром
+    try {
+        CellBuilder builder;
+        builder.setSpecial().storeUInt(8, 1).storeUInt(8, 1).storeUInt(32, 0);
+        builder.build();
+        ASSERT_TRUE(false);
+    } catch (const std::invalid_argument&) {
+        ASSERT_TRUE(true);
+    }
+    
+    // Доказ Меркла з хешем, що не збігається з дочірньою коміркою
+    try {
+        CellBuilder builder;
+        builder.setSpecial().storeUInt(8, 3);
+        builder.storeBytes(std::vector<uint8_t>(32, 0xAB));
+        builder.storeUInt(16, 0);
+        builder.storeRef(leaf);
+        builder.build();
+        ASSERT_TRUE(false);
+    } catch (const std::invalid_argument&) {
+        ASSERT_TRUE(true);
+    }
+    
+    // Бібліотечна комірка з посиланням
+    try {
+        CellBuilder builder;
+        builder.setSpecial().storeUInt(8, 2);
+        builder.storeBytes(std::vector<uint8_t>(32, 0));
+        builder.storeRef(leaf);
+        builder.build();
+        ASSERT_TRUE(false);
+    } catch (const std::invalid_argument&) {
+        ASSERT_TRUE(true);
+    }
+    
+    auto library = Cell::createLibrary(leaf->hash());
+    ASSERT_TRUE(library->getType() == CellType::Library);
+    ASSERT_EQUAL(0, library->getLevelMask());
+}
+
+namespace {
+    // Дерево з різними листами і спільними піддеревами на кожному рівні
+    CellRef buildWideTree(unsigned depth, uint64_t& counter, std::vector<CellRef>& shared) {
+        CellBuilder builder;
+        builder.storeUInt(32, counter++);
+        if (depth > 0) {
+            builder.storeRef(buildWideTree(depth - 1, counter, shared));
+            builder.storeRef(buildWideTree(depth - 1, counter, shared));
+            if (shared.size() > depth) {
+                builder.storeRef(shared[depth]);
+            }
+        }
+        CellRef cell = builder.build();
+        if (shared.size() <= depth) {
+            shared.push_back(cell);
+        }
+        return cell;
+    }
+}
+
+TEST(ParallelHashTreeMatchesSequential) {
+    uint64_t counter = 0;
+    std::vector<CellRef> sequentialShared;
+    CellRef sequential = buildWideTree(14, counter, sequentialShared);
+    counter = 0;
+    std::vector<CellRef> parallelShared;
+    CellRef parallel = buildWideTree(14, counter, parallelShared);
+    
+    Cell::Hash expected = sequential->hash();
+    Cell::hashTree(parallel, 4);
+    ASSERT_TRUE(parallel->hash() == expected);
+    ASSERT_EQUAL(sequential->depth(), parallel->depth());
+    for (size_t i = 0; i < parallelShared.size(); ++i) {
+        ASSERT_TRUE(parallelShared[i]->hash() == sequentialShared[i]->hash());
+    }
+    
+    // Повторний виклик і частково хешоване дерево
+    Cell::hashTree(parallel, 4);
+    CellBuilder top;
+    top.storeUInt(8, 1);
+    top.storeRef(parallel);
+    CellRef partial = top.build();
+    Cell::hashTree(partial, 0);
+    ASSERT_TRUE(partial->getReference(0)->hash() == expected);
+}
+
+TEST(LazyHashDeepChain) {
+    // Ланцюжок, на якому рекурсивне хешування переповнило б стек
+    const uint64_t length = 60000;
+    CellRef chain;
+    CellRef twin;
+    for (uint64_t i = 0; i < length; ++i) {
+        CellBuilder first;
+        first.storeUInt(32, i);
+        CellBuilder second;
+        second.storeUInt(32, i);
+        if (chain) {
+            first.storeRef(chain);
+            second.storeRef(twin);
+        }
+        chain = first.build();
+        twin = second.build();
+    }
+    ASSERT_EQUAL(0, chain->getLevelMask());
+    ASSERT_EQUAL(length - 1, chain->depth());
+    Cell::hashTree(twin, 4);
+    ASSERT_TRUE(chain->hash() == twin->hash());
+}
+
+TEST(DepthOverflowThrows) {
+    // Глибина 99999 не вміщується в 16 бітів представлення: помилка замість неправильного хешу
+    CellRef chain;
+    CellRef twin;
+    for (uint64_t i = 0; i < 100000; ++i) {
+        CellBuilder first;
+        first.storeUInt(32, i);
+        CellBuilder second;
+        second.storeUInt(32, i);
+        if (chain) {
+            first.storeRef(chain);
+            second.storeRef(twin);
+        }
+        chain = first.build();
+        twin = second.build();
+    }
+    bool threw = false;
+    try {
+        chain->hash();
+    } catch (const std::overflow_error&) {
+        threw = true;
+    }
+    ASSERT_TRUE(threw);
+    threw = false;
+    try {
+        chain->depth();
+    } catch (const std::overflow_error&) {
+        threw = true;
+    }
+    ASSERT_TRUE(threw);
+    threw = false;
+    try {
+        Cell::hashTree(twin, 4);
+    } catch (const std::overflow_error&) {
+        threw = true;
+    }
+    ASSERT_TRUE(threw);
+}
+
+TEST(ParallelHashTreeNarrowLayers) {
+    // Кожен шар ланцюжка вужчий за одну порцію: зайві потоки не запускаються
+    CellRef sequential;
+    CellRef parallel;
+    for (uint64_t i = 0; i < 6000; ++i) {
+        CellBuilder first;
+        first.storeUInt(32, i);
+        CellBuilder second;
+        second.storeUInt(32, i);
+        if (sequential) {
+            first.storeRef(sequential);
+            second.storeRef(parallel);
+        }
+        sequential = first.build();
+        parallel = second.build();
+    }
+    Cell::hashTree(sequential, 1);
+    Cell::hashTree(parallel, 64);
+    ASSERT_TRUE(parallel->hash() == sequential->hash());
+    ASSERT_EQUAL(5999, parallel->depth());
+}
+
+TEST(CellGraphStatsCountsSharedCells) {
+    CellRef leaf = CellBuilder().storeUInt(12, 1).build();
+    CellRef middle = CellBuilder().storeUInt(20, 2).storeRef(leaf).storeRef(leaf).build();
+    CellRef root = CellBuilder().storeUInt(1, 1).storeRef(middle).storeRef(middle).storeRef(leaf).build();
+    
+    CellGraphStats stats = CellGraphStats::compute(root);
+    ASSERT_EQUAL(3, stats.cellCount);
+    // Як дерево: корінь, 2 x (middle + 2 листи), лист
+    ASSERT_EQUAL(8, stats.treeCellCount);
+    ASSERT_EQUAL(33, stats.totalBits);
+    ASSERT_EQUAL(5, stats.totalRefs);
+    ASSERT_EQUAL(0, stats.specialCells);
+    ASSERT_EQUAL(2, stats.maxDepth);
+    ASSERT_EQUAL(2 + 3 + 1, stats.payloadBytes);
+    ASSERT_EQUAL(3 * sizeof(Cell), stats.totalBytes());
+    ASSERT_TRUE(stats.sharedRatio() > 0.62 && stats.sharedRatio() < 0.63);
+    
+    // Обрізана гілка тримає хеші рівнів окремо
+    CellRef pruned = Cell::createPrunedBranch(*middle);
+    pruned->hash();
+    CellGraphStats prunedStats = CellGraphStats::compute(pruned);
+    ASSERT_EQUAL(1, prunedStats.specialCells);
+    ASSERT_TRUE(prunedStats.totalBytes() > sizeof(Cell));
+    
+    ASSERT_EQUAL(0, CellGraphStats::compute(CellRef()).cellCount);
+}
+
+TEST(CellGraphStatsDeepChain) {
+    // Глибина понад 65535 не обрізається до 16 бітів
+    const uint32_t length = 70000;
+    CellRef chain = CellBuilder().storeUInt(32, 0).build();
+    for (uint32_t i = 1; i < length; ++i) {
+        chain = CellBuilder().storeUInt(32, i).storeRef(chain).build();
+    }
+    CellGraphStats stats = CellGraphStats::compute(chain);
+    ASSERT_EQUAL(length, stats.cellCount);
+    ASSERT_EQUAL(length - 1, stats.maxDepth);
+    // Межа глибини зупиняє обхід раніше, ніж хешування дійде до переповнення
+    ASSERT_TRUE(computeStorageStats(chain, StorageLimits(~0ULL, ~0ULL, 1024)).limitExceeded);
+}
+
+TEST(StorageStatsAndLimits) {
+    CellRef leaf = CellBuilder().storeUInt(12, 1).build();
+    CellRef middle = CellBuilder().storeUInt(20, 2).storeRef(leaf).storeRef(leaf).build();
+    CellRef root = CellBuilder().storeUInt(1, 1).storeRef(middle).storeRef(middle).storeRef(leaf).build();
+    
+    StorageStats stats = computeStorageStats(root);
+    ASSERT_FALSE(stats.limitExceeded);
+    ASSERT_EQUAL(3, stats.cells);
+    ASSERT_EQUAL(33, stats.bits);
+    ASSERT_EQUAL(2, stats.maxDepth);
+    
+    ASSERT_FALSE(computeStorageStats(root, StorageLimits(3, 33, 2)).limitExceeded);
+    ASSERT_TRUE(computeStorageStats(root, StorageLimits(2, 33, 2)).limitExceeded);
+    ASSERT_TRUE(computeStorageStats(root, StorageLimits(3, 32, 2)).limitExceeded);
+    ASSERT_TRUE(computeStorageStats(root, StorageLimits(3, 33, 1)).limitExceeded);
+    
+    // Спільна комірка спершу знаходиться неглибоко, але є і довший шлях до неї
+    CellRef chain = leaf;
+    for (int i = 0; i < 5; ++i) {
+        chain = CellBuilder().storeUInt(8, i).storeRef(chain).build();
+    }
+    CellRef sharedDeep = CellBuilder().storeRef(chain).build();
+    CellRef dag = CellBuilder().storeRef(sharedDeep).storeRef(CellBuilder().storeRef(sharedDeep).build()).build();
+    ASSERT_EQUAL(dag->depth(), computeStorageStats(dag).maxDepth);
+    ASSERT_TRUE(computeStorageStats(dag, StorageLimits(100, 1000, dag->depth() - 1)).limitExceeded);
+    ASSERT_FALSE(computeStorageStats(dag, StorageLimits(100, 1000, dag->depth())).limitExceeded);
+    
+    // Спершу глибший шлях: повторний вхід з меншої глибини не рахує комірки вдруге
+    CellRef reversed = CellBuilder().storeRef(CellBuilder().storeRef(sharedDeep).build()).storeRef(sharedDeep).build();
+    StorageStats reversedStats = computeStorageStats(reversed);
+    ASSERT_EQUAL(CellGraphStats::compute(reversed).cellCount, reversedStats.cells);
+    ASSERT_EQUAL(reversed->depth(), reversedStats.maxDepth);
+    
+    // Однакові комірки з різних об'єктів рахуються один раз, як у BOC
+    CellRef copyA = CellBuilder().storeUInt(16, 0xBEEF).storeRef(leaf).build();
+    CellRef copyB = CellBuilder().storeUInt(16, 0xBEEF).storeRef(CellBuilder().storeUInt(12, 1).build()).build();
+    CellRef duplicates = CellBuilder().storeRef(copyA).storeRef(copyB).build();
+    StorageStats duplicateStats = computeStorageStats(duplicates);
+    ASSERT_EQUAL(3, duplicateStats.cells);
+    ASSERT_EQUAL(28, duplicateStats.bits);
+    ASSERT_FALSE(computeStorageStats(duplicates, StorageLimits(3, 28, 2)).limitExceeded);
+    
+    // Ранній вихід: на великому дереві обхід зупиняється на межі
+    CellRef wide = CellBuilder().build();
+    for (int i = 0; i < 2000; ++i) {
+        wide = CellBuilder().storeUInt(32, i).storeRef(wide).storeRef(CellBuilder().storeUInt(16, i).build()).build();
+    }
+    StorageStats limited = computeStorageStats(wide, StorageLimits(100, ~0ULL, ~0u));
+    ASSERT_TRUE(limited.limitExceeded);
+    ASSERT_EQUAL(101, limited.cells);
+    
+    ASSERT_EQUAL(0, computeStorageStats(CellRef()).cells);
+}
+
+TEST(LiveCellCounters) {
+    size_t cellsBefore = Cell::liveCount();
+    size_t bytesBefore = Cell::liveBytes();
+    {
+        std::vector<CellRef> cells;
+        for (uint64_t i = 0; i < 100; ++i) {
+            cells.push_back(CellBuilder().storeUInt(64, i).build());
+        }
+        ASSERT_EQUAL(cellsBefore + 100, Cell::liveCount());
+        ASSERT_EQUAL(bytesBefore + 100 * sizeof(Cell), Cell::liveBytes());
+        
+        CellRef pruned = Cell::createPrunedBranch(*cells[0]);
+        pruned->hash();
+        ASSERT_EQUAL(cellsBefore + 101, Cell::liveCount());
+        ASSERT_EQUAL(bytesBefore + pruned->memoryFootprint() + 100 * sizeof(Cell), Cell::liveBytes());
+        
+        CellArena arena;
+        CellRef arenaCell = CellBuilder().storeUInt(8, 1).build(arena);
+        ASSERT_EQUAL(cellsBefore + 102, Cell::liveCount());
+    }
+    ASSERT_EQUAL(cellsBefore, Cell::liveCount());
+    ASSERT_EQUAL(bytesBefore, Cell::liveBytes());
+}
+
 int main() {
     return RUN_ALL_TESTS();
 }
\ No newline at end of file
@@ -0,0 +1,175 @@
+// CellTraversalTest.cpp - тести для CellTraversal класу
+// Author: Андрій Будильников (Sparky)
+// Unit tests for CellTraversal class
+// Модульные тесты для класса CellTraversal
+
+#include "TestFramework.h"
+#include "../include/CellTraversal.h"
+#include "../include/Boc.h"
+#include <vector>
+#include <set>
+#include <algorithm>
+
+using namespace cton;
+
+namespace {
+    CellRef makeCell(uint64_t value, const std::vector<CellRef>& refs) {
+        CellBuilder builder;
+        builder.storeUInt(16, value);
+        for (const CellRef& ref : refs) {
+            builder.storeRef(ref);
+        }
+        return builder.build();
+    }
+
+    void recursiveWalk(const Cell* cell, bool preOrder, std::set<const Cell*>& visited,
+                       std::vector<const Cell*>& out) {
+        if (!visited.insert(cell).second) {
+            return;
+        }
+        if (preOrder) {
+            out.push_back(cell);
+        }
+        for (size_t i = 0; i < cell->getRefsCount(); ++i) {
+            recursiveWalk(cell->getReference(i).get(), preOrder, visited, out);
+        }
+        if (!preOrder) {
+            out.push_back(cell);
+        }
+    }
+
+    /**
+     * @brief DAG зі спільними комірками: shared входить у дві гілки
+     */
+    CellRef makeDag(CellRef& shared) {
+        CellRef leafA = makeCell(1, {});
+        CellRef leafB = makeCell(2, {});
+        shared = makeCell(3, {leafA, leafB});
+        CellRef left = makeCell(4, {shared, leafA});
+        CellRef right = makeCell(5, {makeCell(6, {}), shared});
+        return makeCell(7, {left, right, leafB});
+    }
+}
+
+TEST(TraversalMatchesRecursiveOrder) {
+    CellRef shared;
+    CellRef root = makeDag(shared);
+
+    for (int preOrder = 0; preOrder < 2; ++preOrder) {
+        std::set<const Cell*> visited;
+        std::vector<const Cell*> expected;
+        recursiveWalk(root.get(), preOrder != 0, visited, expected);
+
+        TraversalOrder order = preOrder ? TraversalOrder::PreOrder : TraversalOrder::PostOrder;
+        std::vector<const Cell*> actual = CellTraversal::collect(root.get(), order);
+        ASSERT_EQUAL(7, actual.size());
+        ASSERT_TRUE(actual == expected);
+    }
+}
+
+TEST(TraversalNonUniqueAndDepth) {
+    CellRef shared;
+    CellRef root = makeDag(shared);
+
+    // Без unique спільні піддерева обходяться при кожній появі
+    size_t count = 0;
+    size_t sharedDepthSum = 0;
+    for (CellTraversal it(root.get(), TraversalOrder::PreOrder, false); it.valid(); it.next()) {
+        ++count;
+        if (it.cell() == shared.get()) {
+            sharedDepthSum += it.depth();
+        }
+    }
+    ASSERT_EQUAL(12, count);
+    ASSERT_EQUAL(4, sharedDepthSum);
+
+    // Обмеження глибини: лише корінь і його дочірні
+    CellTraversal limited(root.get(), TraversalOrder::PostOrder, true, 1);
+    size_t limitedCount = 0;
+    for (; limited.valid(); limited.next()) {
+        ASSERT_TRUE(limited.depth() <= 1);
+        ++limitedCount;
+    }
+    ASSERT_EQUAL(4, limitedCount);
+    ASSERT_TRUE(limited.depthLimitReached());
+
+    // skipChildren у PreOrder відсікає піддерево
+    std::vector<const Cell*> visited;
+    for (CellTraversal it(root.get(), TraversalOrder::PreOrder); it.valid(); it.next()) {
+        visited.push_back(it.cell());
+        if (it.cell() == root->getReference(0).get()) {
+            it.skipChildren();
+        }
+    }
+    ASSERT_EQUAL(7, visited.size());
+}
+
+TEST(TraversalDepthLimitReentersShallower) {
+    // shared спершу досягається на межі глибини (через middle), потім - з кореня
+    CellRef leaf = makeCell(1, {});
+    CellRef shared = makeCell(2, {leaf});
+    CellRef middle = makeCell(3, {shared});
+    CellRef root = makeCell(4, {middle, shared});
+
+    CellTraversal limited(root.get(), TraversalOrder::PostOrder, true, 2);
+    std::vector<const Cell*> visited;
+    for (; limited.valid(); limited.next()) {
+        visited.push_back(limited.cell());
+    }
+    ASSERT_TRUE(limited.depthLimitReached());
+    ASSERT_EQUAL(4, limited.visitedCount());
+    ASSERT_TRUE(std::find(visited.begin(), visited.end(), leaf.get()) != visited.end());
+    ASSERT_EQUAL(2, std::count(visited.begin(), visited.end(), shared.get()));
+    ASSERT_EQUAL(5, visited.size());
+
+    // Глибшого входу після меншої глибини не буде
+    CellRef reversed = makeCell(5, {shared, middle});
+    ASSERT_EQUAL(4, CellTraversal::collect(reversed.get()).size());
+    size_t count = 0;
+    for (CellTraversal it(reversed.get(), TraversalOrder::PreOrder, true, 2); it.valid(); it.next()) {
+        ++count;
+    }
+    ASSERT_EQUAL(4, count);
+}
+
+TEST(TraversalDeepChain) {
+    // Ланцюжок, який рекурсивний обхід не пройшов би на стеку за замовчуванням
+    const size_t length = 60000;
+    CellRef chain;
+    for (size_t i = 0; i < length; ++i) {
+        chain = chain ? makeCell(i, {chain}) : makeCell(i, {});
+    }
+
+    CellTraversal traversal(chain.get());
+    ASSERT_EQUAL(length - 1, traversal.depth());
+    size_t count = 0;
+    for (; traversal.valid(); traversal.next()) {
+        ++count;
+    }
+    ASSERT_EQUAL(length, count);
+    ASSERT_EQUAL(length, traversal.visitedCount());
+
+    auto serialized = Boc(chain).serialize();
+    ASSERT_TRUE(Boc::deserialize(serialized).getRoot()->hash() == chain->hash());
+}
+
+TEST(CellVisitedSetGrows) {
+    std::vector<CellRef> cells;
+    CellVisitedSet set;
+    for (uint64_t i = 0; i < 5000; ++i) {
+        cells.push_back(makeCell(i, {}));
+        ASSERT_TRUE(set.insert(cells.back().get()));
+    }
+    ASSERT_EQUAL(5000, set.size());
+    for (const CellRef& cell : cells) {
+        ASSERT_TRUE(set.contains(cell.get()));
+        ASSERT_FALSE(set.insert(cell.get()));
+    }
+    set.clear();
+    ASSERT_EQUAL(0, set.size());
+    ASSERT_FALSE(set.contains(cells.front().get()));
+}
+
+int main() {
+    return RUN_ALL_TESTS();
+}
@@ -5,7 +5,9 @@
 
 #include "TestFramework.h"
 #include "../include/Crypto.h"
+#include "../include/Sha256.h"
 #include <cstring>
+#include <string>
 
 // Include OpenSSL headers to check if they're available
 #ifdef OPENSSL_AVAILABLE
@@ -15,6 +17,18 @@
 
 using namespace cton;
 
+namespace {
+    std::string toHex(const std::vector<uint8_t>& bytes) {
+        static const char* digits = "0123456789abcdef";
+        std::string result;
+        for (uint8_t byte : bytes) {
+            result.push_back(digits[byte >> 4]);
+            result.push_back(digits[byte & 0x0F]);
+        }
+        return result;
+    }
+}
+
 TEST(PrivateKeyCreation) {
     PrivateKey key;
     auto data = key.getData();
@@ -183,6 +197,62 @@ TEST(CryptoKeyPairConsistency) {
     ASSERT_FALSE(isInvalid);
 }
 
+TEST(Sha256KnownVectors) {
+    std::vector<uint8_t> abc = {'a', 'b', 'c'};
+    ASSERT_EQUAL(std::string("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"), toHex(Sha256::hash(abc)));
+    
+    // Потокове оновлення частинами різного розміру
+    std::vector<uint8_t> longData(1000, 'a');
+    Sha256 sha;
+    sha.update(longData.data(), 1);
+    sha.update(longData.data() + 1, 63);
+    sha.update(longData.data() + 64, 936);
+    std::vector<uint8_t> digest(Sha256::DIGEST_SIZE);
+    sha.finalize(digest.data());
+    ASSERT_EQUAL(std::string("41edece42d63e8d9bf515a9ba6932e1c20cbc9f5a5d134645adb5db1b9737ea3"), toHex(digest));
+}
+
+TEST(Sha256BatchMatchesSingle) {
+    // Повідомлення від 0 до 300 байтів: різна кількість блоків у групах ядра,
+    // і їх більше, ніж вміщує одне вікно сортування
+    std::vector<std::vector<uint8_t>> messages;
+    for (size_t size = 0; size <= 300; size += 3) {
+        std::vector<uint8_t> message(size);
+        for (size_t i = 0; i < size; ++i) {
+            message[i] = static_cast<uint8_t>(i * 31 + size);
+        }
+        messages.push_back(message);
+    }
+    
+    std::vector<const uint8_t*> pointers;
+    std::vector<size_t> sizes;
+    std::vector<std::vector<uint8_t>> digests(messages.size(), std::vector<uint8_t>(Sha256::DIGEST_SIZE));
+    std::vector<uint8_t*> outputs;
+    for (size_t i = 0; i < messages.size(); ++i) {
+        pointers.push_back(messages[i].data());
+        sizes.push_back(messages[i].size());
+        outputs.push_back(digests[i].data());
+    }
+    Sha256::hashBatch(pointers.data(), sizes.data(), outputs.data(), messages.size());
+    
+    for (size_t i = 0; i < messages.size(); ++i) {
+        ASSERT_TRUE(digests[i] == Sha256::hash(messages[i]));
+    }
+    ASSERT_TRUE(Sha256::batchLanes() == 1 || Sha256::batchLanes() == 4 || Sha256::batchLanes() == 8);
+}
+
+TEST(Sha256LongVectors) {
+    // Ці вектори проходять через ядро, вибране при завантаженні (SHA-NI або портабельне)
+    std::string twoBlocks = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    std::vector<uint8_t> twoBlockData(twoBlocks.begin(), twoBlocks.end());
+    ASSERT_EQUAL(std::string("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"),
+                 toHex(Sha256::hash(twoBlockData)));
+    
+    std::vector<uint8_t> million(1000000, 'a');
+    ASSERT_EQUAL(std::string("cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"),
+                 toHex(Sha256::hash(million)));
+}
+
 // New test to check if OpenSSL is available and working
 TEST(OpenSSLAvailability) {
 #ifdef OPENSSL_AVAILABLE
@@ -0,0 +1,319 @@
+// DictionaryTest.cpp - тести для Dictionary класу
+// Author: Андрій Будильников (Sparky)
+// Unit tests for Dictionary class
+// Модульные тесты для класса Dictionary
+
+#include "TestFramework.h"
+#include "../include/Dictionary.h"
+#include "../include/Boc.h"
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+using namespace cton;
+
+namespace {
+    CellRef makeValue(uint64_t value, size_t bits = 32) {
+        CellBuilder builder;
+        builder.storeUInt(bits, value);
+        return builder.build();
+    }
+}
+
+TEST(DictionarySingleLeafLabel) {
+    std::vector<std::pair<uint64_t, CellRef>> entries;
+    entries.push_back(std::make_pair(0x0FULL, makeValue(0xABCD, 16)));
+    Dictionary dict = Dictionary::build(8, entries);
+
+    // hml_long: 10, довжина 8 у 4 бітах, 8 бітів мітки, далі значення
+    auto root = dict.getRoot();
+    ASSERT_EQUAL(2 + 4 + 8 + 16, root->getBitSize());
+    auto data = root->getData();
+    ASSERT_EQUAL(0xA0, data[0]);
+    ASSERT_EQUAL(0x3E, data[1]);
+    ASSERT_EQUAL(0xAF, data[2]);
+    ASSERT_EQUAL(0x34, data[3]);
+}
+
+TEST(DictionaryForkAndSameLabel) {
+    std::vector<std::pair<uint64_t, CellRef>> entries;
+    entries.push_back(std::make_pair(0x00ULL, makeValue(1, 8)));
+    entries.push_back(std::make_pair(0x80ULL, makeValue(2, 8)));
+    Dictionary dict = Dictionary::build(8, entries);
+
+    // Корінь: порожня мітка hml_short (00) і два посилання
+    auto root = dict.getRoot();
+    ASSERT_EQUAL(2, root->getBitSize());
+    ASSERT_EQUAL(2, root->getRefsCount());
+
+    // Лівий лист: сім нулів як hml_same (11 0 111)
+    auto left = root->getReference(0);
+    ASSERT_EQUAL(6 + 8, left->getBitSize());
+    ASSERT_EQUAL(0xDC, left->getData()[0]);
+
+    CellSlice value;
+    ASSERT_TRUE(dict.get(0x80, value));
+    ASSERT_EQUAL(2, value.loadUInt(8));
+    ASSERT_FALSE(dict.get(0x40, value));
+}
+
+TEST(DictionaryBulkLookup) {
+    std::vector<std::pair<uint64_t, CellRef>> entries;
+    for (uint64_t i = 0; i < 2000; ++i) {
+        entries.push_back(std::make_pair(i * 7919 % 100003 + i * 100003, makeValue(i)));
+    }
+    Dictionary dict = Dictionary::build(32, entries);
+
+    for (uint64_t i = 0; i < entries.size(); ++i) {
+        CellSlice value;
+        ASSERT_TRUE(dict.get(entries[i].first, value));
+        ASSERT_EQUAL(i, value.loadUInt(32));
+    }
+    CellSlice missing;
+    ASSERT_FALSE(dict.get(1, missing));
+    ASSERT_FALSE(dict.get(0xFFFFFFFFULL, missing));
+}
+
+TEST(DictionaryRejectsUnsortedKeys) {
+    std::vector<std::pair<uint64_t, CellRef>> entries;
+    entries.push_back(std::make_pair(5ULL, makeValue(1)));
+    entries.push_back(std::make_pair(5ULL, makeValue(2)));
+    try {
+        Dictionary::build(16, entries);
+        ASSERT_TRUE(false);
+    } catch (const std::invalid_argument&) {
+        ASSERT_TRUE(true);
+    }
+
+    entries[1].first = 3;
+    try {
+        Dictionary::build(16, entries);
+        ASSERT_TRUE(false);
+    } catch (const std::invalid_argument&) {
+        ASSERT_TRUE(true);
+    }
+}
+
+TEST(DictionaryWideKeysAndBoc) {
+    // 267-бітні ключі (як адреси MsgAddressInt)
+    const size_t keyBits = 267;
+    const size_t keyBytes = (keyBits + 7) / 8;
+    std::vector<uint8_t> keys;
+    std::vector<CellRef> values;
+    for (int i = 0; i < 64; ++i) {
+        std::vector<uint8_t> key(keyBytes, 0);
+        key[0] = 0x80;
+        key[10] = static_cast<uint8_t>(i / 8);
+        key[33] = static_cast<uint8_t>((i % 8) << 5);
+        keys.insert(keys.end(), key.begin(), key.end());
+        values.push_back(makeValue(static_cast<uint64_t>(i), 16));
+    }
+    Dictionary dict = Dictionary::build(keyBits, keys.data(), values.data(), values.size());
+
+    CellBuilder holder;
+    dict.store(holder);
+    auto serialized = Boc(holder.build()).serialize();
+    auto restoredRoot = Boc::deserialize(serialized).getRoot();
+    CellSlice slice(*restoredRoot);
+    Dictionary restored = Dictionary::load(slice, keyBits);
+    ASSERT_TRUE(restored.getRoot()->hash() == dict.getRoot()->hash());
+
+    for (int i = 0; i < 64; ++i) {
+        CellSlice value;
+        ASSERT_TRUE(restored.get(keys.data() + i * keyBytes, value));
+        ASSERT_EQUAL(i, value.loadUInt(16));
+    }
+
+    CellBuilder emptyHolder;
+    Dictionary(keyBits).store(emptyHolder);
+    ASSERT_EQUAL(1, emptyHolder.build()->getBitSize());
+}
+
+TEST(DictionaryBulkBuildLarge) {
+    const size_t count = 100000;
+    std::vector<std::pair<uint64_t, CellRef>> entries;
+    entries.reserve(count);
+    CellRef value = makeValue(0xDEADBEEF);
+    for (uint64_t i = 0; i < count; ++i) {
+        entries.push_back(std::make_pair(i * 3 + 1, value));
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    Dictionary dict = Dictionary::build(64, entries);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "Built 100000-entry dictionary in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << std::endl;
+
+    CellSlice found;
+    ASSERT_TRUE(dict.get(3 * 54321 + 1, found));
+    ASSERT_FALSE(dict.get(3 * 54321, found));
+}
+
+TEST(DictionaryLazyBocLookup) {
+    std::vector<std::pair<uint64_t, CellRef>> entries;
+    for (uint64_t i = 0; i < 1000; ++i) {
+        entries.push_back(std::make_pair(i * 3 + 1, makeValue(i)));
+    }
+    Dictionary dict = Dictionary::build(32, entries);
+
+    // Словник читається прямо з BOC з індексом і без нього
+    for (int hasIdx = 0; hasIdx < 2; ++hasIdx) {
+        auto boc = std::make_shared<BocView>(Boc(dict.getRoot()).serialize(hasIdx != 0));
+        Dictionary lazy = Dictionary::fromBoc(boc, boc->getRootIndex(), 32);
+        ASSERT_FALSE(lazy.empty());
+
+        CellSlice value;
+        ASSERT_TRUE(lazy.get(3 * 777 + 1, value));
+        ASSERT_EQUAL(777, value.loadUInt(32));
+        ASSERT_FALSE(lazy.get(3 * 777, value));
+        ASSERT_FALSE(lazy.get(5000, value));
+        ASSERT_TRUE(lazy.getRoot()->hash() == dict.getRoot()->hash());
+    }
+}
+
+TEST(DictionaryLowerBound) {
+    std::vector<std::pair<uint64_t, CellRef>> entries;
+    for (uint64_t i = 0; i < 100; ++i) {
+        entries.push_back(std::make_pair(i * 10 + 5, makeValue(i)));
+    }
+    Dictionary dict = Dictionary::build(16, entries);
+    auto boc = std::make_shared<BocView>(Boc(dict.getRoot()).serialize());
+    Dictionary lazy = Dictionary::fromBoc(boc, boc->getRootIndex(), 16);
+
+    uint8_t key[8];
+    uint8_t found[2];
+    CellSlice value;
+    for (const Dictionary* d : {&dict, &lazy}) {
+        Dictionary::packKey(16, 0, key);
+        ASSERT_TRUE(d->lowerBound(key, found, value));
+        ASSERT_EQUAL(5, (found[0] << 8) | found[1]);
+
+        Dictionary::packKey(16, 421, key);
+        ASSERT_TRUE(d->lowerBound(key, found, value));
+        ASSERT_EQUAL(425, (found[0] << 8) | found[1]);
+        ASSERT_EQUAL(42, value.loadUInt(32));
+
+        Dictionary::packKey(16, 425, key);
+        ASSERT_TRUE(d->lowerBound(key, found, value));
+        ASSERT_EQUAL(425, (found[0] << 8) | found[1]);
+
+        Dictionary::packKey(16, 996, key);
+        ASSERT_FALSE(d->lowerBound(key, found, value));
+    }
+}
+
+TEST(DictionaryIteration) {
+    std::vector<std::pair<uint64_t, CellRef>> entries;
+    for (uint64_t i = 0; i < 500; ++i) {
+        entries.push_back(std::make_pair(i * i, makeValue(i)));
+    }
+    Dictionary dict = Dictionary::build(24, entries);
+    auto boc = std::make_shared<BocView>(Boc(dict.getRoot()).serialize(false));
+    Dictionary lazy = Dictionary::fromBoc(boc, boc->getRootIndex(), 24);
+
+    for (const Dictionary* d : {&dict, &lazy}) {
+        uint64_t expected = 0;
+        for (DictionaryIterator it = d->begin(); it.valid(); it.next()) {
+            ASSERT_EQUAL(expected * expected, it.keyUInt());
+            CellSlice value = it.value();
+            ASSERT_EQUAL(expected, value.loadUInt(32));
+            ++expected;
+        }
+        ASSERT_EQUAL(500, expected);
+
+        for (DictionaryIterator it = d->begin(true); it.valid(); it.next()) {
+            --expected;
+            ASSERT_EQUAL(expected * expected, it.keyUInt());
+        }
+        ASSERT_EQUAL(0, expected);
+
+        // Від 1000 вгору: 32^2, 33^2, ...; від 1000 вниз: 31^2, 30^2, ...
+        uint8_t key[8];
+        Dictionary::packKey(24, 1000, key);
+        DictionaryIterator up = d->seek(key);
+        ASSERT_EQUAL(1024, up.keyUInt());
+        up.next();
+        ASSERT_EQUAL(1089, up.keyUInt());
+
+        DictionaryIterator down = d->seek(key, true);
+        ASSERT_EQUAL(961, down.keyUInt());
+        down.next();
+        ASSERT_EQUAL(900, down.keyUInt());
+
+        Dictionary::packKey(24, 499 * 499 + 1, key);
+        ASSERT_FALSE(d->seek(key).valid());
+        ASSERT_EQUAL(499 * 499, d->seek(key, true).keyUInt());
+    }
+
+    ASSERT_FALSE(Dictionary(24).begin().valid());
+}
+
+TEST(DictionarySetEraseMatchesBuild) {
+    // Вставка в перемішаному порядку дає той самий корінь, що й побудова з відсортованих ключів
+    std::vector<std::pair<uint64_t, CellRef>> entries;
+    Dictionary dict(20);
+    for (uint64_t i = 0; i < 300; ++i) {
+        uint64_t key = (i * 7919) % 1000003 % (1 << 20);
+        dict.set(key, makeValue(i));
+    }
+    for (uint64_t i = 0; i < 300; ++i) {
+        entries.push_back(std::make_pair((i * 7919) % 1000003 % (1 << 20), makeValue(i)));
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const std::pair<uint64_t, CellRef>& a, const std::pair<uint64_t, CellRef>& b) {
+                  return a.first < b.first;
+              });
+    ASSERT_TRUE(dict.getRoot()->hash() == Dictionary::build(20, entries).getRoot()->hash());
+
+    // Видалення кожного другого ключа
+    std::vector<std::pair<uint64_t, CellRef>> kept;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (i % 2 == 0) {
+            ASSERT_TRUE(dict.erase(entries[i].first));
+        } else {
+            kept.push_back(entries[i]);
+        }
+    }
+    ASSERT_FALSE(dict.erase(entries[0].first));
+    ASSERT_TRUE(dict.getRoot()->hash() == Dictionary::build(20, kept).getRoot()->hash());
+
+    for (const auto& entry : kept) {
+        ASSERT_TRUE(dict.erase(entry.first));
+    }
+    ASSERT_TRUE(dict.empty());
+}
+
+TEST(DictionarySetSharesUntouchedSubtrees) {
+    std::vector<std::pair<uint64_t, CellRef>> entries;
+    for (uint64_t i = 0; i < 64; ++i) {
+        entries.push_back(std::make_pair(i, makeValue(i)));
+    }
+    Dictionary original = Dictionary::build(8, entries);
+    Dictionary updated = original;
+    updated.set(3, makeValue(1000));
+
+    // Змінено лише шлях до ключа 3: права половина спільна
+    ASSERT_TRUE(updated.getRoot().get() != original.getRoot().get());
+    ASSERT_TRUE(updated.getRoot()->getReference(1).get() == original.getRoot()->getReference(1).get());
+
+    CellSlice value;
+    ASSERT_TRUE(original.get(3, value));
+    ASSERT_EQUAL(3, value.loadUInt(32));
+    ASSERT_TRUE(updated.get(3, value));
+    ASSERT_EQUAL(1000, value.loadUInt(32));
+
+    // Зміна словника над BOC
+    auto boc = std::make_shared<BocView>(Boc(original.getRoot()).serialize());
+    Dictionary lazy = Dictionary::fromBoc(boc, boc->getRootIndex(), 8);
+    lazy.set(200, makeValue(7));
+    ASSERT_TRUE(lazy.erase(5));
+    ASSERT_TRUE(lazy.get(200, value));
+    ASSERT_EQUAL(7, value.loadUInt(32));
+    ASSERT_FALSE(lazy.get(5, value));
+}
+
+int main() {
+    return RUN_ALL_TESTS();
+}
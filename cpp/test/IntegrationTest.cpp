@@ -63,7 +63,7 @@ void testCellAndBocOperations() {
     // Test 2: Serialize to BOC
     // Тест 2: Сериализация в BOC
     std::cout << "2. Serializing to BOC..." << std::endl;
-    auto root = std::make_shared<Cell>(*cell);
+    auto root = Cell::create(*cell);
     Boc boc(root);
     auto serialized = boc.serialize(false, false); // Без індексу і без CRC для простоти
     std::cout << "   BOC serialized, size: " << serialized.size() << " bytes" << std::endl;
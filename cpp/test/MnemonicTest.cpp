@@ -59,6 +59,20 @@ int main() {
         assert(valid18);
         std::cout << "   All mnemonics are valid" << std::endl;
         
+        // Тест 5a: Тестові вектори BIP-39 з неповним байтом контрольної суми
+        // Test 5a: BIP-39 test vectors with a partial checksum byte
+        // Тест 5a: Тестовые векторы BIP-39 с неполным байтом контрольной суммы
+        std::cout << "5a. Validating BIP-39 test vectors..." << std::endl;
+        std::vector<std::string> zero12(11, "abandon");
+        zero12.push_back("about");
+        assert(Mnemonic::isValid(zero12));
+        std::vector<std::string> zero24(23, "abandon");
+        zero24.push_back("art");
+        assert(Mnemonic::isValid(zero24));
+        std::vector<std::string> badChecksum(12, "abandon");
+        assert(!Mnemonic::isValid(badChecksum));
+        std::cout << "   Test vectors validated" << std::endl;
+        
         // Тест 6: Отримання wordlist
         // Test 6: Get wordlist
         // Тест 6: Получение wordlist
@@ -6,6 +6,7 @@
 #include "TestFramework.h"
 #include "../include/NativeInterface.h"
 #include <cstring>
+#include <vector>
 
 TEST(NativeCellCreation) {
     void* cell = cell_create();
@@ -60,6 +61,65 @@ TEST(NativeCellGetData) {
     cell_destroy(cell);
 }
 
+TEST(NativeCellStoreAppends) {
+    void* cell = cell_create();
+    ASSERT_TRUE(cell != nullptr);
+    
+    // Кожен виклик дописує дані, а не перезаписує їх
+    ASSERT_TRUE(cell_store_uint(cell, 4, 0xA));
+    ASSERT_TRUE(cell_store_int(cell, 8, -1));
+    uint8_t bytes[] = {0x12, 0x34};
+    ASSERT_TRUE(cell_store_bytes(cell, bytes, 2));
+    ASSERT_EQUAL(28, cell_get_bit_size(cell));
+    
+    uint8_t buffer[8];
+    int size = cell_get_data(cell, buffer, 8);
+    ASSERT_EQUAL(4, size);
+    ASSERT_EQUAL(0xAF, buffer[0]);
+    ASSERT_EQUAL(0xF1, buffer[1]);
+    ASSERT_EQUAL(0x23, buffer[2]);
+    ASSERT_EQUAL(0x40, buffer[3]);
+    
+    cell_destroy(cell);
+}
+
+TEST(NativeCellStoreCoins) {
+    void* cell = cell_create();
+    
+    // Знаковий нульовий байт BigInteger.toByteArray() ігнорується
+    uint8_t amount[] = {0x00, 0xFF, 0x01};
+    ASSERT_TRUE(cell_store_coins(cell, amount, 3));
+    ASSERT_TRUE(cell_store_coins(cell, nullptr, 0));
+    ASSERT_EQUAL(4 + 16 + 4, cell_get_bit_size(cell));
+    
+    uint8_t buffer[4];
+    ASSERT_EQUAL(3, cell_get_data(cell, buffer, 4));
+    ASSERT_EQUAL(0x2F, buffer[0]);
+    ASSERT_EQUAL(0xF0, buffer[1]);
+    ASSERT_EQUAL(0x10, buffer[2]);
+    
+    uint8_t tooWide[16];
+    std::memset(tooWide, 0xFF, sizeof(tooWide));
+    ASSERT_FALSE(cell_store_coins(cell, tooWide, 16));
+    
+    cell_destroy(cell);
+}
+
+TEST(NativeCellRefOwnership) {
+    void* parent = cell_create();
+    void* child = cell_create();
+    ASSERT_TRUE(cell_store_uint(child, 8, 0x42));
+    ASSERT_TRUE(cell_store_ref(parent, child));
+    
+    // Кожен дескриптор володіє власним посиланням, тому порядок знищення не важливий
+    cell_destroy(child);
+    void* ref = cell_get_ref(parent, 0);
+    ASSERT_TRUE(ref != nullptr);
+    cell_destroy(parent);
+    ASSERT_EQUAL(8, cell_get_bit_size(ref));
+    cell_destroy(ref);
+}
+
 TEST(NativeCellGetBitSize) {
     void* cell = cell_create();
     ASSERT_TRUE(cell != nullptr);
@@ -78,6 +138,40 @@ TEST(NativeCellGetBitSize) {
     cell_destroy(cell);
 }
 
+TEST(NativeCellSnakeBytes) {
+    void* cell = cell_create();
+    ASSERT_TRUE(cell != nullptr);
+    
+    // Коментар переказу: op = 0, далі текст, довший за одну комірку
+    std::vector<uint8_t> text(400);
+    for (size_t i = 0; i < text.size(); ++i) {
+        text[i] = static_cast<uint8_t>('a' + i % 26);
+    }
+    ASSERT_TRUE(cell_store_uint(cell, 32, 0));
+    ASSERT_TRUE(cell_store_snake_bytes(cell, text.data(), static_cast<int>(text.size())));
+    ASSERT_EQUAL(1016, cell_get_bit_size(cell));
+    ASSERT_EQUAL(1, cell_get_refs_count(cell));
+    
+    // Довжина запитується без буфера; op (4 байти) - частина даних snake
+    int length = cell_load_snake_bytes(cell, nullptr, 0);
+    ASSERT_EQUAL(404, length);
+    std::vector<uint8_t> loaded(static_cast<size_t>(length));
+    ASSERT_EQUAL(404, cell_load_snake_bytes(cell, loaded.data(), length));
+    ASSERT_TRUE(std::memcmp(loaded.data() + 4, text.data(), text.size()) == 0);
+    
+    // Комірка з посиланням: хвіст не став би першим посиланням
+    void* withRef = cell_create();
+    void* child = cell_create();
+    ASSERT_TRUE(cell_store_ref(withRef, child));
+    ASSERT_FALSE(cell_store_snake_bytes(withRef, text.data(), static_cast<int>(text.size())));
+    ASSERT_EQUAL(0, cell_get_bit_size(withRef));
+    ASSERT_EQUAL(1, cell_get_refs_count(withRef));
+    
+    cell_destroy(child);
+    cell_destroy(withRef);
+    cell_destroy(cell);
+}
+
 TEST(NativeAddressCreation) {
     void* address = address_create();
     ASSERT_TRUE(address != nullptr);
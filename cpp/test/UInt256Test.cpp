@@ -0,0 +1,144 @@
+// UInt256Test.cpp - тести для UInt256 класу
+// Author: Андрій Будильников (Sparky)
+// Unit tests for UInt256 class
+// Модульные тесты для класса UInt256
+
+#include "TestFramework.h"
+#include "../include/UInt256.h"
+#include "../include/Cell.h"
+#include "../include/CellSlice.h"
+#include <vector>
+
+using namespace cton;
+
+TEST(UInt256Bytes) {
+    std::vector<uint8_t> bytes;
+    for (int i = 0; i < 32; ++i) {
+        bytes.push_back(static_cast<uint8_t>(i + 1));
+    }
+    UInt256 value = UInt256::fromBytes(bytes.data(), bytes.size());
+    ASSERT_EQUAL(0x0102030405060708ULL, value.word(0));
+    ASSERT_EQUAL(0x191A1B1C1D1E1F20ULL, value.word(3));
+    ASSERT_EQUAL(249, value.bitLength());
+
+    uint8_t out[32];
+    value.toBytes(out);
+    ASSERT_TRUE(std::vector<uint8_t>(out, out + 32) == bytes);
+
+    UInt256 small = UInt256::fromBytes(bytes.data(), 3);
+    ASSERT_EQUAL(0x010203, small.toUInt64());
+    ASSERT_EQUAL(3, small.byteLength());
+}
+
+TEST(UInt256Decimal) {
+    // 2^64 і максимальне значення
+    UInt256 value = UInt256::fromString("18446744073709551616");
+    ASSERT_EQUAL(1, value.word(2));
+    ASSERT_EQUAL(0, value.word(3));
+    ASSERT_EQUAL(std::string("18446744073709551616"), value.toString());
+
+    UInt256 max(~0ULL, ~0ULL, ~0ULL, ~0ULL);
+    std::string maxString = "115792089237316195423570985008687907853269984665640564039457584007913129639935";
+    ASSERT_EQUAL(maxString, max.toString());
+    ASSERT_TRUE(UInt256::fromString(maxString) == max);
+    ASSERT_EQUAL(std::string("0"), UInt256().toString());
+
+    try {
+        UInt256::fromString("115792089237316195423570985008687907853269984665640564039457584007913129639936");
+        ASSERT_TRUE(false);
+    } catch (const std::overflow_error&) {
+        ASSERT_TRUE(true);
+    }
+}
+
+TEST(UInt256Arithmetic) {
+    UInt256 a(0, 0, 1, ~0ULL);
+    UInt256 b = a + UInt256(1);
+    ASSERT_TRUE(b == UInt256(0, 0, 2, 0));
+    ASSERT_TRUE(b - UInt256(1) == a);
+    ASSERT_TRUE(a < b);
+    ASSERT_TRUE(b > a);
+
+    try {
+        UInt256(~0ULL, ~0ULL, ~0ULL, ~0ULL) + UInt256(1);
+        ASSERT_TRUE(false);
+    } catch (const std::overflow_error&) {
+        ASSERT_TRUE(true);
+    }
+
+    try {
+        a - b;
+        ASSERT_TRUE(false);
+    } catch (const std::overflow_error&) {
+        ASSERT_TRUE(true);
+    }
+}
+
+TEST(StoreCoinsEncoding) {
+    // 1 TON = 10^9 нанотонів = 0x3B9ACA00 - чотири байти
+    CellBuilder builder;
+    builder.storeCoins(1000000000ULL);
+    auto cell = builder.build();
+    ASSERT_EQUAL(4 + 32, cell->getBitSize());
+    auto data = cell->getData();
+    ASSERT_EQUAL(0x43, data[0]);
+    ASSERT_EQUAL(0xB9, data[1]);
+    ASSERT_EQUAL(0xAC, data[2]);
+    ASSERT_EQUAL(0xA0, data[3]);
+    ASSERT_EQUAL(0x00, data[4]);
+
+    CellBuilder zeroBuilder;
+    zeroBuilder.storeCoins(0);
+    ASSERT_EQUAL(4, zeroBuilder.build()->getBitSize());
+
+    // Понад 15 байтів не вміщується у VarUInteger 16
+    try {
+        CellBuilder overflow;
+        overflow.storeCoins(UInt256(0, 1ULL << 56, 0, 0));
+        ASSERT_TRUE(false);
+    } catch (const std::invalid_argument&) {
+        ASSERT_TRUE(true);
+    }
+}
+
+TEST(UInt256CellRoundTrip) {
+    UInt256 wide = UInt256::fromString("340282366920938463463374607431768211455123");
+    UInt256 hash(0x0123456789ABCDEFULL, 0xFEDCBA9876543210ULL, 0x1111111111111111ULL, 0x2222222222222222ULL);
+
+    CellBuilder builder;
+    builder.storeUInt(3, 0x5);
+    builder.storeCoins(12345);
+    builder.storeUInt256(256, hash);
+    builder.storeUInt256(140, wide);
+    builder.storeVarUInt(32, wide);
+    auto cell = builder.build();
+
+    CellSlice slice(*cell);
+    ASSERT_EQUAL(0x5, slice.loadUInt(3));
+    ASSERT_TRUE(slice.loadCoins() == UInt256(12345));
+    ASSERT_TRUE(slice.loadUInt256(256) == hash);
+    ASSERT_TRUE(slice.loadUInt256(140) == wide);
+    ASSERT_TRUE(slice.loadVarUInt(32) == wide);
+    ASSERT_EQUAL(0, slice.remainingBits());
+
+    // Ті самі біти через запис у комірку напряму
+    auto direct = Cell::create();
+    direct->storeUInt(3, 0x5);
+    direct->storeCoins(12345);
+    direct->storeUInt256(256, hash);
+    direct->storeUInt256(140, wide);
+    direct->storeVarUInt(32, wide);
+    ASSERT_TRUE(direct->hash() == cell->hash());
+
+    try {
+        CellBuilder narrow;
+        narrow.storeUInt256(100, wide);
+        ASSERT_TRUE(false);
+    } catch (const std::invalid_argument&) {
+        ASSERT_TRUE(true);
+    }
+}
+
+int main() {
+    return RUN_ALL_TESTS();
+}
@@ -4,6 +4,8 @@
 package com.cton.sdk;
 
 import java.io.Closeable;
+import java.math.BigInteger;
+import java.nio.charset.StandardCharsets;
 
 import com.sun.jna.Library;
 import com.sun.jna.Native;
@@ -36,6 +38,9 @@ public class Cell implements Closeable {
         // Додавання байтів до комірки
         boolean cell_store_bytes(Pointer cell, byte[] data, int length);
         
+        // Додавання суми монет (big-endian) до комірки
+        boolean cell_store_coins(Pointer cell, byte[] amount, int length);
+        
         // Додавання референсу до комірки
         boolean cell_store_ref(Pointer cell, Pointer refCell);
         
@@ -50,6 +55,12 @@ public class Cell implements Closeable {
         
         // Отримання референсу за індексом
         Pointer cell_get_ref(Pointer cell, int index);
+        
+        // Додавання байтів у форматі snake (хвіст - ланцюжок комірок)
+        boolean cell_store_snake_bytes(Pointer cell, byte[] data, int length);
+        
+        // Читання даних snake; повертає довжину, копіює лише у достатній буфер
+        int cell_load_snake_bytes(Pointer cell, byte[] buffer, int bufferSize);
     }
     
     // Зробимо поле доступним для інших класів в тому самому пакеті
@@ -121,6 +132,79 @@ public class Cell implements Closeable {
         return this;
     }
     
+    /**
+     * Додати байти у форматі snake
+     * 
+     * Байти заповнюють вільне місце комірки, решта зберігається ланцюжком
+     * комірок через перший референс (комірка не повинна мати інших референсів)
+     * @param data дані для зберігання
+     * @return this для ланцюгових викликів
+     */
+    public Cell storeSnakeBytes(byte[] data) {
+        if (closed) {
+            throw new IllegalStateException("Cell has been closed");
+        }
+        if (!CtonLibrary.INSTANCE.cell_store_snake_bytes(nativeCell, data, data.length)) {
+            throw new RuntimeException("Failed to store snake bytes in cell");
+        }
+        return this;
+    }
+    
+    /**
+     * Додати рядок (UTF-8) у форматі snake, наприклад текст коментаря
+     * @param text рядок
+     * @return this для ланцюгових викликів
+     */
+    public Cell storeSnakeString(String text) {
+        return storeSnakeBytes(text.getBytes(StandardCharsets.UTF_8));
+    }
+    
+    /**
+     * Прочитати дані snake: дані комірки і ланцюжок за першим референсом
+     * @return масив байтів
+     */
+    public byte[] loadSnakeBytes() {
+        if (closed) {
+            throw new IllegalStateException("Cell has been closed");
+        }
+        int length = CtonLibrary.INSTANCE.cell_load_snake_bytes(nativeCell, null, 0);
+        if (length < 0) {
+            throw new RuntimeException("Failed to read snake data from cell");
+        }
+        byte[] buffer = new byte[length];
+        if (length > 0 && CtonLibrary.INSTANCE.cell_load_snake_bytes(nativeCell, buffer, length) != length) {
+            throw new RuntimeException("Failed to read snake data from cell");
+        }
+        return buffer;
+    }
+    
+    /**
+     * Прочитати рядок (UTF-8) у форматі snake
+     * @return рядок
+     */
+    public String loadSnakeString() {
+        return new String(loadSnakeBytes(), StandardCharsets.UTF_8);
+    }
+    
+    /**
+     * Додати суму монет (Coins = VarUInteger 16) до комірки
+     * @param amount сума в нанотонах (невід'ємна, не більше 120 бітів)
+     * @return this для ланцюгових викликів
+     */
+    public Cell storeCoins(BigInteger amount) {
+        if (closed) {
+            throw new IllegalStateException("Cell has been closed");
+        }
+        if (amount == null || amount.signum() < 0) {
+            throw new IllegalArgumentException("Coins amount must be non-negative");
+        }
+        byte[] bytes = amount.toByteArray();
+        if (!CtonLibrary.INSTANCE.cell_store_coins(nativeCell, bytes, bytes.length)) {
+            throw new RuntimeException("Failed to store coins in cell");
+        }
+        return this;
+    }
+    
     /**
      * Додати референс на іншу комірку
      * @param cell комірка для додавання як референс
@@ -109,54 +109,10 @@ public class CellBuilder {
      * @return this для ланцюгових викликів
      */
     public CellBuilder storeCoins(BigInteger amount) {
-        // Реалізація серіалізації монет в комірку
-        // Implementation of coin serialization to cell
-        // Реализация сериализации монет в ячейку
-        
-        if (amount == null || amount.compareTo(BigInteger.ZERO) < 0) {
-            // Зберігаємо нуль
-            // Store zero
-            // Сохраняем ноль
-            cell.storeUInt(4, 0);
-            return this;
-        }
-        
-        // Визначаємо кількість байтів для зберігання
-        // Determine number of bytes to store
-        // Определяем количество байтов для хранения
-        int bitLength = amount.bitLength();
-        int bytesNeeded = (bitLength + 7) / 8;
-        
-        if (bytesNeeded == 0) {
-            // Нульове значення
-            // Zero value
-            // Нулевое значение
-            cell.storeUInt(4, 0);
-            return this;
-        }
-        
-        // Обчислюємо кількість байтів для кодування
-        // Calculate number of bytes for encoding
-        // Вычисляем количество байтов для кодирования
-        int encodingBytes = Math.min(bytesNeeded, 127); // Максимум 127 байтів
-        
-        // Зберігаємо довжину (кількість байтів)
-        // Store length (number of bytes)
-        // Сохраняем длину (количество байтов)
-        cell.storeUInt(4, encodingBytes * 2 + 1); // Непарне число для позначення наявності байтів
-        
-        // Конвертуємо в байти у форматі big-endian
-        // Convert to bytes in big-endian format
-        // Конвертируем в байты в формате big-endian
-        byte[] amountBytes = amount.toByteArray();
-        
-        // Зберігаємо байти
-        // Store bytes
-        // Сохраняем байты
-        for (int i = amountBytes.length - 1; i >= 0; i--) {
-            cell.storeUInt(8, amountBytes[i] & 0xFF);
-        }
-        
+        // Кодування VarUInteger 16 виконується в нативній бібліотеці одним викликом
+        // VarUInteger 16 encoding is done by the native library in a single call
+        // Кодирование VarUInteger 16 выполняется в нативной библиотеке одним вызовом
+        cell.storeCoins(amount == null ? BigInteger.ZERO : amount);
         return this;
     }
     